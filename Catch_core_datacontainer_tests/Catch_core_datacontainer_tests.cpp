@@ -938,6 +938,40 @@ TEST_CASE("objects and relationships with expandable storage", "[core_datacontai
 	}
 }
 
+TEST_CASE("live slots with expandable storage", "[core_datacontainer_tests]") {
+	auto ptr = std::make_unique< ex1::data_container >();
+
+	std::vector<ex1::top_id> tops;
+	std::vector<ex1::bottom_id> bottoms;
+	for(int32_t i = 0; i < 20; ++i)
+		tops.push_back(ptr->create_top());
+	for(int32_t i = 0; i < 5; ++i)
+		bottoms.push_back(ptr->create_bottom());
+
+	// the live set grows with the relationship, past the first few bytes
+	std::vector<ex1::lr_relation_id> rels;
+	for(auto t : tops) {
+		for(auto b : bottoms)
+			rels.push_back(ptr->try_create_lr_relation(t, b));
+	}
+	REQUIRE(ptr->lr_relation_live_count() == 100);
+
+	for(size_t i = 0; i < rels.size(); i += 3)
+		ptr->delete_lr_relation(rels[i]);
+	REQUIRE(ptr->lr_relation_live_count() == 66);
+
+	uint32_t visited = 0;
+	ptr->for_each_lr_relation([&](ex1::lr_relation_id id) {
+		REQUIRE(ptr->lr_relation_is_valid(id));
+		++visited;
+	});
+	REQUIRE(visited == 66);
+
+	// freed slots are live again once reused
+	ptr->try_create_lr_relation(tops[0], bottoms[0]);
+	REQUIRE(ptr->lr_relation_live_count() == 67);
+}
+
 TEST_CASE("setting from relationship", "[core_datacontainer_tests]") {
 	auto ptr = std::make_unique< car_owner_basic::data_container >();
 
@@ -2247,6 +2247,118 @@ namespace car_owner_basic {
 			return new_id;
 		}
 		
+		//
+		// container batch create for car
+		//
+		car_id create_car_batch(uint32_t count) {
+			if(count == 0) return car_id();
+			const uint32_t first = car.size_used;
+			car_resize(first + count);
+			return car_id(car_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for car
+		//
+		void internal_move_car(car_id last_id, car_id id_removed) {
+			internal_move_relationship_car_ownership(car_ownership_id(car_ownership_id::value_base_t(last_id.index())), car_ownership_id(car_ownership_id::value_base_t(id_removed.index())));
+			if(auto bk = uniq_car_ownership.m_link_back_owned_car.vptr()[last_id.index()]; bool(bk)) {
+				uniq_car_ownership.m_owned_car.vptr()[bk.index()] = id_removed;
+			}
+			uniq_car_ownership.m_link_back_owned_car.vptr()[id_removed.index()] = std::move(uniq_car_ownership.m_link_back_owned_car.vptr()[last_id.index()]);
+			uniq_car_ownership.m_link_back_owned_car.vptr()[last_id.index()] = uniq_car_ownership_id();
+			car.m_wheels.vptr()[id_removed.index()] = std::move(car.m_wheels.vptr()[last_id.index()]);
+			car.m_wheels.vptr()[last_id.index()] = int32_t{};
+			car.m_resale_value.vptr()[id_removed.index()] = std::move(car.m_resale_value.vptr()[last_id.index()]);
+			car.m_resale_value.vptr()[last_id.index()] = float{};
+		}
+		
+		public:
+		//
+		// container reorder for car
+		//
+		void reorder_car(car_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = car.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<car_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = car_id(car_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == car_id(car_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = car_id(car_id::value_base_t(count));
+			#ifndef DCON_USE_EXCEPTIONS
+			if(car.size_used >= 1200) std::abort();
+			#else
+			if(car.size_used >= 1200) throw dcon::out_of_space{};
+			#endif
+			++car.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = car_id(car_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_car(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_car(scratch, dest);
+						break;
+					}
+					internal_move_car(src, dest);
+					dest = src;
+				}
+			}
+			--car.size_used;
+		}
+		template<typename F>
+		std::vector<car_id> car_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(car_id()))>;
+			std::vector<key_type> keys;
+			std::vector<car_id> result;
+			keys.reserve(car.size_used);
+			result.reserve(car.size_used);
+			for(uint32_t i = 0; i < car.size_used; ++i) {
+				auto id = car_id(car_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](car_id a, car_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<car_id> car_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = car.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = car_id(car_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return car_order_by([&](car_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container pop_back for person
 		//
@@ -2292,6 +2404,116 @@ namespace car_owner_basic {
 			return new_id;
 		}
 		
+		//
+		// container batch create for person
+		//
+		person_id create_person_batch(uint32_t count) {
+			if(count == 0) return person_id();
+			const uint32_t first = person.size_used;
+			person_resize(first + count);
+			return person_id(person_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for person
+		//
+		void internal_move_person(person_id last_id, person_id id_removed) {
+			person_for_each_car_ownership_as_owner(last_id, [this, id_removed, last_id](car_ownership_id i) {
+				car_ownership.m_owner.vptr()[i.index()] = id_removed;
+			} );
+			car_ownership.m_array_owner.vptr()[id_removed.index()] = std::move(car_ownership.m_array_owner.vptr()[last_id.index()]);
+			car_ownership.m_array_owner.vptr()[last_id.index()] = std::vector<car_ownership_id>{};
+			internal_move_relationship_uniq_car_ownership(uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(last_id.index())), uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(id_removed.index())));
+			person.m_age.vptr()[id_removed.index()] = std::move(person.m_age.vptr()[last_id.index()]);
+			person.m_age.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container reorder for person
+		//
+		void reorder_person(person_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = person.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<person_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = person_id(person_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == person_id(person_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = person_id(person_id::value_base_t(count));
+			#ifndef DCON_USE_EXCEPTIONS
+			if(person.size_used >= 100) std::abort();
+			#else
+			if(person.size_used >= 100) throw dcon::out_of_space{};
+			#endif
+			++person.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = person_id(person_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_person(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_person(scratch, dest);
+						break;
+					}
+					internal_move_person(src, dest);
+					dest = src;
+				}
+			}
+			--person.size_used;
+		}
+		template<typename F>
+		std::vector<person_id> person_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(person_id()))>;
+			std::vector<key_type> keys;
+			std::vector<person_id> result;
+			keys.reserve(person.size_used);
+			result.reserve(person.size_used);
+			for(uint32_t i = 0; i < person.size_used; ++i) {
+				auto id = person_id(person_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](person_id a, person_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<person_id> person_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = person.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = person_id(person_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return person_order_by([&](person_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container resize for car_ownership
 		//
@@ -2373,6 +2595,65 @@ namespace car_owner_basic {
 			return new_id;
 		}
 		
+		//
+		// container bulk create relationship for car_ownership
+		//
+		struct car_ownership_link_tuple {
+			person_id owner;
+			car_id owned_car;
+		};
+		uint32_t bulk_create_car_ownership(car_ownership_link_tuple const* links, uint32_t link_count, car_ownership_id* ids_out = nullptr) {
+			std::vector<uint32_t> accepted;
+			accepted.reserve(link_count);
+			std::vector<dcon::bitfield_type> claimed_owned_car((car_size() + 7) / 8);
+			for(uint32_t i = 0; i < link_count; ++i) {
+				if(ids_out) ids_out[i] = car_ownership_id();
+				auto owner_p = links[i].owner;
+				if(!bool(owner_p)) continue;
+				auto owned_car_p = links[i].owned_car;
+				if(!bool(owned_car_p)) continue;
+				if(car_ownership_is_valid(car_ownership_id(car_ownership_id::value_base_t(owned_car_p.index()))) || (uint32_t(owned_car_p.index()) < claimed_owned_car.size() * 8 && dcon::bit_vector_test(claimed_owned_car.data(), owned_car_p.index()))) continue;
+				if(bool(owned_car_p)) {
+					if(uint32_t(owned_car_p.index()) >= claimed_owned_car.size() * 8) claimed_owned_car.resize(owned_car_p.index() / 8 + 1);
+					dcon::bit_vector_set(claimed_owned_car.data(), owned_car_p.index(), true);
+				}
+				accepted.push_back(i);
+			}
+			const uint32_t count = uint32_t(accepted.size());
+			if(count == 0) return 0;
+			std::vector<car_ownership_id> new_ids(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto owned_car_p = links[accepted[k]].owned_car;
+				new_ids[k] = car_ownership_id(car_ownership_id::value_base_t(owned_car_p.index()));
+				if(car.size_used < uint32_t(owned_car_p.value)) car_resize(uint32_t(owned_car_p.value));
+			}
+			for(uint32_t k = 0; k < count; ++k) {
+				auto const& e = links[accepted[k]];
+				auto new_id = new_ids[k];
+				car_ownership.m_owner.vptr()[new_id.index()] = e.owner;
+			}
+			 {
+				std::vector<std::pair<person_id, car_ownership_id>> pending;
+				pending.reserve(size_t(count) * 1);
+				for(uint32_t k = 0; k < count; ++k) {
+					if(auto v = car_ownership.m_owner.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);
+				}
+				std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });
+				for(size_t j = 0; j < pending.size(); ) {
+					auto target = pending[j].first;
+					size_t run_end = j + 1;
+					while(run_end < pending.size() && pending[run_end].first == target) ++run_end;
+					auto& vref = car_ownership.m_array_owner.vptr()[target.index()];
+					vref.reserve(vref.size() + (run_end - j));
+					for(; j < run_end; ++j) vref.push_back(pending[j].second);
+				}
+			}
+			if(ids_out) {
+				for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];
+			}
+			return count;
+		}
+		
 		//
 		// container resize for uniq_car_ownership
 		//
@@ -2452,6 +2733,59 @@ namespace car_owner_basic {
 			return new_id;
 		}
 		
+		//
+		// container bulk create relationship for uniq_car_ownership
+		//
+		struct uniq_car_ownership_link_tuple {
+			person_id owner;
+			car_id owned_car;
+		};
+		uint32_t bulk_create_uniq_car_ownership(uniq_car_ownership_link_tuple const* links, uint32_t link_count, uniq_car_ownership_id* ids_out = nullptr) {
+			std::vector<uint32_t> accepted;
+			accepted.reserve(link_count);
+			std::vector<dcon::bitfield_type> claimed_owner((person_size() + 7) / 8);
+			std::vector<dcon::bitfield_type> claimed_owned_car((car_size() + 7) / 8);
+			for(uint32_t i = 0; i < link_count; ++i) {
+				if(ids_out) ids_out[i] = uniq_car_ownership_id();
+				auto owner_p = links[i].owner;
+				if(!bool(owner_p)) continue;
+				if(uniq_car_ownership_is_valid(uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(owner_p.index()))) || (uint32_t(owner_p.index()) < claimed_owner.size() * 8 && dcon::bit_vector_test(claimed_owner.data(), owner_p.index()))) continue;
+				auto owned_car_p = links[i].owned_car;
+				if(!bool(owned_car_p)) continue;
+				if(bool(owned_car_p) && (bool(uniq_car_ownership.m_link_back_owned_car.vptr()[owned_car_p.index()]) || (uint32_t(owned_car_p.index()) < claimed_owned_car.size() * 8 && dcon::bit_vector_test(claimed_owned_car.data(), owned_car_p.index())))) continue;
+				if(bool(owner_p)) {
+					if(uint32_t(owner_p.index()) >= claimed_owner.size() * 8) claimed_owner.resize(owner_p.index() / 8 + 1);
+					dcon::bit_vector_set(claimed_owner.data(), owner_p.index(), true);
+				}
+				if(bool(owned_car_p)) {
+					if(uint32_t(owned_car_p.index()) >= claimed_owned_car.size() * 8) claimed_owned_car.resize(owned_car_p.index() / 8 + 1);
+					dcon::bit_vector_set(claimed_owned_car.data(), owned_car_p.index(), true);
+				}
+				accepted.push_back(i);
+			}
+			const uint32_t count = uint32_t(accepted.size());
+			if(count == 0) return 0;
+			std::vector<uniq_car_ownership_id> new_ids(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto owner_p = links[accepted[k]].owner;
+				new_ids[k] = uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(owner_p.index()));
+				if(person.size_used < uint32_t(owner_p.value)) person_resize(uint32_t(owner_p.value));
+			}
+			for(uint32_t k = 0; k < count; ++k) {
+				auto const& e = links[accepted[k]];
+				auto new_id = new_ids[k];
+				uniq_car_ownership.m_owned_car.vptr()[new_id.index()] = e.owned_car;
+				if(bool(e.owned_car)) uniq_car_ownership.m_link_back_owned_car.vptr()[e.owned_car.index()] = new_id;
+			}
+			if(ids_out) {
+				for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];
+			}
+			return count;
+		}
+		
+		void commit_deletes() {
+		}
+
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_car(T&& func) {
 			for(uint32_t i = 0; i < car.size_used; ++i) {
@@ -2459,6 +2793,31 @@ namespace car_owner_basic {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_car(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(car.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, car_id, int32_t>)
+						func(car_id(car_id::value_base_t(i)), thread);
+					else
+						func(car_id(car_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_car(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<car_id>(car.size_used, identity, [&](car_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_car;
 		friend internal::object_iterator_car;
 		struct {
@@ -2483,6 +2842,31 @@ namespace car_owner_basic {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_person(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(person.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, person_id, int32_t>)
+						func(person_id(person_id::value_base_t(i)), thread);
+					else
+						func(person_id(person_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_person(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<person_id>(person.size_used, identity, [&](person_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_person;
 		friend internal::object_iterator_person;
 		struct {
@@ -2507,6 +2891,31 @@ namespace car_owner_basic {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_car_ownership(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(car.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, car_ownership_id, int32_t>)
+						func(car_ownership_id(car_ownership_id::value_base_t(i)), thread);
+					else
+						func(car_ownership_id(car_ownership_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_car_ownership(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<car_ownership_id>(car.size_used, identity, [&](car_ownership_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_car_ownership;
 		friend internal::object_iterator_car_ownership;
 		struct {
@@ -2531,6 +2940,31 @@ namespace car_owner_basic {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_uniq_car_ownership(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(person.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, uniq_car_ownership_id, int32_t>)
+						func(uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(i)), thread);
+					else
+						func(uniq_car_ownership_id(uniq_car_ownership_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_uniq_car_ownership(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<uniq_car_ownership_id>(person.size_used, identity, [&](uniq_car_ownership_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_uniq_car_ownership;
 		friend internal::object_iterator_uniq_car_ownership;
 		struct {
@@ -2548,6 +2982,28 @@ namespace car_owner_basic {
 			}
 		}  in_uniq_car_ownership ;
 		
+		//
+		// container link statistics for car_ownership owner
+		//
+		dcon::link_statistics<person_id> car_ownership_link_stats_owner() const {
+			return car_ownership_link_stats_owner(std::numeric_limits<uint32_t>::max(), [](person_id, uint32_t) {});
+		}
+		template<typename F>
+		dcon::link_statistics<person_id> car_ownership_link_stats_owner(uint32_t threshold, F&& on_exceeded) const {
+			dcon::link_statistics<person_id> result;
+			const uint32_t n = person_size();
+			for(uint32_t i = 0; i < n; ++i) {
+				auto owner = person_id(person_id::value_base_t(i));
+				if(!person_is_valid(owner)) continue;
+				auto& vref = car_ownership.m_array_owner.vptr()[i];
+				uint32_t degree = uint32_t(vref.size());
+				result.storage_bytes += uint64_t(vref.capacity()) * sizeof(car_ownership_id);
+				result.record(owner, degree);
+				if(degree > threshold) on_exceeded(owner, degree);
+			}
+			return result;
+		}
+		
 
 
 
@@ -2575,6 +3031,19 @@ namespace car_owner_basic {
 			ve::execute_parallel_exact<car_id>(car.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_car_range(car_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<car_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<car_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<car_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, person_id> person_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, person_id>(person.size_used);
 		}
@@ -2591,6 +3060,19 @@ namespace car_owner_basic {
 			ve::execute_parallel_exact<person_id>(person.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_person_range(person_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<person_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<person_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<person_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, car_ownership_id> car_ownership_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, car_ownership_id>(car.size_used);
 		}
@@ -2607,6 +3089,19 @@ namespace car_owner_basic {
 			ve::execute_parallel_exact<car_ownership_id>(car.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_car_ownership_range(car_ownership_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<car_ownership_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<car_ownership_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<car_ownership_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, uniq_car_ownership_id> uniq_car_ownership_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, uniq_car_ownership_id>(person.size_used);
 		}
@@ -2623,6 +3118,19 @@ namespace car_owner_basic {
 			ve::execute_parallel_exact<uniq_car_ownership_id>(person.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_uniq_car_ownership_range(uniq_car_ownership_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<uniq_car_ownership_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<uniq_car_ownership_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<uniq_car_ownership_id>(aligned_end, end - aligned_end));
+		}
 		#endif
 
 		load_record serialize_entire_container_record() const noexcept {
@@ -3628,6 +4136,182 @@ namespace car_owner_basic {
 	};
 
 
+	//
+	// command buffer
+	//
+	class command_buffer {
+		public:
+		class alignas(64) recorder {
+			friend class command_buffer;
+			dcon::command_arena commands;
+			uint32_t car_created = 0;
+			uint32_t person_created = 0;
+			public:
+			dcon::deferred_id<car_id> create_car() {
+				commands.write(uint16_t(0));
+				return dcon::deferred_id<car_id>::make_placeholder(car_created++);
+			}
+			void car_set_wheels(dcon::deferred_id<car_id> id, int32_t value) {
+				commands.write(uint16_t(1));
+				commands.write(id);
+				commands.write(value);
+			}
+			void car_set_resale_value(dcon::deferred_id<car_id> id, float value) {
+				commands.write(uint16_t(2));
+				commands.write(id);
+				commands.write(value);
+			}
+			dcon::deferred_id<person_id> create_person() {
+				commands.write(uint16_t(3));
+				return dcon::deferred_id<person_id>::make_placeholder(person_created++);
+			}
+			void person_set_age(dcon::deferred_id<person_id> id, int32_t value) {
+				commands.write(uint16_t(4));
+				commands.write(id);
+				commands.write(value);
+			}
+			void car_ownership_set_ownership_date(car_ownership_id id, int32_t value) {
+				commands.write(uint16_t(5));
+				commands.write(id);
+				commands.write(value);
+			}
+			void try_create_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(6));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void force_create_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(7));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void car_ownership_set_owner(car_ownership_id id, dcon::deferred_id<person_id> value) {
+				commands.write(uint16_t(8));
+				commands.write(id);
+				commands.write(value);
+			}
+			void uniq_car_ownership_set_ownership_date(uniq_car_ownership_id id, int32_t value) {
+				commands.write(uint16_t(9));
+				commands.write(id);
+				commands.write(value);
+			}
+			void try_create_uniq_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(10));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void force_create_uniq_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(11));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void uniq_car_ownership_set_owned_car(uniq_car_ownership_id id, dcon::deferred_id<car_id> value) {
+				commands.write(uint16_t(12));
+				commands.write(id);
+				commands.write(value);
+			}
+		};
+		private:
+		std::vector<recorder> recorders;
+		public:
+		explicit command_buffer(uint32_t thread_count) : recorders(thread_count) { }
+		recorder& for_thread(uint32_t thread_index) noexcept {
+			return recorders[thread_index];
+		}
+		void clear() noexcept {
+			for(auto& rec : recorders) {
+				rec.commands.clear();
+				rec.car_created = 0;
+				rec.person_created = 0;
+			}
+		}
+		void playback(data_container& dc) {
+			std::vector<uint32_t> car_offsets(recorders.size());
+			uint32_t car_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				car_offsets[r] = car_total;
+				car_total += recorders[r].car_created;
+			}
+			car_id car_first = car_total != 0 ? dc.create_car_batch(car_total) : car_id();
+			auto resolve_car = [&](size_t r, dcon::deferred_id<car_id> d) {
+				return d.placeholder == 0 ? d.id : car_id(car_id::value_base_t(car_first.index() + car_offsets[r] + d.placeholder - 1));
+			} ;
+			std::vector<uint32_t> person_offsets(recorders.size());
+			uint32_t person_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				person_offsets[r] = person_total;
+				person_total += recorders[r].person_created;
+			}
+			person_id person_first = person_total != 0 ? dc.create_person_batch(person_total) : person_id();
+			auto resolve_person = [&](size_t r, dcon::deferred_id<person_id> d) {
+				return d.placeholder == 0 ? d.id : person_id(person_id::value_base_t(person_first.index() + person_offsets[r] + d.placeholder - 1));
+			} ;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				auto const& commands = recorders[r].commands;
+				size_t pos = 0;
+				while(pos < commands.size()) {
+					switch(commands.read<uint16_t>(pos)) {
+						case 0:
+							break;
+						case 1: {
+							auto id = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.car_set_wheels(id, commands.read<int32_t>(pos));
+						} break;
+						case 2: {
+							auto id = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.car_set_resale_value(id, commands.read<float>(pos));
+						} break;
+						case 3:
+							break;
+						case 4: {
+							auto id = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							dc.person_set_age(id, commands.read<int32_t>(pos));
+						} break;
+						case 5: {
+							auto id = commands.read<car_ownership_id>(pos);
+							dc.car_ownership_set_ownership_date(id, commands.read<int32_t>(pos));
+						} break;
+						case 6: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.try_create_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 7: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.force_create_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 8: {
+							auto id = commands.read<car_ownership_id>(pos);
+							auto value = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							dc.car_ownership_set_owner(id, value);
+						} break;
+						case 9: {
+							auto id = commands.read<uniq_car_ownership_id>(pos);
+							dc.uniq_car_ownership_set_ownership_date(id, commands.read<int32_t>(pos));
+						} break;
+						case 10: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.try_create_uniq_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 11: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.force_create_uniq_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 12: {
+							auto id = commands.read<uniq_car_ownership_id>(pos);
+							auto value = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.uniq_car_ownership_set_owned_car(id, value);
+						} break;
+					}
+				}
+			}
+			clear();
+		}
+	};
+	
 }
 
 #undef DCON_RELEASE_INLINE
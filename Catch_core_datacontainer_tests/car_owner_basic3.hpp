@@ -210,6 +210,18 @@ namespace cob3 {
 			}
 			m__index;
 			
+			//
+			// storage space for _live of type dcon::bitfield_type
+			//
+			struct alignas(64) dtype__live {
+				uint8_t padding[(63 + sizeof(dcon::bitfield_type)) & ~uint64_t(63)];
+				dcon::bitfield_type values[((uint32_t(1200 + 7)) / uint32_t(8) + uint32_t(63)) & ~uint32_t(63)];
+				DCON_RELEASE_INLINE auto vptr() const { return values; }
+				DCON_RELEASE_INLINE auto vptr() { return values; }
+				dtype__live() { std::uninitialized_value_construct_n(values - 1, 1 + ((uint32_t(1200 + 7)) / uint32_t(8) + uint32_t(63)) & ~uint32_t(63)); }
+			}
+			m__live;
+			
 			//
 			// storage space for wheels of type int32_t
 			//
@@ -235,6 +247,8 @@ namespace cob3 {
 			m_resale_value;
 			
 			car_id first_free = car_id();
+			uint32_t live_count = 0;
+			std::vector<dcon::bitfield_type> pending_delete = std::vector<dcon::bitfield_type>(150);
 			uint32_t size_used = 0;
 
 
@@ -267,6 +281,18 @@ namespace cob3 {
 			}
 			m__index;
 			
+			//
+			// storage space for _live of type dcon::bitfield_type
+			//
+			struct alignas(64) dtype__live {
+				uint8_t padding[(63 + sizeof(dcon::bitfield_type)) & ~uint64_t(63)];
+				dcon::bitfield_type values[((uint32_t(100 + 7)) / uint32_t(8) + uint32_t(63)) & ~uint32_t(63)];
+				DCON_RELEASE_INLINE auto vptr() const { return values; }
+				DCON_RELEASE_INLINE auto vptr() { return values; }
+				dtype__live() { std::uninitialized_value_construct_n(values - 1, 1 + ((uint32_t(100 + 7)) / uint32_t(8) + uint32_t(63)) & ~uint32_t(63)); }
+			}
+			m__live;
+			
 			//
 			// storage space for age of type int32_t
 			//
@@ -280,6 +306,8 @@ namespace cob3 {
 			m_age;
 			
 			person_id first_free = person_id();
+			uint32_t live_count = 0;
+			std::vector<dcon::bitfield_type> pending_delete = std::vector<dcon::bitfield_type>(13);
 			uint32_t size_used = 0;
 
 
@@ -1225,6 +1253,20 @@ namespace cob3 {
 		DCON_RELEASE_INLINE bool car_is_valid(car_id id) const noexcept {
 			return bool(id) && uint32_t(id.index()) < car.size_used && car.m__index.vptr()[id.index()] == id;
 		}
+		DCON_RELEASE_INLINE uint32_t car_live_count() const noexcept {
+			return car.live_count;
+		}
+		#ifndef DCON_NO_VE
+		DCON_RELEASE_INLINE ve::vbitfield_type car_is_live(ve::contiguous_tags<car_id> id) const noexcept {
+			return ve::load(id, car.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::vbitfield_type car_is_live(ve::partial_contiguous_tags<car_id> id) const noexcept {
+			return ve::load(id, car.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::mask_vector car_is_live(ve::tagged_vector<car_id> id) const noexcept {
+			return ve::load(id, car.m__live.vptr());
+		}
+		#endif
 		
 		uint32_t car_size() const noexcept { return car.size_used; }
 
@@ -1323,6 +1365,20 @@ namespace cob3 {
 		DCON_RELEASE_INLINE bool person_is_valid(person_id id) const noexcept {
 			return bool(id) && uint32_t(id.index()) < person.size_used && person.m__index.vptr()[id.index()] == id;
 		}
+		DCON_RELEASE_INLINE uint32_t person_live_count() const noexcept {
+			return person.live_count;
+		}
+		#ifndef DCON_NO_VE
+		DCON_RELEASE_INLINE ve::vbitfield_type person_is_live(ve::contiguous_tags<person_id> id) const noexcept {
+			return ve::load(id, person.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::vbitfield_type person_is_live(ve::partial_contiguous_tags<person_id> id) const noexcept {
+			return ve::load(id, person.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::mask_vector person_is_live(ve::tagged_vector<person_id> id) const noexcept {
+			return ve::load(id, person.m__live.vptr());
+		}
+		#endif
 		
 		uint32_t person_size() const noexcept { return person.size_used; }
 
@@ -1464,8 +1520,11 @@ namespace cob3 {
 			assert(id_removed.index() >= 0);
 			assert(car.m__index.vptr()[id_removed.index()] == id_removed);
 			#endif
+			dcon::bit_vector_set(car.pending_delete.data(), id_removed.index(), false);
 			car.m__index.vptr()[id_removed.index()] = car.first_free;
 			car.first_free = id_removed;
+			dcon::bit_vector_set(car.m__live.vptr(), id_removed.index(), false);
+			--car.live_count;
 			if(int32_t(car.size_used) - 1 == id_removed.index()) {
 				for( ; car.size_used > 0 && car.m__index.vptr()[car.size_used - 1] != car_id(car_id::value_base_t(car.size_used - 1));  --car.size_used) ;
 			}
@@ -1474,6 +1533,48 @@ namespace cob3 {
 			car.m_resale_value.vptr()[id_removed.index()] = float{};
 		}
 		
+		//
+		// container batch delete for car
+		//
+		void delete_car_batch(car_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((car.size_used + 7) / 8);
+			std::vector<car_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!car_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			for(auto id : victims) {
+				delete_car(id);
+			}
+		}
+		
+		//
+		// container deferred delete for car
+		//
+		void queue_delete_car(car_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < car.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(car.pending_delete.data(), id.index());
+		}
+		bool car_is_pending_delete(car_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(car.pending_delete.data(), id.index());
+		}
+		void commit_deletes_car() {
+			const uint32_t count = car_size();
+			std::vector<car_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(car.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(car.pending_delete.data(), i + 1, count)) {
+				victims.push_back(car_id(car_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(car.pending_delete.begin(), car.pending_delete.end(), dcon::bitfield_type{0});
+			delete_car_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container create for car
 		//
@@ -1487,9 +1588,31 @@ namespace cob3 {
 			car.first_free = car.m__index.vptr()[car.first_free.index()];
 			car.m__index.vptr()[new_id.index()] = new_id;
 			car.size_used = std::max(car.size_used, uint32_t(new_id.index() + 1));
+			dcon::bit_vector_set(car.m__live.vptr(), new_id.index(), true);
+			++car.live_count;
 			return new_id;
 		}
 		
+		//
+		// container batch create for car
+		//
+		void create_car_batch(car_id* ids_out, uint32_t count) {
+			for(uint32_t k = 0; k < count; ++k) {
+				#ifndef DCON_USE_EXCEPTIONS
+				if(!bool(car.first_free)) std::abort();
+				#else
+				if(!bool(car.first_free)) throw dcon::out_of_space{};
+				#endif
+				car_id new_id = car.first_free;
+				car.first_free = car.m__index.vptr()[car.first_free.index()];
+				car.m__index.vptr()[new_id.index()] = new_id;
+				car.size_used = std::max(car.size_used, uint32_t(new_id.index() + 1));
+				dcon::bit_vector_set(car.m__live.vptr(), new_id.index(), true);
+				++car.live_count;
+				ids_out[k] = new_id;
+			}
+		}
+		
 		//
 		// container resize for car
 		//
@@ -1531,6 +1654,66 @@ namespace cob3 {
 				}
 			}
 			car.size_used = new_size;
+			std::fill(car.m__live.vptr(), car.m__live.vptr() + (1200 + 7) / 8, dcon::bitfield_type{});
+			car.live_count = 0;
+			for(uint32_t j = 0; j < new_size; ++j) {
+				if(car.m__index.vptr()[j] == car_id(car_id::value_base_t(j))) {
+					dcon::bit_vector_set(car.m__live.vptr(), int32_t(j), true);
+					++car.live_count;
+				}
+			}
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(car.pending_delete.data(), int32_t(i), false);
+			}
+		}
+		
+		private:
+		//
+		// container move object for car
+		//
+		void internal_move_car(car_id last_id, car_id id_removed) {
+			dcon::bit_vector_set(car.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(car.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(car.pending_delete.data(), last_id.index(), false);
+			internal_move_relationship_car_ownership(car_ownership_id(car_ownership_id::value_base_t(last_id.index())), car_ownership_id(car_ownership_id::value_base_t(id_removed.index())));
+			car.m_wheels.vptr()[id_removed.index()] = std::move(car.m_wheels.vptr()[last_id.index()]);
+			car.m_wheels.vptr()[last_id.index()] = int32_t{};
+			car.m_resale_value.vptr()[id_removed.index()] = std::move(car.m_resale_value.vptr()[last_id.index()]);
+			car.m_resale_value.vptr()[last_id.index()] = float{};
+		}
+		
+		public:
+		//
+		// container compaction for car
+		//
+		std::vector<car_id> compact_car() {
+			std::vector<car_id> remap(car.size_used);
+			for(uint32_t i = dcon::bit_vector_next_set(car.m__live.vptr(), 0, car.size_used); i < car.size_used; i = dcon::bit_vector_next_set(car.m__live.vptr(), i + 1, car.size_used)) {
+				remap[i] = car_id(car_id::value_base_t(i));
+			}
+			uint32_t low = 0;
+			uint32_t high = car.size_used;
+			while(true) {
+				while(low < high && dcon::bit_vector_test(car.m__live.vptr(), int32_t(low))) ++low;
+				while(high > low && !dcon::bit_vector_test(car.m__live.vptr(), int32_t(high - 1))) --high;
+				if(low >= high) break;
+				auto last_id = car_id(car_id::value_base_t(high - 1));
+				auto id_removed = car_id(car_id::value_base_t(low));
+				internal_move_car(last_id, id_removed);
+				car.m__index.vptr()[low] = id_removed;
+				dcon::bit_vector_set(car.m__live.vptr(), int32_t(low), true);
+				dcon::bit_vector_set(car.m__live.vptr(), int32_t(high - 1), false);
+				remap[high - 1] = id_removed;
+				++low;
+				--high;
+			}
+			car.size_used = car.live_count;
+			const uint32_t capacity = 1200;
+			car.first_free = car_id();
+			for(uint32_t i = capacity; i-- > car.size_used; ) {
+				car.m__index.vptr()[i] = car.first_free;
+				car.first_free = car_id(car_id::value_base_t(i));
+			}
+			return remap;
 		}
 		
 		//
@@ -1541,8 +1724,11 @@ namespace cob3 {
 			assert(id_removed.index() >= 0);
 			assert(person.m__index.vptr()[id_removed.index()] == id_removed);
 			#endif
+			dcon::bit_vector_set(person.pending_delete.data(), id_removed.index(), false);
 			person.m__index.vptr()[id_removed.index()] = person.first_free;
 			person.first_free = id_removed;
+			dcon::bit_vector_set(person.m__live.vptr(), id_removed.index(), false);
+			--person.live_count;
 			if(int32_t(person.size_used) - 1 == id_removed.index()) {
 				for( ; person.size_used > 0 && person.m__index.vptr()[person.size_used - 1] != person_id(person_id::value_base_t(person.size_used - 1));  --person.size_used) ;
 			}
@@ -1550,6 +1736,48 @@ namespace cob3 {
 			person.m_age.vptr()[id_removed.index()] = int32_t{};
 		}
 		
+		//
+		// container batch delete for person
+		//
+		void delete_person_batch(person_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((person.size_used + 7) / 8);
+			std::vector<person_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!person_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			for(auto id : victims) {
+				delete_person(id);
+			}
+		}
+		
+		//
+		// container deferred delete for person
+		//
+		void queue_delete_person(person_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < person.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(person.pending_delete.data(), id.index());
+		}
+		bool person_is_pending_delete(person_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(person.pending_delete.data(), id.index());
+		}
+		void commit_deletes_person() {
+			const uint32_t count = person_size();
+			std::vector<person_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(person.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(person.pending_delete.data(), i + 1, count)) {
+				victims.push_back(person_id(person_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(person.pending_delete.begin(), person.pending_delete.end(), dcon::bitfield_type{0});
+			delete_person_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container create for person
 		//
@@ -1563,9 +1791,31 @@ namespace cob3 {
 			person.first_free = person.m__index.vptr()[person.first_free.index()];
 			person.m__index.vptr()[new_id.index()] = new_id;
 			person.size_used = std::max(person.size_used, uint32_t(new_id.index() + 1));
+			dcon::bit_vector_set(person.m__live.vptr(), new_id.index(), true);
+			++person.live_count;
 			return new_id;
 		}
 		
+		//
+		// container batch create for person
+		//
+		void create_person_batch(person_id* ids_out, uint32_t count) {
+			for(uint32_t k = 0; k < count; ++k) {
+				#ifndef DCON_USE_EXCEPTIONS
+				if(!bool(person.first_free)) std::abort();
+				#else
+				if(!bool(person.first_free)) throw dcon::out_of_space{};
+				#endif
+				person_id new_id = person.first_free;
+				person.first_free = person.m__index.vptr()[person.first_free.index()];
+				person.m__index.vptr()[new_id.index()] = new_id;
+				person.size_used = std::max(person.size_used, uint32_t(new_id.index() + 1));
+				dcon::bit_vector_set(person.m__live.vptr(), new_id.index(), true);
+				++person.live_count;
+				ids_out[k] = new_id;
+			}
+		}
+		
 		//
 		// container resize for person
 		//
@@ -1606,6 +1856,68 @@ namespace cob3 {
 				}
 			}
 			person.size_used = new_size;
+			std::fill(person.m__live.vptr(), person.m__live.vptr() + (100 + 7) / 8, dcon::bitfield_type{});
+			person.live_count = 0;
+			for(uint32_t j = 0; j < new_size; ++j) {
+				if(person.m__index.vptr()[j] == person_id(person_id::value_base_t(j))) {
+					dcon::bit_vector_set(person.m__live.vptr(), int32_t(j), true);
+					++person.live_count;
+				}
+			}
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(person.pending_delete.data(), int32_t(i), false);
+			}
+		}
+		
+		private:
+		//
+		// container move object for person
+		//
+		void internal_move_person(person_id last_id, person_id id_removed) {
+			dcon::bit_vector_set(person.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(person.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(person.pending_delete.data(), last_id.index(), false);
+			person_for_each_car_ownership_as_owner(last_id, [this, id_removed, last_id](car_ownership_id i) {
+				car_ownership.m_owner.vptr()[i.index()] = id_removed;
+			} );
+			car_ownership.m_array_owner.vptr()[id_removed.index()] = std::move(car_ownership.m_array_owner.vptr()[last_id.index()]);
+			car_ownership.m_array_owner.vptr()[last_id.index()] = std::vector<car_ownership_id>{};
+			person.m_age.vptr()[id_removed.index()] = std::move(person.m_age.vptr()[last_id.index()]);
+			person.m_age.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container compaction for person
+		//
+		std::vector<person_id> compact_person() {
+			std::vector<person_id> remap(person.size_used);
+			for(uint32_t i = dcon::bit_vector_next_set(person.m__live.vptr(), 0, person.size_used); i < person.size_used; i = dcon::bit_vector_next_set(person.m__live.vptr(), i + 1, person.size_used)) {
+				remap[i] = person_id(person_id::value_base_t(i));
+			}
+			uint32_t low = 0;
+			uint32_t high = person.size_used;
+			while(true) {
+				while(low < high && dcon::bit_vector_test(person.m__live.vptr(), int32_t(low))) ++low;
+				while(high > low && !dcon::bit_vector_test(person.m__live.vptr(), int32_t(high - 1))) --high;
+				if(low >= high) break;
+				auto last_id = person_id(person_id::value_base_t(high - 1));
+				auto id_removed = person_id(person_id::value_base_t(low));
+				internal_move_person(last_id, id_removed);
+				person.m__index.vptr()[low] = id_removed;
+				dcon::bit_vector_set(person.m__live.vptr(), int32_t(low), true);
+				dcon::bit_vector_set(person.m__live.vptr(), int32_t(high - 1), false);
+				remap[high - 1] = id_removed;
+				++low;
+				--high;
+			}
+			person.size_used = person.live_count;
+			const uint32_t capacity = 100;
+			person.first_free = person_id();
+			for(uint32_t i = capacity; i-- > person.size_used; ) {
+				person.m__index.vptr()[i] = person.first_free;
+				person.first_free = person_id(person_id::value_base_t(i));
+			}
+			return remap;
 		}
 		
 		//
@@ -1689,13 +2001,101 @@ namespace cob3 {
 			return new_id;
 		}
 		
+		//
+		// container bulk create relationship for car_ownership
+		//
+		struct car_ownership_link_tuple {
+			person_id owner;
+			car_id owned_car;
+		};
+		uint32_t bulk_create_car_ownership(car_ownership_link_tuple const* links, uint32_t link_count, car_ownership_id* ids_out = nullptr) {
+			std::vector<uint32_t> accepted;
+			accepted.reserve(link_count);
+			std::vector<dcon::bitfield_type> claimed_owned_car((car_size() + 7) / 8);
+			for(uint32_t i = 0; i < link_count; ++i) {
+				if(ids_out) ids_out[i] = car_ownership_id();
+				auto owner_p = links[i].owner;
+				if(!bool(owner_p)) continue;
+				auto owned_car_p = links[i].owned_car;
+				if(!bool(owned_car_p)) continue;
+				if(car_ownership_is_valid(car_ownership_id(car_ownership_id::value_base_t(owned_car_p.index()))) || (uint32_t(owned_car_p.index()) < claimed_owned_car.size() * 8 && dcon::bit_vector_test(claimed_owned_car.data(), owned_car_p.index()))) continue;
+				if(bool(owned_car_p)) {
+					if(uint32_t(owned_car_p.index()) >= claimed_owned_car.size() * 8) claimed_owned_car.resize(owned_car_p.index() / 8 + 1);
+					dcon::bit_vector_set(claimed_owned_car.data(), owned_car_p.index(), true);
+				}
+				accepted.push_back(i);
+			}
+			const uint32_t count = uint32_t(accepted.size());
+			if(count == 0) return 0;
+			std::vector<car_ownership_id> new_ids(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto owned_car_p = links[accepted[k]].owned_car;
+				new_ids[k] = car_ownership_id(car_ownership_id::value_base_t(owned_car_p.index()));
+				if(car.size_used < uint32_t(owned_car_p.value)) car_resize(uint32_t(owned_car_p.value));
+			}
+			for(uint32_t k = 0; k < count; ++k) {
+				auto const& e = links[accepted[k]];
+				auto new_id = new_ids[k];
+				car_ownership.m_owner.vptr()[new_id.index()] = e.owner;
+			}
+			 {
+				std::vector<std::pair<person_id, car_ownership_id>> pending;
+				pending.reserve(size_t(count) * 1);
+				for(uint32_t k = 0; k < count; ++k) {
+					if(auto v = car_ownership.m_owner.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);
+				}
+				std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });
+				for(size_t j = 0; j < pending.size(); ) {
+					auto target = pending[j].first;
+					size_t run_end = j + 1;
+					while(run_end < pending.size() && pending[run_end].first == target) ++run_end;
+					auto& vref = car_ownership.m_array_owner.vptr()[target.index()];
+					vref.reserve(vref.size() + (run_end - j));
+					for(; j < run_end; ++j) vref.push_back(pending[j].second);
+				}
+			}
+			if(ids_out) {
+				for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];
+			}
+			return count;
+		}
+		
+		void commit_deletes() {
+			commit_deletes_car();
+			commit_deletes_person();
+		}
+
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_car(T&& func) {
-			for(uint32_t i = 0; i < car.size_used; ++i) {
-				car_id tmp = car_id(car_id::value_base_t(i));
-				if(car.m__index.vptr()[tmp.index()] == tmp) func(tmp);
+			for(uint32_t i = dcon::bit_vector_next_set(car.m__live.vptr(), 0, car.size_used); i < car.size_used; i = dcon::bit_vector_next_set(car.m__live.vptr(), i + 1, car.size_used)) {
+				func(car_id(car_id::value_base_t(i)));
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_car(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(car.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, car_id, int32_t>)
+						func(car_id(car_id::value_base_t(i)), thread);
+					else
+						func(car_id(car_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = dcon::bit_vector_next_set(car.m__live.vptr(), first, last); i < last; i = dcon::bit_vector_next_set(car.m__live.vptr(), i + 1, last)) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_car(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<car_id>(car.size_used, identity, [&](car_id id) -> T {
+				return dcon::bit_vector_test(car.m__live.vptr(), id.index()) ? T(func(id)) : identity;
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_car;
 		friend internal::object_iterator_car;
 		struct {
@@ -1715,11 +2115,35 @@ namespace cob3 {
 		
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_person(T&& func) {
-			for(uint32_t i = 0; i < person.size_used; ++i) {
-				person_id tmp = person_id(person_id::value_base_t(i));
-				if(person.m__index.vptr()[tmp.index()] == tmp) func(tmp);
+			for(uint32_t i = dcon::bit_vector_next_set(person.m__live.vptr(), 0, person.size_used); i < person.size_used; i = dcon::bit_vector_next_set(person.m__live.vptr(), i + 1, person.size_used)) {
+				func(person_id(person_id::value_base_t(i)));
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_person(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(person.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, person_id, int32_t>)
+						func(person_id(person_id::value_base_t(i)), thread);
+					else
+						func(person_id(person_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = dcon::bit_vector_next_set(person.m__live.vptr(), first, last); i < last; i = dcon::bit_vector_next_set(person.m__live.vptr(), i + 1, last)) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_person(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<person_id>(person.size_used, identity, [&](person_id id) -> T {
+				return dcon::bit_vector_test(person.m__live.vptr(), id.index()) ? T(func(id)) : identity;
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_person;
 		friend internal::object_iterator_person;
 		struct {
@@ -1744,6 +2168,31 @@ namespace cob3 {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_car_ownership(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(car.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, car_ownership_id, int32_t>)
+						func(car_ownership_id(car_ownership_id::value_base_t(i)), thread);
+					else
+						func(car_ownership_id(car_ownership_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_car_ownership(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<car_ownership_id>(car.size_used, identity, [&](car_ownership_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_car_ownership;
 		friend internal::object_iterator_car_ownership;
 		struct {
@@ -1761,6 +2210,28 @@ namespace cob3 {
 			}
 		}  in_car_ownership ;
 		
+		//
+		// container link statistics for car_ownership owner
+		//
+		dcon::link_statistics<person_id> car_ownership_link_stats_owner() const {
+			return car_ownership_link_stats_owner(std::numeric_limits<uint32_t>::max(), [](person_id, uint32_t) {});
+		}
+		template<typename F>
+		dcon::link_statistics<person_id> car_ownership_link_stats_owner(uint32_t threshold, F&& on_exceeded) const {
+			dcon::link_statistics<person_id> result;
+			const uint32_t n = person_size();
+			for(uint32_t i = 0; i < n; ++i) {
+				auto owner = person_id(person_id::value_base_t(i));
+				if(!person_is_valid(owner)) continue;
+				auto& vref = car_ownership.m_array_owner.vptr()[i];
+				uint32_t degree = uint32_t(vref.size());
+				result.storage_bytes += uint64_t(vref.capacity()) * sizeof(car_ownership_id);
+				result.record(owner, degree);
+				if(degree > threshold) on_exceeded(owner, degree);
+			}
+			return result;
+		}
+		
 
 
 
@@ -1786,6 +2257,48 @@ namespace cob3 {
 		DCON_RELEASE_INLINE void execute_parallel_over_car(F&& functor) {
 			ve::execute_parallel_exact<car_id>(car.size_used, functor);
 		}
+#endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_car_range(car_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<car_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<car_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<car_id>(aligned_end, end - aligned_end));
+		}
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_car_live(F&& functor) {
+			const uint32_t count = car.size_used;
+			for(uint32_t i = dcon::bit_vector_next_set(car.m__live.vptr(), 0, count); i < count; i = dcon::bit_vector_next_set(car.m__live.vptr(), i, count)) {
+				i &= ~uint32_t(ve::vector_size - 1);
+				if(i + ve::vector_size <= count)
+					functor(ve::contiguous_tags<car_id>(i));
+				else
+					functor(ve::partial_contiguous_tags<car_id>(i, count - i));
+				i += ve::vector_size;
+			}
+		}
+#ifndef VE_NO_TBB
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_parallel_over_car_live(F&& functor) {
+			const uint32_t count = car.size_used;
+			concurrency::parallel_for(uint32_t(0), (count + 63) / 64, [&](uint32_t b) {
+				const uint32_t block_end = std::min(count, b * 64 + 64);
+				for(uint32_t i = dcon::bit_vector_next_set(car.m__live.vptr(), b * 64, block_end); i < block_end; i = dcon::bit_vector_next_set(car.m__live.vptr(), i, block_end)) {
+					i &= ~uint32_t(ve::vector_size - 1);
+					if(i + ve::vector_size <= count)
+						functor(ve::contiguous_tags<car_id>(i));
+					else
+						functor(ve::partial_contiguous_tags<car_id>(i, count - i));
+					i += ve::vector_size;
+				}
+			});
+		}
 #endif
 		ve::vectorizable_buffer<float, person_id> person_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, person_id>(person.size_used);
@@ -1802,6 +2315,48 @@ namespace cob3 {
 		DCON_RELEASE_INLINE void execute_parallel_over_person(F&& functor) {
 			ve::execute_parallel_exact<person_id>(person.size_used, functor);
 		}
+#endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_person_range(person_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<person_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<person_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<person_id>(aligned_end, end - aligned_end));
+		}
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_person_live(F&& functor) {
+			const uint32_t count = person.size_used;
+			for(uint32_t i = dcon::bit_vector_next_set(person.m__live.vptr(), 0, count); i < count; i = dcon::bit_vector_next_set(person.m__live.vptr(), i, count)) {
+				i &= ~uint32_t(ve::vector_size - 1);
+				if(i + ve::vector_size <= count)
+					functor(ve::contiguous_tags<person_id>(i));
+				else
+					functor(ve::partial_contiguous_tags<person_id>(i, count - i));
+				i += ve::vector_size;
+			}
+		}
+#ifndef VE_NO_TBB
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_parallel_over_person_live(F&& functor) {
+			const uint32_t count = person.size_used;
+			concurrency::parallel_for(uint32_t(0), (count + 63) / 64, [&](uint32_t b) {
+				const uint32_t block_end = std::min(count, b * 64 + 64);
+				for(uint32_t i = dcon::bit_vector_next_set(person.m__live.vptr(), b * 64, block_end); i < block_end; i = dcon::bit_vector_next_set(person.m__live.vptr(), i, block_end)) {
+					i &= ~uint32_t(ve::vector_size - 1);
+					if(i + ve::vector_size <= count)
+						functor(ve::contiguous_tags<person_id>(i));
+					else
+						functor(ve::partial_contiguous_tags<person_id>(i, count - i));
+					i += ve::vector_size;
+				}
+			});
+		}
 #endif
 		ve::vectorizable_buffer<float, car_ownership_id> car_ownership_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, car_ownership_id>(car.size_used);
@@ -1819,6 +2374,19 @@ namespace cob3 {
 			ve::execute_parallel_exact<car_ownership_id>(car.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_car_ownership_range(car_ownership_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<car_ownership_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<car_ownership_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<car_ownership_id>(aligned_end, end - aligned_end));
+		}
 		#endif
 
 		load_record serialize_entire_container_record() const noexcept {
@@ -2000,6 +2568,14 @@ namespace cob3 {
 								} else {
 								}
 							}
+							std::fill(car.m__live.vptr(), car.m__live.vptr() + (1200 + 7) / 8, dcon::bitfield_type{});
+							car.live_count = 0;
+							for(uint32_t j = 0; j < car.size_used; ++j) {
+								if(car.m__index.vptr()[j] == car_id(car_id::value_base_t(j))) {
+									dcon::bit_vector_set(car.m__live.vptr(), int32_t(j), true);
+									++car.live_count;
+								}
+							}
 						}
 						return;
 					}
@@ -2159,6 +2735,14 @@ namespace cob3 {
 								} else {
 								}
 							}
+							std::fill(person.m__live.vptr(), person.m__live.vptr() + (100 + 7) / 8, dcon::bitfield_type{});
+							person.live_count = 0;
+							for(uint32_t j = 0; j < person.size_used; ++j) {
+								if(person.m__index.vptr()[j] == person_id(person_id::value_base_t(j))) {
+									dcon::bit_vector_set(person.m__live.vptr(), int32_t(j), true);
+									++person.live_count;
+								}
+							}
 						}
 						return;
 					}
@@ -2528,40 +3112,32 @@ namespace cob3 {
 		DCON_RELEASE_INLINE object_term_iterator_car::object_term_iterator_car(uint32_t i) noexcept : index(i) {
 		}
 		DCON_RELEASE_INLINE object_iterator_car::object_iterator_car(data_container& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.car.m__live.vptr(), index, container.car.size_used);
 		}
 		DCON_RELEASE_INLINE const_object_iterator_car::const_object_iterator_car(data_container const& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.car.m__live.vptr(), index, container.car.size_used);
 		}
 		DCON_RELEASE_INLINE object_iterator_car& object_iterator_car::operator++() noexcept {
 			++index;
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.car.m__live.vptr(), index, container.car.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_car& const_object_iterator_car::operator++() noexcept {
 			++index;
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.car.m__live.vptr(), index, container.car.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE object_iterator_car& object_iterator_car::operator--() noexcept {
 			--index;
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				--index;
+			if(index < container.car.size_used) {
+				index = dcon::bit_vector_prev_set(container.car.m__live.vptr(), index);
 			}
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_car& const_object_iterator_car::operator--() noexcept {
 			--index;
-			while(container.car.m__index.vptr()[index] != car_id(car_id::value_base_t(index)) && index < container.car.size_used) {
-				--index;
+			if(index < container.car.size_used) {
+				index = dcon::bit_vector_prev_set(container.car.m__live.vptr(), index);
 			}
 			return *this;
 		}
@@ -2569,40 +3145,32 @@ namespace cob3 {
 		DCON_RELEASE_INLINE object_term_iterator_person::object_term_iterator_person(uint32_t i) noexcept : index(i) {
 		}
 		DCON_RELEASE_INLINE object_iterator_person::object_iterator_person(data_container& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.person.m__live.vptr(), index, container.person.size_used);
 		}
 		DCON_RELEASE_INLINE const_object_iterator_person::const_object_iterator_person(data_container const& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.person.m__live.vptr(), index, container.person.size_used);
 		}
 		DCON_RELEASE_INLINE object_iterator_person& object_iterator_person::operator++() noexcept {
 			++index;
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.person.m__live.vptr(), index, container.person.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_person& const_object_iterator_person::operator++() noexcept {
 			++index;
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.person.m__live.vptr(), index, container.person.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE object_iterator_person& object_iterator_person::operator--() noexcept {
 			--index;
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				--index;
+			if(index < container.person.size_used) {
+				index = dcon::bit_vector_prev_set(container.person.m__live.vptr(), index);
 			}
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_person& const_object_iterator_person::operator--() noexcept {
 			--index;
-			while(container.person.m__index.vptr()[index] != person_id(person_id::value_base_t(index)) && index < container.person.size_used) {
-				--index;
+			if(index < container.person.size_used) {
+				index = dcon::bit_vector_prev_set(container.person.m__live.vptr(), index);
 			}
 			return *this;
 		}
@@ -2664,6 +3232,163 @@ namespace cob3 {
 	};
 
 
+	//
+	// command buffer
+	//
+	class command_buffer {
+		public:
+		class alignas(64) recorder {
+			friend class command_buffer;
+			dcon::command_arena commands;
+			uint32_t car_created = 0;
+			uint32_t person_created = 0;
+			public:
+			dcon::deferred_id<car_id> create_car() {
+				commands.write(uint16_t(0));
+				return dcon::deferred_id<car_id>::make_placeholder(car_created++);
+			}
+			void delete_car(dcon::deferred_id<car_id> id) {
+				commands.write(uint16_t(1));
+				commands.write(id);
+			}
+			void car_set_wheels(dcon::deferred_id<car_id> id, int32_t value) {
+				commands.write(uint16_t(2));
+				commands.write(id);
+				commands.write(value);
+			}
+			void car_set_resale_value(dcon::deferred_id<car_id> id, float value) {
+				commands.write(uint16_t(3));
+				commands.write(id);
+				commands.write(value);
+			}
+			dcon::deferred_id<person_id> create_person() {
+				commands.write(uint16_t(4));
+				return dcon::deferred_id<person_id>::make_placeholder(person_created++);
+			}
+			void delete_person(dcon::deferred_id<person_id> id) {
+				commands.write(uint16_t(5));
+				commands.write(id);
+			}
+			void person_set_age(dcon::deferred_id<person_id> id, int32_t value) {
+				commands.write(uint16_t(6));
+				commands.write(id);
+				commands.write(value);
+			}
+			void car_ownership_set_ownership_date(car_ownership_id id, int32_t value) {
+				commands.write(uint16_t(7));
+				commands.write(id);
+				commands.write(value);
+			}
+			void try_create_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(8));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void force_create_car_ownership(dcon::deferred_id<person_id> owner_p, dcon::deferred_id<car_id> owned_car_p) {
+				commands.write(uint16_t(9));
+				commands.write(owner_p);
+				commands.write(owned_car_p);
+			}
+			void car_ownership_set_owner(car_ownership_id id, dcon::deferred_id<person_id> value) {
+				commands.write(uint16_t(10));
+				commands.write(id);
+				commands.write(value);
+			}
+		};
+		private:
+		std::vector<recorder> recorders;
+		public:
+		explicit command_buffer(uint32_t thread_count) : recorders(thread_count) { }
+		recorder& for_thread(uint32_t thread_index) noexcept {
+			return recorders[thread_index];
+		}
+		void clear() noexcept {
+			for(auto& rec : recorders) {
+				rec.commands.clear();
+				rec.car_created = 0;
+				rec.person_created = 0;
+			}
+		}
+		void playback(data_container& dc) {
+			std::vector<uint32_t> car_offsets(recorders.size());
+			uint32_t car_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				car_offsets[r] = car_total;
+				car_total += recorders[r].car_created;
+			}
+			std::vector<car_id> car_ids(car_total);
+			if(car_total != 0) dc.create_car_batch(car_ids.data(), car_total);
+			auto resolve_car = [&](size_t r, dcon::deferred_id<car_id> d) {
+				return d.placeholder == 0 ? d.id : car_ids[car_offsets[r] + d.placeholder - 1];
+			} ;
+			std::vector<uint32_t> person_offsets(recorders.size());
+			uint32_t person_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				person_offsets[r] = person_total;
+				person_total += recorders[r].person_created;
+			}
+			std::vector<person_id> person_ids(person_total);
+			if(person_total != 0) dc.create_person_batch(person_ids.data(), person_total);
+			auto resolve_person = [&](size_t r, dcon::deferred_id<person_id> d) {
+				return d.placeholder == 0 ? d.id : person_ids[person_offsets[r] + d.placeholder - 1];
+			} ;
+			std::vector<car_id> car_deletes;
+			std::vector<person_id> person_deletes;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				auto const& commands = recorders[r].commands;
+				size_t pos = 0;
+				while(pos < commands.size()) {
+					switch(commands.read<uint16_t>(pos)) {
+						case 0:
+							break;
+						case 1:
+							car_deletes.push_back(resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos)));
+							break;
+						case 2: {
+							auto id = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.car_set_wheels(id, commands.read<int32_t>(pos));
+						} break;
+						case 3: {
+							auto id = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.car_set_resale_value(id, commands.read<float>(pos));
+						} break;
+						case 4:
+							break;
+						case 5:
+							person_deletes.push_back(resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos)));
+							break;
+						case 6: {
+							auto id = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							dc.person_set_age(id, commands.read<int32_t>(pos));
+						} break;
+						case 7: {
+							auto id = commands.read<car_ownership_id>(pos);
+							dc.car_ownership_set_ownership_date(id, commands.read<int32_t>(pos));
+						} break;
+						case 8: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.try_create_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 9: {
+							auto owner_p = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							auto owned_car_p = resolve_car(r, commands.read<dcon::deferred_id<car_id>>(pos));
+							dc.force_create_car_ownership(owner_p, owned_car_p);
+						} break;
+						case 10: {
+							auto id = commands.read<car_ownership_id>(pos);
+							auto value = resolve_person(r, commands.read<dcon::deferred_id<person_id>>(pos));
+							dc.car_ownership_set_owner(id, value);
+						} break;
+					}
+				}
+			}
+			dc.delete_car_batch(car_deletes.data(), uint32_t(car_deletes.size()));
+			dc.delete_person_batch(person_deletes.data(), uint32_t(person_deletes.size()));
+			clear();
+		}
+	};
+	
 }
 
 #undef DCON_RELEASE_INLINE
@@ -206,6 +206,7 @@ namespace ex1 {
 			}
 			m_wheels;
 			
+			std::vector<dcon::bitfield_type> pending_delete;
 			uint32_t size_used = 0;
 
 
@@ -270,6 +271,17 @@ namespace ex1 {
 			}
 			m__index;
 			
+			//
+			// storage space for _live of type dcon::bitfield_type
+			//
+			struct alignas(64) dtype__live {
+				std::vector<dcon::bitfield_type> values;
+				DCON_RELEASE_INLINE auto vptr() const { return values.data() + 1; }
+				DCON_RELEASE_INLINE auto vptr() { return values.data() + 1; }
+				dtype__live() { values.emplace_back(); }
+			}
+			m__live;
+			
 			//
 			// storage space for thingies of type int32_t
 			//
@@ -326,6 +338,8 @@ namespace ex1 {
 			m_array_right;
 			
 			lr_relation_id first_free = lr_relation_id();
+			uint32_t live_count = 0;
+			std::vector<dcon::bitfield_type> pending_delete;
 			uint32_t size_used = 0;
 
 
@@ -1248,6 +1262,7 @@ namespace ex1 {
 		internal::top_class top;
 		internal::bottom_class bottom;
 		internal::lr_relation_class lr_relation;
+		dcon::relocation_tracker* lr_relation_relocations = nullptr;
 
 		//
 		// Functions for top:
@@ -1574,6 +1589,20 @@ namespace ex1 {
 		DCON_RELEASE_INLINE bool lr_relation_is_valid(lr_relation_id id) const noexcept {
 			return bool(id) && uint32_t(id.index()) < lr_relation.size_used && lr_relation.m__index.vptr()[id.index()] == id;
 		}
+		DCON_RELEASE_INLINE uint32_t lr_relation_live_count() const noexcept {
+			return lr_relation.live_count;
+		}
+		#ifndef DCON_NO_VE
+		DCON_RELEASE_INLINE ve::vbitfield_type lr_relation_is_live(ve::unaligned_contiguous_tags<lr_relation_id> id) const noexcept {
+			return ve::load(id, lr_relation.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::vbitfield_type lr_relation_is_live(ve::partial_contiguous_tags<lr_relation_id> id) const noexcept {
+			return ve::load(id, lr_relation.m__live.vptr());
+		}
+		DCON_RELEASE_INLINE ve::mask_vector lr_relation_is_live(ve::tagged_vector<lr_relation_id> id) const noexcept {
+			return ve::load(id, lr_relation.m__live.vptr());
+		}
+		#endif
 		
 		uint32_t lr_relation_size() const noexcept { return lr_relation.size_used; }
 
@@ -1604,6 +1633,10 @@ namespace ex1 {
 				lr_relation.m_array_left.values.resize(1 + new_size);
 			}
 			top.size_used = new_size;
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(top.pending_delete.data(), int32_t(i), false);
+			}
+			top.pending_delete.resize((new_size + 7) / 8);
 		}
 		
 		//
@@ -1613,10 +1646,122 @@ namespace ex1 {
 			top_id new_id(top_id::value_base_t(top.size_used));
 			lr_relation.m_array_left.values.emplace_back();
 			top.m_wheels.values.emplace_back();
+			top.pending_delete.resize((top.size_used + 8) / 8);
 			++top.size_used;
 			return new_id;
 		}
 		
+		//
+		// container batch create for top
+		//
+		top_id create_top_batch(uint32_t count) {
+			if(count == 0) return top_id();
+			const uint32_t first = top.size_used;
+			top_resize(first + count);
+			return top_id(top_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for top
+		//
+		void internal_move_top(top_id last_id, top_id id_removed) {
+			dcon::bit_vector_set(top.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(top.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(top.pending_delete.data(), last_id.index(), false);
+			top_for_each_lr_relation_as_left(last_id, [this, id_removed, last_id](lr_relation_id i) {
+				lr_relation.m_left.vptr()[i.index()] = id_removed;
+			} );
+			lr_relation.m_array_left.vptr()[id_removed.index()] = std::move(lr_relation.m_array_left.vptr()[last_id.index()]);
+			lr_relation.m_array_left.vptr()[last_id.index()] = std::vector<lr_relation_id>{};
+			top.m_wheels.vptr()[id_removed.index()] = std::move(top.m_wheels.vptr()[last_id.index()]);
+			top.m_wheels.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container reorder for top
+		//
+		void reorder_top(top_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = top.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<top_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = top_id(top_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == top_id(top_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = top_id(top_id::value_base_t(count));
+			lr_relation.m_array_left.values.emplace_back();
+			top.m_wheels.values.emplace_back();
+			top.pending_delete.resize((top.size_used + 8) / 8);
+			++top.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = top_id(top_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_top(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_top(scratch, dest);
+						break;
+					}
+					internal_move_top(src, dest);
+					dest = src;
+				}
+			}
+			lr_relation.m_array_left.values.pop_back();
+			top.m_wheels.values.pop_back();
+			--top.size_used;
+		}
+		template<typename F>
+		std::vector<top_id> top_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(top_id()))>;
+			std::vector<key_type> keys;
+			std::vector<top_id> result;
+			keys.reserve(top.size_used);
+			result.reserve(top.size_used);
+			for(uint32_t i = 0; i < top.size_used; ++i) {
+				auto id = top_id(top_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](top_id a, top_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<top_id> top_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = top.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = top_id(top_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return top_order_by([&](top_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container compactable delete for top
 		//
@@ -1627,8 +1772,11 @@ namespace ex1 {
 			assert(uint32_t(id.index()) < top.size_used );
 			assert(top.size_used != 0);
 			#endif
+			dcon::bit_vector_set(top.pending_delete.data(), id_removed.index(), false);
 			top_id last_id(top_id::value_base_t(top.size_used - 1));
 			if(id_removed == last_id) { pop_back_top(); return; }
+			dcon::bit_vector_set(top.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(top.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(top.pending_delete.data(), last_id.index(), false);
 			top_remove_all_lr_relation_as_left(id_removed);
 			top_for_each_lr_relation_as_left(last_id, [this, id_removed, last_id](lr_relation_id i) {
 				lr_relation.m_left.vptr()[i.index()] = id_removed;
@@ -1640,6 +1788,63 @@ namespace ex1 {
 			--top.size_used;
 		}
 		
+		//
+		// container batch delete for top
+		//
+		void delete_top_batch(top_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((top.size_used + 7) / 8);
+			std::vector<top_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!top_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			std::vector<lr_relation_id> lr_relation_dependents;
+			for(auto id : victims) {
+				top_for_each_lr_relation_as_left(id, [&](lr_relation_id r) { lr_relation_dependents.push_back(r); });
+			}
+			delete_lr_relation_batch(lr_relation_dependents.data(), uint32_t(lr_relation_dependents.size()));
+			std::sort(victims.begin(), victims.end(), [](top_id a, top_id b){ return a.value < b.value; });
+			size_t low = 0;
+			size_t high = victims.size();
+			while(low < high) {
+				top_id last_id(top_id::value_base_t(top.size_used - 1));
+				if(victims[high - 1] == last_id) {
+					delete_top(last_id);
+					--high;
+				} else {
+					delete_top(victims[low]);
+					++low;
+				}
+			}
+		}
+		
+		//
+		// container deferred delete for top
+		//
+		void queue_delete_top(top_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < top.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(top.pending_delete.data(), id.index());
+		}
+		bool top_is_pending_delete(top_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(top.pending_delete.data(), id.index());
+		}
+		void commit_deletes_top() {
+			const uint32_t count = top_size();
+			std::vector<top_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(top.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(top.pending_delete.data(), i + 1, count)) {
+				victims.push_back(top_id(top_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(top.pending_delete.begin(), top.pending_delete.end(), dcon::bitfield_type{0});
+			delete_top_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container pop_back for bottom
 		//
@@ -1678,6 +1883,114 @@ namespace ex1 {
 			return new_id;
 		}
 		
+		//
+		// container batch create for bottom
+		//
+		bottom_id create_bottom_batch(uint32_t count) {
+			if(count == 0) return bottom_id();
+			const uint32_t first = bottom.size_used;
+			bottom_resize(first + count);
+			return bottom_id(bottom_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for bottom
+		//
+		void internal_move_bottom(bottom_id last_id, bottom_id id_removed) {
+			bottom_for_each_lr_relation_as_right(last_id, [this, id_removed, last_id](lr_relation_id i) {
+				lr_relation.m_right.vptr()[i.index()] = id_removed;
+			} );
+			lr_relation.m_array_right.vptr()[id_removed.index()] = std::move(lr_relation.m_array_right.vptr()[last_id.index()]);
+			lr_relation.m_array_right.vptr()[last_id.index()] = std::vector<lr_relation_id>{};
+			bottom.m_legs.vptr()[id_removed.index()] = std::move(bottom.m_legs.vptr()[last_id.index()]);
+			bottom.m_legs.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container reorder for bottom
+		//
+		void reorder_bottom(bottom_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = bottom.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<bottom_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = bottom_id(bottom_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == bottom_id(bottom_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = bottom_id(bottom_id::value_base_t(count));
+			lr_relation.m_array_right.values.emplace_back();
+			bottom.m_legs.values.emplace_back();
+			++bottom.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = bottom_id(bottom_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_bottom(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_bottom(scratch, dest);
+						break;
+					}
+					internal_move_bottom(src, dest);
+					dest = src;
+				}
+			}
+			lr_relation.m_array_right.values.pop_back();
+			bottom.m_legs.values.pop_back();
+			--bottom.size_used;
+		}
+		template<typename F>
+		std::vector<bottom_id> bottom_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(bottom_id()))>;
+			std::vector<key_type> keys;
+			std::vector<bottom_id> result;
+			keys.reserve(bottom.size_used);
+			result.reserve(bottom.size_used);
+			for(uint32_t i = 0; i < bottom.size_used; ++i) {
+				auto id = bottom_id(bottom_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](bottom_id a, bottom_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<bottom_id> bottom_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = bottom.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = bottom_id(bottom_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return bottom_order_by([&](bottom_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container delete for lr_relation
 		//
@@ -1686,8 +1999,12 @@ namespace ex1 {
 			assert(id_removed.index() >= 0);
 			assert(lr_relation.m__index.vptr()[id_removed.index()] == id_removed);
 			#endif
+			dcon::bit_vector_set(lr_relation.pending_delete.data(), id_removed.index(), false);
+			if(lr_relation_relocations) lr_relation_relocations->erased(id_removed.index());
 			lr_relation.m__index.vptr()[id_removed.index()] = lr_relation.first_free;
 			lr_relation.first_free = id_removed;
+			dcon::bit_vector_set(lr_relation.m__live.vptr(), id_removed.index(), false);
+			--lr_relation.live_count;
 			if(int32_t(lr_relation.size_used) - 1 == id_removed.index()) {
 				for( ; lr_relation.size_used > 0 && lr_relation.m__index.vptr()[lr_relation.size_used - 1] != lr_relation_id(lr_relation_id::value_base_t(lr_relation.size_used - 1));  --lr_relation.size_used) ;
 			}
@@ -1696,6 +2013,48 @@ namespace ex1 {
 			lr_relation.m_thingies.vptr()[id_removed.index()] = int32_t{};
 		}
 		
+		//
+		// container batch delete for lr_relation
+		//
+		void delete_lr_relation_batch(lr_relation_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((lr_relation.size_used + 7) / 8);
+			std::vector<lr_relation_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!lr_relation_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			for(auto id : victims) {
+				delete_lr_relation(id);
+			}
+		}
+		
+		//
+		// container deferred delete for lr_relation
+		//
+		void queue_delete_lr_relation(lr_relation_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < lr_relation.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(lr_relation.pending_delete.data(), id.index());
+		}
+		bool lr_relation_is_pending_delete(lr_relation_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(lr_relation.pending_delete.data(), id.index());
+		}
+		void commit_deletes_lr_relation() {
+			const uint32_t count = lr_relation_size();
+			std::vector<lr_relation_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(lr_relation.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(lr_relation.pending_delete.data(), i + 1, count)) {
+				victims.push_back(lr_relation_id(lr_relation_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(lr_relation.pending_delete.begin(), lr_relation.pending_delete.end(), dcon::bitfield_type{0});
+			delete_lr_relation_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container resize for lr_relation
 		//
@@ -1733,6 +2092,83 @@ namespace ex1 {
 				lr_relation.m_right.values.resize(1 + new_size);
 			}
 			lr_relation.size_used = new_size;
+			lr_relation.m__live.values.resize(1 + (new_size + 7) / 8);
+			std::fill(lr_relation.m__live.values.begin(), lr_relation.m__live.values.end(), dcon::bitfield_type{});
+			lr_relation.live_count = 0;
+			for(uint32_t j = 0; j < new_size; ++j) {
+				if(lr_relation.m__index.vptr()[j] == lr_relation_id(lr_relation_id::value_base_t(j))) {
+					dcon::bit_vector_set(lr_relation.m__live.vptr(), int32_t(j), true);
+					++lr_relation.live_count;
+				}
+			}
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(lr_relation.pending_delete.data(), int32_t(i), false);
+			}
+			lr_relation.pending_delete.resize((new_size + 7) / 8);
+		}
+		
+		private:
+		//
+		// container move relationship for lr_relation
+		//
+		void internal_move_relationship_lr_relation(lr_relation_id last_id, lr_relation_id id_removed) {
+			dcon::bit_vector_set(lr_relation.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(lr_relation.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(lr_relation.pending_delete.data(), last_id.index(), false);
+			internal_lr_relation_set_left(id_removed, top_id());
+			if(auto tmp = lr_relation.m_left.vptr()[last_id.index()]; bool(tmp)) {
+				auto& vref = lr_relation.m_array_left.vptr()[tmp.index()];
+				if(auto pos = std::find(vref.begin(), vref.end(), last_id); pos != vref.end()) {
+					*pos = id_removed;
+				}
+			}
+			lr_relation.m_left.vptr()[id_removed.index()] = std::move(lr_relation.m_left.vptr()[last_id.index()]);
+			lr_relation.m_left.vptr()[last_id.index()] = top_id();
+			internal_lr_relation_set_right(id_removed, bottom_id());
+			if(auto tmp = lr_relation.m_right.vptr()[last_id.index()]; bool(tmp)) {
+				auto& vref = lr_relation.m_array_right.vptr()[tmp.index()];
+				if(auto pos = std::find(vref.begin(), vref.end(), last_id); pos != vref.end()) {
+					*pos = id_removed;
+				}
+			}
+			lr_relation.m_right.vptr()[id_removed.index()] = std::move(lr_relation.m_right.vptr()[last_id.index()]);
+			lr_relation.m_right.vptr()[last_id.index()] = bottom_id();
+			lr_relation.m_thingies.vptr()[id_removed.index()] = std::move(lr_relation.m_thingies.vptr()[last_id.index()]);
+			lr_relation.m_thingies.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container compaction for lr_relation
+		//
+		std::vector<lr_relation_id> compact_lr_relation() {
+			std::vector<lr_relation_id> remap(lr_relation.size_used);
+			for(uint32_t i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), 0, lr_relation.size_used); i < lr_relation.size_used; i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), i + 1, lr_relation.size_used)) {
+				remap[i] = lr_relation_id(lr_relation_id::value_base_t(i));
+			}
+			uint32_t low = 0;
+			uint32_t high = lr_relation.size_used;
+			while(true) {
+				while(low < high && dcon::bit_vector_test(lr_relation.m__live.vptr(), int32_t(low))) ++low;
+				while(high > low && !dcon::bit_vector_test(lr_relation.m__live.vptr(), int32_t(high - 1))) --high;
+				if(low >= high) break;
+				auto last_id = lr_relation_id(lr_relation_id::value_base_t(high - 1));
+				auto id_removed = lr_relation_id(lr_relation_id::value_base_t(low));
+				internal_move_relationship_lr_relation(last_id, id_removed);
+				lr_relation.m__index.vptr()[low] = id_removed;
+				dcon::bit_vector_set(lr_relation.m__live.vptr(), int32_t(low), true);
+				dcon::bit_vector_set(lr_relation.m__live.vptr(), int32_t(high - 1), false);
+				remap[high - 1] = id_removed;
+				++low;
+				--high;
+			}
+			lr_relation.size_used = lr_relation.live_count;
+			const uint32_t capacity = uint32_t(lr_relation.m__index.values.size() - 1);
+			lr_relation.first_free = lr_relation_id();
+			for(uint32_t i = capacity; i-- > lr_relation.size_used; ) {
+				lr_relation.m__index.vptr()[i] = lr_relation.first_free;
+				lr_relation.first_free = lr_relation_id(lr_relation_id::value_base_t(i));
+			}
+			return remap;
 		}
 		
 		//
@@ -1749,12 +2185,16 @@ namespace ex1 {
 				lr_relation.m_left.values.emplace_back();
 				lr_relation.m_right.values.emplace_back();
 				lr_relation.m_thingies.values.emplace_back();
+				lr_relation.m__live.values.resize(1 + (lr_relation.size_used + 8) / 8);
+				lr_relation.pending_delete.resize((lr_relation.size_used + 8) / 8);
 				++lr_relation.size_used;
 			} else {
 				lr_relation.first_free = lr_relation.m__index.vptr()[lr_relation.first_free.index()];
 				lr_relation.m__index.vptr()[new_id.index()] = new_id;
 				lr_relation.size_used = std::max(lr_relation.size_used, uint32_t(new_id.index() + 1));
 			}
+			dcon::bit_vector_set(lr_relation.m__live.vptr(), new_id.index(), true);
+			++lr_relation.live_count;
 			internal_lr_relation_set_left(new_id, left_p);
 			internal_lr_relation_set_right(new_id, right_p);
 			return new_id;
@@ -1772,17 +2212,112 @@ namespace ex1 {
 				lr_relation.m_left.values.emplace_back();
 				lr_relation.m_right.values.emplace_back();
 				lr_relation.m_thingies.values.emplace_back();
+				lr_relation.m__live.values.resize(1 + (lr_relation.size_used + 8) / 8);
+				lr_relation.pending_delete.resize((lr_relation.size_used + 8) / 8);
 				++lr_relation.size_used;
 			} else {
 				lr_relation.first_free = lr_relation.m__index.vptr()[lr_relation.first_free.index()];
 				lr_relation.m__index.vptr()[new_id.index()] = new_id;
 				lr_relation.size_used = std::max(lr_relation.size_used, uint32_t(new_id.index() + 1));
 			}
+			dcon::bit_vector_set(lr_relation.m__live.vptr(), new_id.index(), true);
+			++lr_relation.live_count;
 			internal_lr_relation_set_left(new_id, left_p);
 			internal_lr_relation_set_right(new_id, right_p);
 			return new_id;
 		}
 		
+		//
+		// container bulk create relationship for lr_relation
+		//
+		struct lr_relation_link_tuple {
+			top_id left;
+			bottom_id right;
+		};
+		uint32_t bulk_create_lr_relation(lr_relation_link_tuple const* links, uint32_t link_count, lr_relation_id* ids_out = nullptr) {
+			std::vector<uint32_t> accepted;
+			accepted.reserve(link_count);
+			for(uint32_t i = 0; i < link_count; ++i) {
+				if(ids_out) ids_out[i] = lr_relation_id();
+				auto left_p = links[i].left;
+				if(!bool(left_p)) continue;
+				auto right_p = links[i].right;
+				if(!bool(right_p)) continue;
+				accepted.push_back(i);
+			}
+			const uint32_t count = uint32_t(accepted.size());
+			if(count == 0) return 0;
+			std::vector<lr_relation_id> new_ids(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				lr_relation_id new_id = lr_relation.first_free;
+				bool expanded = !bool(lr_relation.first_free );
+				if(expanded) {
+					new_id = lr_relation_id(lr_relation_id::value_base_t(lr_relation.size_used));
+					lr_relation.m__index.values.push_back(new_id);
+					lr_relation.m_left.values.emplace_back();
+					lr_relation.m_right.values.emplace_back();
+					lr_relation.m_thingies.values.emplace_back();
+					lr_relation.m__live.values.resize(1 + (lr_relation.size_used + 8) / 8);
+					lr_relation.pending_delete.resize((lr_relation.size_used + 8) / 8);
+					++lr_relation.size_used;
+				} else {
+					lr_relation.first_free = lr_relation.m__index.vptr()[lr_relation.first_free.index()];
+					lr_relation.m__index.vptr()[new_id.index()] = new_id;
+					lr_relation.size_used = std::max(lr_relation.size_used, uint32_t(new_id.index() + 1));
+				}
+				dcon::bit_vector_set(lr_relation.m__live.vptr(), new_id.index(), true);
+				++lr_relation.live_count;
+				new_ids[k] = new_id;
+			}
+			for(uint32_t k = 0; k < count; ++k) {
+				auto const& e = links[accepted[k]];
+				auto new_id = new_ids[k];
+				lr_relation.m_left.vptr()[new_id.index()] = e.left;
+				lr_relation.m_right.vptr()[new_id.index()] = e.right;
+			}
+			 {
+				std::vector<std::pair<top_id, lr_relation_id>> pending;
+				pending.reserve(size_t(count) * 1);
+				for(uint32_t k = 0; k < count; ++k) {
+					if(auto v = lr_relation.m_left.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);
+				}
+				std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });
+				for(size_t j = 0; j < pending.size(); ) {
+					auto target = pending[j].first;
+					size_t run_end = j + 1;
+					while(run_end < pending.size() && pending[run_end].first == target) ++run_end;
+					auto& vref = lr_relation.m_array_left.vptr()[target.index()];
+					vref.reserve(vref.size() + (run_end - j));
+					for(; j < run_end; ++j) vref.push_back(pending[j].second);
+				}
+			}
+			 {
+				std::vector<std::pair<bottom_id, lr_relation_id>> pending;
+				pending.reserve(size_t(count) * 1);
+				for(uint32_t k = 0; k < count; ++k) {
+					if(auto v = lr_relation.m_right.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);
+				}
+				std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });
+				for(size_t j = 0; j < pending.size(); ) {
+					auto target = pending[j].first;
+					size_t run_end = j + 1;
+					while(run_end < pending.size() && pending[run_end].first == target) ++run_end;
+					auto& vref = lr_relation.m_array_right.vptr()[target.index()];
+					vref.reserve(vref.size() + (run_end - j));
+					for(; j < run_end; ++j) vref.push_back(pending[j].second);
+				}
+			}
+			if(ids_out) {
+				for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];
+			}
+			return count;
+		}
+		
+		void commit_deletes() {
+			commit_deletes_lr_relation();
+			commit_deletes_top();
+		}
+
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_top(T&& func) {
 			for(uint32_t i = 0; i < top.size_used; ++i) {
@@ -1790,6 +2325,31 @@ namespace ex1 {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_top(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(top.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, top_id, int32_t>)
+						func(top_id(top_id::value_base_t(i)), thread);
+					else
+						func(top_id(top_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_top(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<top_id>(top.size_used, identity, [&](top_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_top;
 		friend internal::object_iterator_top;
 		struct {
@@ -1814,6 +2374,31 @@ namespace ex1 {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_bottom(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(bottom.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, bottom_id, int32_t>)
+						func(bottom_id(bottom_id::value_base_t(i)), thread);
+					else
+						func(bottom_id(bottom_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_bottom(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<bottom_id>(bottom.size_used, identity, [&](bottom_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_bottom;
 		friend internal::object_iterator_bottom;
 		struct {
@@ -1833,11 +2418,35 @@ namespace ex1 {
 		
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_lr_relation(T&& func) {
-			for(uint32_t i = 0; i < lr_relation.size_used; ++i) {
-				lr_relation_id tmp = lr_relation_id(lr_relation_id::value_base_t(i));
-				if(lr_relation.m__index.vptr()[tmp.index()] == tmp) func(tmp);
+			for(uint32_t i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), 0, lr_relation.size_used); i < lr_relation.size_used; i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), i + 1, lr_relation.size_used)) {
+				func(lr_relation_id(lr_relation_id::value_base_t(i)));
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_lr_relation(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(lr_relation.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, lr_relation_id, int32_t>)
+						func(lr_relation_id(lr_relation_id::value_base_t(i)), thread);
+					else
+						func(lr_relation_id(lr_relation_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), first, last); i < last; i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), i + 1, last)) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_lr_relation(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<lr_relation_id>(lr_relation.size_used, identity, [&](lr_relation_id id) -> T {
+				return dcon::bit_vector_test(lr_relation.m__live.vptr(), id.index()) ? T(func(id)) : identity;
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_lr_relation;
 		friend internal::object_iterator_lr_relation;
 		struct {
@@ -1855,6 +2464,50 @@ namespace ex1 {
 			}
 		}  in_lr_relation ;
 		
+		//
+		// container link statistics for lr_relation left
+		//
+		dcon::link_statistics<top_id> lr_relation_link_stats_left() const {
+			return lr_relation_link_stats_left(std::numeric_limits<uint32_t>::max(), [](top_id, uint32_t) {});
+		}
+		template<typename F>
+		dcon::link_statistics<top_id> lr_relation_link_stats_left(uint32_t threshold, F&& on_exceeded) const {
+			dcon::link_statistics<top_id> result;
+			const uint32_t n = top_size();
+			for(uint32_t i = 0; i < n; ++i) {
+				auto owner = top_id(top_id::value_base_t(i));
+				if(!top_is_valid(owner)) continue;
+				auto& vref = lr_relation.m_array_left.vptr()[i];
+				uint32_t degree = uint32_t(vref.size());
+				result.storage_bytes += uint64_t(vref.capacity()) * sizeof(lr_relation_id);
+				result.record(owner, degree);
+				if(degree > threshold) on_exceeded(owner, degree);
+			}
+			return result;
+		}
+		
+		//
+		// container link statistics for lr_relation right
+		//
+		dcon::link_statistics<bottom_id> lr_relation_link_stats_right() const {
+			return lr_relation_link_stats_right(std::numeric_limits<uint32_t>::max(), [](bottom_id, uint32_t) {});
+		}
+		template<typename F>
+		dcon::link_statistics<bottom_id> lr_relation_link_stats_right(uint32_t threshold, F&& on_exceeded) const {
+			dcon::link_statistics<bottom_id> result;
+			const uint32_t n = bottom_size();
+			for(uint32_t i = 0; i < n; ++i) {
+				auto owner = bottom_id(bottom_id::value_base_t(i));
+				if(!bottom_is_valid(owner)) continue;
+				auto& vref = lr_relation.m_array_right.vptr()[i];
+				uint32_t degree = uint32_t(vref.size());
+				result.storage_bytes += uint64_t(vref.capacity()) * sizeof(lr_relation_id);
+				result.record(owner, degree);
+				if(degree > threshold) on_exceeded(owner, degree);
+			}
+			return result;
+		}
+		
 
 
 
@@ -1881,6 +2534,19 @@ namespace ex1 {
 			ve::execute_parallel_unaligned<top_id>(top.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_top_range(top_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<top_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<top_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<top_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, bottom_id> bottom_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, bottom_id>(bottom.size_used);
 		}
@@ -1897,6 +2563,19 @@ namespace ex1 {
 			ve::execute_parallel_unaligned<bottom_id>(bottom.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_bottom_range(bottom_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<bottom_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<bottom_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<bottom_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, lr_relation_id> lr_relation_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, lr_relation_id>(lr_relation.size_used);
 		}
@@ -1912,6 +2591,48 @@ namespace ex1 {
 		DCON_RELEASE_INLINE void execute_parallel_over_lr_relation(F&& functor) {
 			ve::execute_parallel_unaligned<lr_relation_id>(lr_relation.size_used, functor);
 		}
+#endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_lr_relation_range(lr_relation_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<lr_relation_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<lr_relation_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<lr_relation_id>(aligned_end, end - aligned_end));
+		}
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_lr_relation_live(F&& functor) {
+			const uint32_t count = lr_relation.size_used;
+			for(uint32_t i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), 0, count); i < count; i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), i, count)) {
+				i &= ~uint32_t(ve::vector_size - 1);
+				if(i + ve::vector_size <= count)
+					functor(ve::unaligned_contiguous_tags<lr_relation_id>(i));
+				else
+					functor(ve::partial_contiguous_tags<lr_relation_id>(i, count - i));
+				i += ve::vector_size;
+			}
+		}
+#ifndef VE_NO_TBB
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_parallel_over_lr_relation_live(F&& functor) {
+			const uint32_t count = lr_relation.size_used;
+			concurrency::parallel_for(uint32_t(0), (count + 63) / 64, [&](uint32_t b) {
+				const uint32_t block_end = std::min(count, b * 64 + 64);
+				for(uint32_t i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), b * 64, block_end); i < block_end; i = dcon::bit_vector_next_set(lr_relation.m__live.vptr(), i, block_end)) {
+					i &= ~uint32_t(ve::vector_size - 1);
+					if(i + ve::vector_size <= count)
+						functor(ve::unaligned_contiguous_tags<lr_relation_id>(i));
+					else
+						functor(ve::partial_contiguous_tags<lr_relation_id>(i, count - i));
+					i += ve::vector_size;
+				}
+			});
+		}
 #endif
 		#endif
 
@@ -2222,6 +2943,15 @@ namespace ex1 {
 								} else {
 								}
 							}
+							lr_relation.m__live.values.resize(1 + (lr_relation.size_used + 7) / 8);
+							std::fill(lr_relation.m__live.values.begin(), lr_relation.m__live.values.end(), dcon::bitfield_type{});
+							lr_relation.live_count = 0;
+							for(uint32_t j = 0; j < lr_relation.size_used; ++j) {
+								if(lr_relation.m__index.vptr()[j] == lr_relation_id(lr_relation_id::value_base_t(j))) {
+									dcon::bit_vector_set(lr_relation.m__live.vptr(), int32_t(j), true);
+									++lr_relation.live_count;
+								}
+							}
 						}
 						return;
 					}
@@ -2654,40 +3384,32 @@ namespace ex1 {
 		DCON_RELEASE_INLINE object_term_iterator_lr_relation::object_term_iterator_lr_relation(uint32_t i) noexcept : index(i) {
 		}
 		DCON_RELEASE_INLINE object_iterator_lr_relation::object_iterator_lr_relation(data_container& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.lr_relation.m__live.vptr(), index, container.lr_relation.size_used);
 		}
 		DCON_RELEASE_INLINE const_object_iterator_lr_relation::const_object_iterator_lr_relation(data_container const& c, uint32_t i) noexcept : container(c), index(i) {
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.lr_relation.m__live.vptr(), index, container.lr_relation.size_used);
 		}
 		DCON_RELEASE_INLINE object_iterator_lr_relation& object_iterator_lr_relation::operator++() noexcept {
 			++index;
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.lr_relation.m__live.vptr(), index, container.lr_relation.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_lr_relation& const_object_iterator_lr_relation::operator++() noexcept {
 			++index;
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				++index;
-			}
+			index = dcon::bit_vector_next_set(container.lr_relation.m__live.vptr(), index, container.lr_relation.size_used);
 			return *this;
 		}
 		DCON_RELEASE_INLINE object_iterator_lr_relation& object_iterator_lr_relation::operator--() noexcept {
 			--index;
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				--index;
+			if(index < container.lr_relation.size_used) {
+				index = dcon::bit_vector_prev_set(container.lr_relation.m__live.vptr(), index);
 			}
 			return *this;
 		}
 		DCON_RELEASE_INLINE const_object_iterator_lr_relation& const_object_iterator_lr_relation::operator--() noexcept {
 			--index;
-			while(container.lr_relation.m__index.vptr()[index] != lr_relation_id(lr_relation_id::value_base_t(index)) && index < container.lr_relation.size_used) {
-				--index;
+			if(index < container.lr_relation.size_used) {
+				index = dcon::bit_vector_prev_set(container.lr_relation.m__live.vptr(), index);
 			}
 			return *this;
 		}
@@ -2695,6 +3417,172 @@ namespace ex1 {
 	};
 
 
+	//
+	// command buffer
+	//
+	class command_buffer {
+		public:
+		class alignas(64) recorder {
+			friend class command_buffer;
+			dcon::command_arena commands;
+			uint32_t top_created = 0;
+			uint32_t bottom_created = 0;
+			public:
+			dcon::deferred_id<top_id> create_top() {
+				commands.write(uint16_t(0));
+				return dcon::deferred_id<top_id>::make_placeholder(top_created++);
+			}
+			void delete_top(dcon::deferred_id<top_id> id) {
+				commands.write(uint16_t(1));
+				commands.write(id);
+			}
+			void top_set_wheels(dcon::deferred_id<top_id> id, int32_t value) {
+				commands.write(uint16_t(2));
+				commands.write(id);
+				commands.write(value);
+			}
+			dcon::deferred_id<bottom_id> create_bottom() {
+				commands.write(uint16_t(3));
+				return dcon::deferred_id<bottom_id>::make_placeholder(bottom_created++);
+			}
+			void bottom_set_legs(dcon::deferred_id<bottom_id> id, int32_t value) {
+				commands.write(uint16_t(4));
+				commands.write(id);
+				commands.write(value);
+			}
+			void delete_lr_relation(lr_relation_id id) {
+				commands.write(uint16_t(5));
+				commands.write(id);
+			}
+			void lr_relation_set_thingies(lr_relation_id id, int32_t value) {
+				commands.write(uint16_t(6));
+				commands.write(id);
+				commands.write(value);
+			}
+			void try_create_lr_relation(dcon::deferred_id<top_id> left_p, dcon::deferred_id<bottom_id> right_p) {
+				commands.write(uint16_t(7));
+				commands.write(left_p);
+				commands.write(right_p);
+			}
+			void force_create_lr_relation(dcon::deferred_id<top_id> left_p, dcon::deferred_id<bottom_id> right_p) {
+				commands.write(uint16_t(8));
+				commands.write(left_p);
+				commands.write(right_p);
+			}
+			void lr_relation_set_left(lr_relation_id id, dcon::deferred_id<top_id> value) {
+				commands.write(uint16_t(9));
+				commands.write(id);
+				commands.write(value);
+			}
+			void lr_relation_set_right(lr_relation_id id, dcon::deferred_id<bottom_id> value) {
+				commands.write(uint16_t(10));
+				commands.write(id);
+				commands.write(value);
+			}
+		};
+		private:
+		std::vector<recorder> recorders;
+		public:
+		explicit command_buffer(uint32_t thread_count) : recorders(thread_count) { }
+		recorder& for_thread(uint32_t thread_index) noexcept {
+			return recorders[thread_index];
+		}
+		void clear() noexcept {
+			for(auto& rec : recorders) {
+				rec.commands.clear();
+				rec.top_created = 0;
+				rec.bottom_created = 0;
+			}
+		}
+		void playback(data_container& dc) {
+			std::vector<uint32_t> top_offsets(recorders.size());
+			uint32_t top_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				top_offsets[r] = top_total;
+				top_total += recorders[r].top_created;
+			}
+			top_id top_first = top_total != 0 ? dc.create_top_batch(top_total) : top_id();
+			auto resolve_top = [&](size_t r, dcon::deferred_id<top_id> d) {
+				return d.placeholder == 0 ? d.id : top_id(top_id::value_base_t(top_first.index() + top_offsets[r] + d.placeholder - 1));
+			} ;
+			std::vector<uint32_t> bottom_offsets(recorders.size());
+			uint32_t bottom_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				bottom_offsets[r] = bottom_total;
+				bottom_total += recorders[r].bottom_created;
+			}
+			bottom_id bottom_first = bottom_total != 0 ? dc.create_bottom_batch(bottom_total) : bottom_id();
+			auto resolve_bottom = [&](size_t r, dcon::deferred_id<bottom_id> d) {
+				return d.placeholder == 0 ? d.id : bottom_id(bottom_id::value_base_t(bottom_first.index() + bottom_offsets[r] + d.placeholder - 1));
+			} ;
+			dcon::relocation_tracker lr_relation_moves(dc.lr_relation_relocations, dc.lr_relation_size());
+			auto relocate_lr_relation = [&](lr_relation_id id) {
+				auto const index = lr_relation_moves.current(id.index());
+				return index >= 0 ? lr_relation_id(lr_relation_id::value_base_t(index)) : lr_relation_id();
+			} ;
+			std::vector<top_id> top_deletes;
+			std::vector<lr_relation_id> lr_relation_deletes;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				auto const& commands = recorders[r].commands;
+				size_t pos = 0;
+				while(pos < commands.size()) {
+					switch(commands.read<uint16_t>(pos)) {
+						case 0:
+							break;
+						case 1:
+							top_deletes.push_back(resolve_top(r, commands.read<dcon::deferred_id<top_id>>(pos)));
+							break;
+						case 2: {
+							auto id = resolve_top(r, commands.read<dcon::deferred_id<top_id>>(pos));
+							dc.top_set_wheels(id, commands.read<int32_t>(pos));
+						} break;
+						case 3:
+							break;
+						case 4: {
+							auto id = resolve_bottom(r, commands.read<dcon::deferred_id<bottom_id>>(pos));
+							dc.bottom_set_legs(id, commands.read<int32_t>(pos));
+						} break;
+						case 5:
+							lr_relation_deletes.push_back(commands.read<lr_relation_id>(pos));
+							break;
+						case 6: {
+							auto id = relocate_lr_relation(commands.read<lr_relation_id>(pos));
+							auto value = commands.read<int32_t>(pos);
+							if(bool(id)) dc.lr_relation_set_thingies(id, value);
+						} break;
+						case 7: {
+							auto left_p = resolve_top(r, commands.read<dcon::deferred_id<top_id>>(pos));
+							auto right_p = resolve_bottom(r, commands.read<dcon::deferred_id<bottom_id>>(pos));
+							dc.try_create_lr_relation(left_p, right_p);
+						} break;
+						case 8: {
+							auto left_p = resolve_top(r, commands.read<dcon::deferred_id<top_id>>(pos));
+							auto right_p = resolve_bottom(r, commands.read<dcon::deferred_id<bottom_id>>(pos));
+							dc.force_create_lr_relation(left_p, right_p);
+						} break;
+						case 9: {
+							auto id = relocate_lr_relation(commands.read<lr_relation_id>(pos));
+							auto value = resolve_top(r, commands.read<dcon::deferred_id<top_id>>(pos));
+							if(bool(id)) dc.lr_relation_set_left(id, value);
+						} break;
+						case 10: {
+							auto id = relocate_lr_relation(commands.read<lr_relation_id>(pos));
+							auto value = resolve_bottom(r, commands.read<dcon::deferred_id<bottom_id>>(pos));
+							if(bool(id)) dc.lr_relation_set_right(id, value);
+						} break;
+					}
+				}
+			}
+			for(auto& id : lr_relation_deletes) {
+				id = relocate_lr_relation(id);
+			}
+			lr_relation_deletes.erase(std::remove_if(lr_relation_deletes.begin(), lr_relation_deletes.end(), [](lr_relation_id id) { return !bool(id); }), lr_relation_deletes.end());
+			dc.delete_lr_relation_batch(lr_relation_deletes.data(), uint32_t(lr_relation_deletes.size()));
+			dc.delete_top_batch(top_deletes.data(), uint32_t(top_deletes.size()));
+			clear();
+		}
+	};
+	
 }
 
 #undef DCON_RELEASE_INLINE
@@ -4,6 +4,7 @@
 #include "common_types.hpp"
 #include "ecs.hpp"
 #include "common_types.cpp"
+#include <atomic>
 
 void dcon::data_container::on_delete_entity(entity_id e) {
 	if (auto c = entity_get_position_component(e); bool(c)) {
@@ -14,6 +15,67 @@ void dcon::data_container::on_delete_entity(entity_id e) {
 	}
 }
 
+std::atomic<int32_t> system_clock = 0;
+std::atomic<int32_t> system_started[6];
+std::atomic<int32_t> system_finished[6];
+int32_t visible_count = 0;
+int32_t linked_count = 0;
+
+void dcon::data_container::system_spin() {
+	system_started[0] = ++system_clock;
+	for(uint32_t i = 0; i < position_size(); ++i) {
+		auto p = position_id(position_id::value_base_t(i));
+		if(position_is_valid(p))
+			position_set_rotation(p, position_get_rotation(p) + 1.0f);
+	}
+	system_finished[0] = ++system_clock;
+}
+void dcon::data_container::system_drift() {
+	system_started[1] = ++system_clock;
+	execute_parallel_over_position([&](auto ids) {
+		position_set_x(ids, position_get_x(ids) + 0.5f);
+		position_set_y(ids, position_get_y(ids) - 0.5f);
+	});
+	system_finished[1] = ++system_clock;
+}
+void dcon::data_container::system_animate() {
+	system_started[2] = ++system_clock;
+	for(uint32_t i = 0; i < sprite_size(); ++i) {
+		auto s = sprite_id(sprite_id::value_base_t(i));
+		if(sprite_is_valid(s))
+			sprite_set_sprite_id(s, uint16_t(sprite_get_sprite_id(s) + 10));
+	}
+	system_finished[2] = ++system_clock;
+}
+void dcon::data_container::system_count_visible() {
+	system_started[3] = ++system_clock;
+	visible_count = 0;
+	for(auto& q : query_sprites_with_position()) {
+		if(q.get_position().get_rotation() > 0.0f)
+			++visible_count;
+	}
+	system_finished[3] = ++system_clock;
+}
+void dcon::data_container::system_cull_sprites() {
+	system_started[4] = ++system_clock;
+	for(uint32_t i = sprite_size(); i-- > 0; ) {
+		auto s = sprite_id(sprite_id::value_base_t(i));
+		if(sprite_is_valid(s) && sprite_get_sprite_id(s) == uint16_t(0))
+			delete_sprite(s);
+	}
+	system_finished[4] = ++system_clock;
+}
+void dcon::data_container::system_count_linked() {
+	system_started[5] = ++system_clock;
+	linked_count = 0;
+	for(uint32_t i = 0; i < entity_size(); ++i) {
+		auto e = entity_id(entity_id::value_base_t(i));
+		if(entity_is_valid(e) && bool(entity_get_sprite_component(e)))
+			++linked_count;
+	}
+	system_finished[5] = ++system_clock;
+}
+
 dcon::entity_id make_entity(dcon::data_container& dc) {
 	return dc.try_create_entity(dcon::position_id(), dcon::sprite_id());
 }
@@ -125,3 +187,59 @@ TEST_CASE("iteration test", "[ecs_tutorial_tests]") {
 	REQUIRE(count == 3);
 
 }
+
+TEST_CASE("system schedule", "[ecs_tutorial_tests]") {
+	REQUIRE(dcon::data_container::system_count == 6);
+	REQUIRE(std::string(dcon::data_container::system_names[2]) == "animate");
+	REQUIRE(dcon::data_container::system_levels[0] == 0);
+	REQUIRE(dcon::data_container::system_levels[1] == 0);
+	REQUIRE(dcon::data_container::system_levels[2] == 1);
+	REQUIRE(dcon::data_container::system_levels[3] == 2);
+	REQUIRE(dcon::data_container::system_levels[4] == 3);
+	// writing all of sprite also writes the entity relationship that links to it
+	REQUIRE(dcon::data_container::system_levels[5] == 4);
+	// each system waits on exactly the earlier systems it conflicts with, not on everything in the level before it
+	REQUIRE(dcon::data_container::system_predecessor_counts[2] == 1);
+	REQUIRE(dcon::data_container::system_predecessor_counts[3] == 3);
+	REQUIRE(dcon::data_container::system_roots.size() == 2);
+	REQUIRE(dcon::data_container::system_successor_start[1] - dcon::data_container::system_successor_start[0] == 2);
+	REQUIRE(dcon::data_container::system_successor_start[2] - dcon::data_container::system_successor_start[1] == 1);
+
+	auto ptr = std::make_unique<dcon::data_container>();
+
+	for(int32_t i = 0; i < 100; ++i) {
+		auto e = make_entity(*ptr);
+		auto p = ptr->create_position();
+		ptr->position_set_x(p, float(i));
+		ptr->entity_set_position_component(e, p);
+		if(i % 4 != 0) {
+			auto s = ptr->create_sprite();
+			ptr->sprite_set_sprite_id(s, uint16_t(i));
+			ptr->entity_set_sprite_component(e, s);
+		}
+	}
+
+	ptr->run_systems();
+
+	// conflicting systems run in the order they were declared
+	REQUIRE(system_started[2] > system_finished[0]);
+	REQUIRE(system_started[3] > system_finished[1]);
+	REQUIRE(system_started[3] > system_finished[2]);
+	REQUIRE(system_started[5] > system_finished[4]);
+
+	REQUIRE(visible_count == 75);
+	REQUIRE(linked_count == 75);
+	for(int32_t i = 0; i < 100; ++i) {
+		auto p = dcon::position_id(dcon::position_id::value_base_t(i));
+		REQUIRE(ptr->position_get_rotation(p) == 1.0f);
+		REQUIRE(ptr->position_get_x(p) == float(i) + 0.5f);
+	}
+
+	ptr->run_systems_serial();
+	REQUIRE(system_started[1] > system_finished[0]);
+	REQUIRE(system_started[2] > system_finished[1]);
+	for(uint32_t i = 0; i < ptr->sprite_size(); ++i) {
+		auto s = dcon::sprite_id(dcon::sprite_id::value_base_t(i));
+		REQUIRE(ptr->sprite_get_sprite_id(s) >= uint16_t(20));
+	}
+}
@@ -3,6 +3,10 @@
 #define DCON_TRAP_INVALID_STORE
 
 #include "catch.hpp"
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <tuple>
 #include "common_types.hpp"
 #include "common_types.cpp"
 
@@ -21,6 +25,22 @@ void dcon::data_container::on_delete_thingy(thingy_id) {
 void dcon::data_container::on_move_thingy(thingy_id, thingy_id) {
 	++counter;
 }
+void dcon::data_container::on_create_thingy2_batch(thingy2_id, uint32_t count) {
+	counter += int32_t(count);
+}
+void dcon::data_container::on_create_pooled_thingy_batch(pooled_thingy_id const*, uint32_t count) {
+	counter += int32_t(count);
+}
+void dcon::data_container::on_delete_claimant(claimant_id) {
+	++counter;
+}
+void dcon::data_container::on_delete_claimant_batch(claimant_id const*, uint32_t count) {
+	counter += 100 * int32_t(count);
+}
+void dcon::data_container::on_delete_stake_batch(stake_id const*, uint32_t count) {
+	counter += 10000;
+	stakes_deleted += int32_t(count);
+}
 
 int32_t dcon::data_container::thingy_get_d_value(thingy_id) const {
 	return 6;
@@ -73,6 +93,736 @@ TEST_CASE("hooked_functions", "[objects_and_properties_tests]") {
 	REQUIRE(ptr->counter == 1);
 }
 
+TEST_CASE("batch deletion", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 6; ++i)
+		ptr->thingy_set_some_value(ptr->create_thingy(), i);
+	ptr->counter = 0;
+
+	std::vector<dcon::thingy_id> to_delete{ dcon::thingy_id(1), dcon::thingy_id(5), dcon::thingy_id(3), dcon::thingy_id(1), dcon::thingy_id(4), dcon::thingy_id(100) };
+	ptr->delete_thingy_batch(to_delete.data(), uint32_t(to_delete.size()));
+
+	// four deletions and a single move of the surviving element 2 into slot 1
+	REQUIRE(ptr->counter == 5);
+	REQUIRE(ptr->thingy_size() == 2);
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(0)) == 0);
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(1)) == 2);
+
+	ptr->counter = 0;
+	std::array<dcon::thingy_id, 2> rest{ dcon::thingy_id(0), dcon::thingy_id(1) };
+	ptr->delete_thingy_batch(rest.data(), uint32_t(rest.size()));
+	REQUIRE(ptr->counter == 2);
+	REQUIRE(ptr->thingy_size() == 0);
+}
+
+TEST_CASE("batch deletion cascade", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::vector<dcon::claimant_id> owners;
+	for(int32_t i = 0; i < 4; ++i)
+		owners.push_back(ptr->create_claimant());
+	for(int32_t i = 0; i < 12; ++i)
+		ptr->stake_set_amount(ptr->force_create_stake(owners[i % 4]), i);
+
+	std::array<dcon::claimant_id, 4> victims{ owners[0], owners[2], owners[0], dcon::claimant_id() };
+	ptr->delete_claimant_batch(victims.data(), uint32_t(victims.size()));
+
+	// one call to each batch hook, and none to the per-instance hook
+	REQUIRE(ptr->counter == 10000 + 200);
+	REQUIRE(ptr->stakes_deleted == 6);
+	REQUIRE(ptr->stake_size() == 6);
+	REQUIRE(!ptr->claimant_is_valid(owners[0]));
+	REQUIRE(ptr->claimant_is_valid(owners[1]));
+	REQUIRE(ptr->claimant_range_of_stake(owners[1]).second - ptr->claimant_range_of_stake(owners[1]).first == 3);
+	for(uint32_t i = 0; i < ptr->stake_size(); ++i) {
+		auto c = dcon::stake_id(dcon::stake_id::value_base_t(i));
+		auto o = ptr->stake_get_holder(c);
+		REQUIRE((o == owners[1] || o == owners[3]));
+		REQUIRE(ptr->stake_get_amount(c) % 4 == (o == owners[1] ? 1 : 3));
+	}
+
+	// deleting a single instance still calls the per-instance hook
+	ptr->counter = 0;
+	ptr->delete_claimant(owners[1]);
+	REQUIRE(ptr->counter == 1);
+	REQUIRE(ptr->stake_size() == 3);
+}
+
+TEST_CASE("batch creation", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	ptr->create_thingy();
+	auto first = ptr->create_thingy_batch(10);
+	REQUIRE(first == dcon::thingy_id(1));
+	REQUIRE(ptr->thingy_size() == 11);
+	REQUIRE(ptr->counter == 11); // without a batch hook, on_create runs once per instance
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(10)) == 0);
+	REQUIRE(ptr->create_thingy_batch(0) == dcon::thingy_id());
+
+	ptr->execute_serial_over_thingy_range(first, 10, [&](auto ids) {
+		ptr->thingy_set_some_value(ids, 7);
+	});
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(0)) == 0);
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(1)) == 7);
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(10)) == 7);
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(11)) == 0);
+
+	ptr->counter = 0;
+	auto efirst = ptr->create_thingy2_batch(40);
+	REQUIRE(efirst == dcon::thingy2_id(0));
+	REQUIRE(ptr->thingy2_size() == 40);
+	REQUIRE(ptr->counter == 40);
+	REQUIRE(ptr->thingy2_get_pooled_v(dcon::thingy2_id(39)).size() == 0);
+
+	ptr->counter = 0;
+	auto a = ptr->create_pooled_thingy();
+	auto b = ptr->create_pooled_thingy();
+	ptr->create_pooled_thingy();
+	ptr->pooled_thingy_set_some_value(b, 5);
+	ptr->delete_pooled_thingy(a);
+	ptr->delete_pooled_thingy(b);
+
+	std::array<dcon::pooled_thingy_id, 4> out;
+	ptr->create_pooled_thingy_batch(out.data(), uint32_t(out.size()));
+	REQUIRE(ptr->counter == 4);
+	REQUIRE(ptr->pooled_thingy_size() == 5);
+	REQUIRE(std::count(out.begin(), out.end(), a) == 1);
+	REQUIRE(std::count(out.begin(), out.end(), b) == 1);
+	REQUIRE(ptr->pooled_thingy_get_some_value(b) == 0);
+	for(auto id : out)
+		REQUIRE(ptr->pooled_thingy_is_valid(id));
+}
+
+TEST_CASE("concurrent creation", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	ptr->create_thingy2_batch(5);
+	ptr->counter = 0;
+
+	// four threads each create 500 instances, which leaves a partly used slab behind for each of them
+	ptr->begin_concurrent_create_thingy2(3000, 4);
+	std::vector<std::thread> workers;
+	for(uint32_t t = 0; t < 4; ++t) {
+		workers.emplace_back([&, t]() {
+			for(int32_t k = 0; k < 500; ++k) {
+				auto id = ptr->create_thingy2_concurrent(t);
+				ptr->thingy2_set_some_value(id, int32_t(t) * 1000 + k + 1);
+			}
+		});
+	}
+	for(auto& w : workers)
+		w.join();
+	REQUIRE(ptr->counter == 0);
+
+	auto remap = ptr->merge_thingy2_creations();
+	REQUIRE(remap.size() == 3000);
+	REQUIRE(ptr->thingy2_size() == 2005);
+	REQUIRE(ptr->counter == 2000);
+
+	std::vector<int32_t> seen;
+	for(uint32_t i = 0; i < 2005; ++i)
+		seen.push_back(ptr->thingy2_get_some_value(dcon::thingy2_id(dcon::thingy2_id::value_base_t(i))));
+	std::sort(seen.begin(), seen.end());
+	std::vector<int32_t> expected(5, 0);
+	for(int32_t t = 0; t < 4; ++t) {
+		for(int32_t k = 0; k < 500; ++k)
+			expected.push_back(t * 1000 + k + 1);
+	}
+	REQUIRE(seen == expected);
+
+	int32_t mapped = 0;
+	for(uint32_t p = 0; p < remap.size(); ++p) {
+		if(bool(remap[p])) {
+			++mapped;
+			REQUIRE(remap[p].index() >= 5);
+			REQUIRE(remap[p].index() < 2005);
+		}
+	}
+	REQUIRE(mapped == 2000);
+
+	// erasable objects hand out free slots first
+	ptr->counter = 0;
+	for(int32_t i = 0; i < 6; ++i)
+		ptr->create_pooled_thingy();
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(1));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(4));
+	ptr->counter = 0;
+
+	ptr->begin_concurrent_create_pooled_thingy(8, 2);
+	auto a = ptr->create_pooled_thingy_concurrent(0);
+	auto b = ptr->create_pooled_thingy_concurrent(1);
+	auto c = ptr->create_pooled_thingy_concurrent(0);
+	ptr->pooled_thingy_set_some_value(b, 9);
+	REQUIRE(a == dcon::pooled_thingy_id(4));
+	REQUIRE(b == dcon::pooled_thingy_id(1));
+	REQUIRE(c == dcon::pooled_thingy_id(6));
+
+	auto pooled_remap = ptr->merge_pooled_thingy_creations();
+	REQUIRE(pooled_remap.size() == 8);
+	REQUIRE(pooled_remap[1] == b);
+	REQUIRE(!bool(pooled_remap[3]));
+	REQUIRE(ptr->counter == 3);
+	REQUIRE(ptr->pooled_thingy_live_count() == 7);
+	// the unclaimed slots at the end are given back
+	REQUIRE(ptr->pooled_thingy_size() == 7);
+	REQUIRE(ptr->pooled_thingy_is_valid(c));
+	REQUIRE(!ptr->pooled_thingy_is_valid(dcon::pooled_thingy_id(7)));
+	REQUIRE(ptr->pooled_thingy_get_some_value(b) == 9);
+	REQUIRE(ptr->create_pooled_thingy() == dcon::pooled_thingy_id(7));
+	REQUIRE(ptr->pooled_thingy_size() == 8);
+
+	// merging when nothing was begun does nothing
+	ptr->merge_creations();
+	REQUIRE(ptr->thingy2_size() == 2005);
+}
+
+TEST_CASE("live slot tracking", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 10; ++i)
+		ptr->create_pooled_thingy();
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(1));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(2));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(3));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(7));
+	REQUIRE(ptr->pooled_thingy_live_count() == 6);
+
+	std::vector<int32_t> visited;
+	ptr->for_each_pooled_thingy([&](dcon::pooled_thingy_id id) { visited.push_back(id.index()); });
+	REQUIRE(visited == std::vector<int32_t>{ 0, 4, 5, 6, 8, 9 });
+
+	std::vector<int32_t> iterated;
+	for(auto id : ptr->in_pooled_thingy)
+		iterated.push_back(id.id.index());
+	REQUIRE(iterated == visited);
+
+	ptr->execute_serial_over_pooled_thingy_live([&](auto ids) {
+		ptr->pooled_thingy_set_some_value(ids, ve::select(ve::mask_vector(ptr->pooled_thingy_is_live(ids)), ve::int_vector(1), ve::int_vector(0)));
+	});
+	int32_t total = 0;
+	for(int32_t i = 0; i < 10; ++i)
+		total += ptr->pooled_thingy_get_some_value(dcon::pooled_thingy_id(dcon::pooled_thingy_id::value_base_t(i)));
+	REQUIRE(total == 6);
+
+	ptr->pooled_thingy_resize(5);
+	REQUIRE(ptr->pooled_thingy_live_count() == 2);
+	REQUIRE(ptr->pooled_thingy_size() == 5);
+	auto n = ptr->create_pooled_thingy();
+	REQUIRE(n == dcon::pooled_thingy_id(1));
+	REQUIRE(ptr->pooled_thingy_live_count() == 3);
+}
+
+TEST_CASE("parallel for_each", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 1000; ++i)
+		ptr->thingy_set_some_value(ptr->create_thingy(), i);
+
+	std::vector<std::atomic<int32_t>> visits(1000);
+	ptr->parallel_for_each_thingy([&](dcon::thingy_id id) {
+		visits[id.index()].fetch_add(1, std::memory_order_relaxed);
+	}, 16);
+	for(auto& v : visits)
+		REQUIRE(v.load() == 1);
+
+	// per thread partial sums, indexed by the thread index
+	std::vector<int64_t> partial_sums(ve::thread_count());
+	ptr->parallel_for_each_thingy([&](dcon::thingy_id id, int32_t thread) {
+		partial_sums[thread] += ptr->thingy_get_some_value(id);
+	}, 64, ve::partitioning::static_shares);
+	int64_t total = 0;
+	for(auto v : partial_sums)
+		total += v;
+	REQUIRE(total == int64_t(999) * 1000 / 2);
+
+	for(int32_t i = 0; i < 12; ++i)
+		ptr->pooled_thingy_set_some_value(ptr->create_pooled_thingy(), i);
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(0));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(5));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(11));
+
+	std::atomic<int32_t> pooled_total = 0;
+	std::atomic<int32_t> pooled_count = 0;
+	ptr->parallel_for_each_pooled_thingy([&](dcon::pooled_thingy_id id) {
+		pooled_total += ptr->pooled_thingy_get_some_value(id);
+		++pooled_count;
+	}, 3);
+	REQUIRE(pooled_count == 9);
+	REQUIRE(pooled_total == 66 - 16);
+}
+
+TEST_CASE("deterministic reductions", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 5000; ++i)
+		ptr->thingy2_set_some_value(ptr->create_thingy2(), (i * 7919) % 5003);
+
+	// values of very different magnitudes, so that a different order of addition would give a different sum
+	auto value = [&](dcon::thingy2_id id) {
+		auto v = ptr->thingy2_get_some_value(id);
+		return (v % 2 == 0 ? 1.0e6f : 1.0e-3f) / float(1 + v);
+	};
+
+	// the same chunks and tree, computed serially
+	std::vector<float> partials;
+	for(uint32_t first = 0; first < 5000; first += ve::reduction_chunk_size) {
+		float acc = 0.0f;
+		for(uint32_t i = first; i < std::min(first + ve::reduction_chunk_size, uint32_t(5000)); ++i)
+			acc = acc + value(dcon::thingy2_id(dcon::thingy2_id::value_base_t(i)));
+		partials.push_back(acc);
+	}
+	for(size_t width = 1; width < partials.size(); width *= 2) {
+		for(size_t i = 0; i + width < partials.size(); i += width * 2)
+			partials[i] = partials[i] + partials[i + width];
+	}
+	auto const expected = partials[0];
+
+	auto plus = [](float a, float b) { return a + b; };
+#ifdef VE_BUILTIN_POOL
+	for(uint32_t workers : { 1u, 3u, 8u }) {
+		ve::thread_pool::set_worker_count(workers);
+#else
+	for(int32_t rep = 0; rep < 3; ++rep) {
+#endif
+		REQUIRE(ptr->reduce_over_thingy2(0.0f, value, plus) == expected);
+		REQUIRE(ve::reduce_sum<dcon::thingy2_id>(ptr->thingy2_size(), value) == expected);
+	}
+	REQUIRE(ve::reduce_min<dcon::thingy2_id>(ptr->thingy2_size(), [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id); }) == 0);
+	REQUIRE(ve::reduce_max<dcon::thingy2_id>(ptr->thingy2_size(), [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id); }) > 4900);
+	REQUIRE(ve::reduce_max<dcon::thingy2_id>(0, [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id); }) == std::numeric_limits<int32_t>::lowest());
+	// bool partial results must not share storage between chunks
+	auto any_of = [](bool a, bool b) { return a || b; };
+	auto all_of = [](bool a, bool b) { return a && b; };
+	REQUIRE(ve::reduce_custom<dcon::thingy2_id>(ptr->thingy2_size(), false, [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id) > 4900; }, any_of));
+	REQUIRE(!ve::reduce_custom<dcon::thingy2_id>(ptr->thingy2_size(), false, [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id) < 0; }, any_of));
+	REQUIRE(ve::reduce_custom<dcon::thingy2_id>(ptr->thingy2_size(), true, [&](dcon::thingy2_id id) { return ptr->thingy2_get_some_value(id) >= 0; }, all_of));
+
+	for(int32_t i = 0; i < 12; ++i)
+		ptr->pooled_thingy_set_some_value(ptr->create_pooled_thingy(), i);
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(11));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(4));
+
+	auto max_value = ptr->reduce_over_pooled_thingy(int32_t(-1), [&](dcon::pooled_thingy_id id) { return ptr->pooled_thingy_get_some_value(id); },
+		[](int32_t a, int32_t b) { return std::max(a, b); });
+	REQUIRE(max_value == 10);
+	auto total = ptr->reduce_over_pooled_thingy(int32_t(0), [&](dcon::pooled_thingy_id id) { return ptr->pooled_thingy_get_some_value(id); },
+		[](int32_t a, int32_t b) { return a + b; });
+	REQUIRE(total == 66 - 15);
+}
+
+TEST_CASE("atomic properties", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 1000; ++i)
+		ptr->create_thingy();
+
+	// every instance scatters into the instances of the same residue mod 10
+	ptr->parallel_for_each_thingy([&](dcon::thingy_id id) {
+		auto target = dcon::thingy_id(dcon::thingy_id::value_base_t(id.index() % 10));
+		ptr->thingy_fetch_add_damage(target, 2);
+		ptr->thingy_fetch_add_income(target, 0.5f);
+		ptr->thingy_fetch_add_votes(target, int64_t(1) << 33);
+		ptr->thingy_atomic_max_damage(dcon::thingy_id(dcon::thingy_id::value_base_t(999 - id.index() % 10)), id.index());
+	}, 16);
+
+	for(int32_t i = 0; i < 10; ++i) {
+		auto t = dcon::thingy_id(dcon::thingy_id::value_base_t(i));
+		REQUIRE(ptr->thingy_get_damage(t) == 200);
+		REQUIRE(ptr->thingy_get_income(t) == 50.0f);
+		REQUIRE(ptr->thingy_get_votes(t) == (int64_t(100) << 33));
+		REQUIRE(ptr->thingy_get_damage(dcon::thingy_id(dcon::thingy_id::value_base_t(999 - i))) == 990 + i);
+	}
+	REQUIRE(ptr->thingy_get_damage(dcon::thingy_id(10)) == 0);
+
+	auto fat = fatten(*ptr, dcon::thingy_id(3));
+	int32_t expected = 200;
+	REQUIRE(fat.compare_exchange_damage(expected, 7) == true);
+	expected = 200;
+	REQUIRE(fat.compare_exchange_damage(expected, 9) == false);
+	REQUIRE(expected == 7);
+	REQUIRE(fat.atomic_max_damage(5) == 7);
+	REQUIRE(fat.fetch_add_damage(1) == 7);
+	REQUIRE(fat.get_damage() == 8);
+
+#ifndef DCON_NO_VE
+	// the column is still an ordinary array of values for vector access
+	ve::execute_serial_fast<dcon::thingy_id>(16, [&](auto ids) {
+		ptr->thingy_set_damage(ids, ptr->thingy_get_damage(ids) + 1);
+	});
+	REQUIRE(ptr->thingy_get_damage(dcon::thingy_id(3)) == 9);
+	REQUIRE(ptr->thingy_get_damage(dcon::thingy_id(12)) == 1);
+#endif
+}
+
+TEST_CASE("consistent reads", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 100; ++i)
+		ptr->create_transform();
+
+	// the writer keeps y == 2x and z == 3x, but only as a group of three separate stores
+	std::atomic<bool> done{ false };
+	std::thread writer([&]() {
+		for(int32_t k = 1; k <= 2000; ++k) {
+			for(int32_t i = 0; i < 100; ++i) {
+				ptr->transform_write_consistent(dcon::transform_id(dcon::transform_id::value_base_t(i)), [&](dcon::transform_id id) {
+					ptr->transform_set_x(id, float(k));
+					ptr->transform_set_y(id, float(2 * k));
+					ptr->transform_set_z(id, float(3 * k));
+				});
+			}
+		}
+		done.store(true, std::memory_order_release);
+	});
+
+	int32_t torn = 0;
+	int32_t reads = 0;
+	while(!done.load(std::memory_order_acquire) || reads == 0) {
+		for(int32_t i = 0; i < 100; ++i) {
+			auto v = ptr->transform_read_consistent(dcon::transform_id(dcon::transform_id::value_base_t(i)), [&](dcon::transform_id id) {
+				return std::tuple<float, float, float>(ptr->transform_get_x(id), ptr->transform_get_y(id), ptr->transform_get_z(id));
+			});
+			if(std::get<1>(v) != 2.0f * std::get<0>(v) || std::get<2>(v) != 3.0f * std::get<0>(v))
+				++torn;
+			++reads;
+		}
+	}
+	writer.join();
+	REQUIRE(torn == 0);
+
+	auto last = ptr->transform_read_consistent(dcon::transform_id(42), [&](dcon::transform_id id) { return ptr->transform_get_z(id); });
+	REQUIRE(last == 6000.0f);
+
+#ifndef DCON_NO_VE
+	ptr->transform_write_consistent(ve::contiguous_tags<dcon::transform_id>(0), [&](auto ids) {
+		ptr->transform_set_x(ids, ve::fp_vector(1.0f));
+		ptr->transform_set_y(ids, ve::fp_vector(2.0f));
+	});
+	auto sum = ptr->transform_read_consistent(ve::contiguous_tags<dcon::transform_id>(0), [&](auto ids) {
+		return ptr->transform_get_x(ids) + ptr->transform_get_y(ids);
+	});
+	for(int32_t i = 0; i < ve::vector_size; ++i)
+		REQUIRE(sum[i] == 3.0f);
+	REQUIRE(ptr->transform_get_x(dcon::transform_id(dcon::transform_id::value_base_t(ve::vector_size))) == 2000.0f);
+#endif
+}
+
+TEST_CASE("consistent read counters wrap around", "[objects_and_properties_tests]") {
+	dcon::write_stripes stripes(4, std::numeric_limits<uint32_t>::max() - 2);
+
+	// the counts for the stripe of instance 10 pass through zero, while the stripe of instance 70 is left just short of it
+	for(int32_t i = 0; i < 5; ++i) {
+		stripes.begin(10, 11);
+		stripes.end(10, 11);
+	}
+	stripes.begin(70, 71);
+	stripes.end(70, 71);
+
+	std::atomic<int32_t> calls{ 0 };
+	REQUIRE(stripes.read(0, 1, [&]() { ++calls; return 7; }) == 7);
+	REQUIRE(calls == 1);
+
+	// a write in progress is still seen as one after the wrap around
+	std::atomic<bool> started{ false };
+	stripes.begin(10, 11);
+	std::thread reader([&]() {
+		started.store(true, std::memory_order_release);
+		stripes.read(0, 0, [&]() { ++calls; });
+	});
+	while(!started.load(std::memory_order_acquire))
+		std::this_thread::yield();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	REQUIRE(calls == 1);
+	stripes.end(10, 11);
+	reader.join();
+	REQUIRE(calls == 2);
+}
+
+TEST_CASE("versioned snapshots", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 600; ++i) {
+		auto u = ptr->create_unit();
+		ptr->unit_set_health(u, float(i));
+		ptr->unit_set_kills(u, i);
+		ptr->unit_set_routed(u, i % 3 == 0);
+	}
+	REQUIRE(ptr->snapshot_version_bytes() == 0);
+
+	auto first = ptr->pin_snapshot();
+	REQUIRE(first.unit_size() == 600);
+
+	for(int32_t i = 0; i < 600; i += 2) {
+		auto u = dcon::unit_id(dcon::unit_id::value_base_t(i));
+		ptr->unit_set_health(u, float(2 * i));
+		ptr->unit_set_routed(u, !ptr->unit_get_routed(u));
+	}
+#ifndef DCON_NO_VE
+	ptr->execute_serial_over_unit([&](auto ids) {
+		ptr->unit_set_kills(ids, ptr->unit_get_kills(ids) + 1000);
+	});
+#else
+	for(int32_t i = 0; i < 600; ++i)
+		ptr->unit_set_kills(dcon::unit_id(dcon::unit_id::value_base_t(i)), i + 1000);
+#endif
+
+	auto second = ptr->pin_snapshot();
+	ptr->unit_set_health(dcon::unit_id(10), -1.0f);
+	ptr->unit_set_health(dcon::unit_id(300), -1.0f);
+
+	for(int32_t i = 0; i < 600; ++i) {
+		auto u = dcon::unit_id(dcon::unit_id::value_base_t(i));
+		REQUIRE(first.unit_get_health(u) == float(i));
+		REQUIRE(first.unit_get_kills(u) == i);
+		REQUIRE(first.unit_get_routed(u) == (i % 3 == 0));
+		REQUIRE(second.unit_get_kills(u) == i + 1000);
+		REQUIRE(second.unit_get_routed(u) == ((i % 3 == 0) != (i % 2 == 0)));
+		REQUIRE(ptr->unit_get_kills(u) == i + 1000);
+	}
+	REQUIRE(second.unit_get_health(dcon::unit_id(10)) == 20.0f);
+	REQUIRE(second.unit_get_health(dcon::unit_id(11)) == 11.0f);
+	REQUIRE(ptr->unit_get_health(dcon::unit_id(300)) == -1.0f);
+	REQUIRE(second.unit_get_health(dcon::unit_id(300)) == 600.0f);
+
+#ifndef DCON_NO_VE
+	auto kills = first.unit_get_kills(ve::contiguous_tags<dcon::unit_id>(256));
+	for(int32_t i = 0; i < ve::vector_size; ++i)
+		REQUIRE(kills[i] == 256 + i);
+#endif
+
+	REQUIRE(ptr->snapshot_version_bytes() != 0);
+	first.release();
+	REQUIRE(!first.is_pinned());
+	ptr->reclaim_snapshot_versions();
+	REQUIRE(ptr->snapshot_version_bytes() != 0); // second still reads the copies made for it
+	REQUIRE(second.unit_get_health(dcon::unit_id(300)) == 600.0f);
+	second.release();
+	ptr->reclaim_snapshot_versions();
+	REQUIRE(ptr->snapshot_version_bytes() == 0);
+
+	// a reader that keeps its snapshot pinned sees the same values every time it looks
+	std::atomic<bool> done{ false };
+	std::thread writer([&]() {
+		for(int32_t tick = 0; tick < 200; ++tick) {
+			for(int32_t i = 0; i < 600; ++i) {
+				auto u = dcon::unit_id(dcon::unit_id::value_base_t(i));
+				ptr->unit_set_health(u, ptr->unit_get_health(u) + 1.0f);
+			}
+			ptr->reclaim_snapshot_versions();
+		}
+		done.store(true, std::memory_order_release);
+	});
+	int32_t changed = 0;
+	int32_t passes = 0;
+	while(!done.load(std::memory_order_acquire) || passes == 0) {
+		auto view = ptr->pin_snapshot();
+		float before = 0.0f;
+		for(int32_t i = 0; i < 600; ++i)
+			before += view.unit_get_health(dcon::unit_id(dcon::unit_id::value_base_t(i)));
+		std::this_thread::yield();
+		float after = 0.0f;
+		for(int32_t i = 0; i < 600; ++i)
+			after += view.unit_get_health(dcon::unit_id(dcon::unit_id::value_base_t(i)));
+		if(before != after)
+			++changed;
+		++passes;
+	}
+	writer.join();
+	REQUIRE(changed == 0);
+	ptr->reclaim_snapshot_versions();
+	REQUIRE(ptr->snapshot_version_bytes() == 0);
+
+	// setters may also run on several threads at once, as long as they write to different instances, even within a block
+	std::vector<float> health_before;
+	for(int32_t i = 0; i < 600; ++i)
+		health_before.push_back(ptr->unit_get_health(dcon::unit_id(dcon::unit_id::value_base_t(i))));
+	auto held = ptr->pin_snapshot();
+	std::atomic<int32_t> running{ 4 };
+	std::vector<std::thread> writers;
+	for(int32_t t = 0; t < 4; ++t) {
+		writers.emplace_back([&, t]() {
+			for(int32_t tick = 0; tick < 100; ++tick) {
+				for(int32_t i = t; i < 600; i += 4) {
+					auto u = dcon::unit_id(dcon::unit_id::value_base_t(i));
+					ptr->unit_set_health(u, ptr->unit_get_health(u) + 1.0f);
+				}
+			}
+			running.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	changed = 0;
+	passes = 0;
+	while(running.load(std::memory_order_acquire) != 0 || passes == 0) {
+		auto view = ptr->pin_snapshot();
+		float before = 0.0f;
+		for(int32_t i = 0; i < 600; ++i)
+			before += view.unit_get_health(dcon::unit_id(dcon::unit_id::value_base_t(i)));
+		std::this_thread::yield();
+		float after = 0.0f;
+		for(int32_t i = 0; i < 600; ++i)
+			after += view.unit_get_health(dcon::unit_id(dcon::unit_id::value_base_t(i)));
+		if(before != after)
+			++changed;
+		++passes;
+	}
+	for(auto& w : writers)
+		w.join();
+	REQUIRE(changed == 0);
+	for(int32_t i = 0; i < 600; ++i) {
+		auto u = dcon::unit_id(dcon::unit_id::value_base_t(i));
+		REQUIRE(held.unit_get_health(u) == health_before[i]);
+		REQUIRE(ptr->unit_get_health(u) == health_before[i] + 100.0f);
+	}
+	held.release();
+	ptr->reclaim_snapshot_versions();
+	REQUIRE(ptr->snapshot_version_bytes() == 0);
+}
+
+TEST_CASE("atomic updates to versioned and consistently read objects", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	// atomic updates are saved for pinned snapshots, like stores made through the setter
+	for(int32_t i = 0; i < 100; ++i)
+		ptr->unit_set_score(ptr->create_unit(), i);
+	auto view = ptr->pin_snapshot();
+	std::vector<std::thread> adders;
+	for(int32_t t = 0; t < 4; ++t) {
+		adders.emplace_back([&]() {
+			for(int32_t i = 0; i < 100; ++i)
+				ptr->unit_fetch_add_score(dcon::unit_id(dcon::unit_id::value_base_t(i)), 10);
+		});
+	}
+	for(auto& a : adders)
+		a.join();
+	ptr->unit_atomic_max_score(dcon::unit_id(5), 1000);
+	int32_t expected = 47;
+	REQUIRE(ptr->unit_compare_exchange_score(dcon::unit_id(7), expected, -1) == true);
+	for(int32_t i = 0; i < 100; ++i)
+		REQUIRE(view.unit_get_score(dcon::unit_id(dcon::unit_id::value_base_t(i))) == i);
+	REQUIRE(ptr->unit_get_score(dcon::unit_id(5)) == 1000);
+	REQUIRE(ptr->unit_get_score(dcon::unit_id(7)) == -1);
+	REQUIRE(ptr->unit_get_score(dcon::unit_id(8)) == 48);
+	view.release();
+	ptr->reclaim_snapshot_versions();
+	REQUIRE(ptr->snapshot_version_bytes() == 0);
+
+	// a consistent read that overlaps an atomic update is retried, so two loads inside it always agree
+	for(int32_t i = 0; i < 64; ++i)
+		ptr->create_transform();
+	std::atomic<int32_t> running{ 2 };
+	std::vector<std::thread> heaters;
+	for(int32_t t = 0; t < 2; ++t) {
+		heaters.emplace_back([&]() {
+			for(int32_t k = 0; k < 2000; ++k) {
+				for(int32_t i = 0; i < 64; ++i)
+					ptr->transform_fetch_add_heat(dcon::transform_id(dcon::transform_id::value_base_t(i)), 1.0f);
+			}
+			running.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	int32_t torn = 0;
+	int32_t reads = 0;
+	while(running.load(std::memory_order_acquire) != 0 || reads == 0) {
+		for(int32_t i = 0; i < 64; ++i) {
+			auto v = ptr->transform_read_consistent(dcon::transform_id(dcon::transform_id::value_base_t(i)), [&](dcon::transform_id id) {
+				auto const first = ptr->transform_get_heat(id);
+				std::this_thread::yield();
+				return std::pair<float, float>(first, ptr->transform_get_heat(id));
+			});
+			if(v.first != v.second)
+				++torn;
+			++reads;
+		}
+	}
+	for(auto& h : heaters)
+		h.join();
+	REQUIRE(torn == 0);
+	for(int32_t i = 0; i < 64; ++i)
+		REQUIRE(ptr->transform_get_heat(dcon::transform_id(dcon::transform_id::value_base_t(i))) == 4000.0f);
+}
+
+TEST_CASE("deferred deletion", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 100; ++i)
+		ptr->thingy_set_some_value(ptr->create_thingy(), i);
+	for(int32_t i = 0; i < 20; ++i)
+		ptr->thingy2_set_some_value(ptr->create_thingy2(), i);
+	for(int32_t i = 0; i < 8; ++i)
+		ptr->create_pooled_thingy();
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(2));
+
+	std::vector<std::thread> workers;
+	for(int32_t t = 0; t < 4; ++t) {
+		workers.emplace_back([&, t]() {
+			for(int32_t i = t; i < 100; i += 4) {
+				if(i % 3 == 0)
+					ptr->queue_delete_thingy(dcon::thingy_id(dcon::thingy_id::value_base_t(i)));
+			}
+			ptr->queue_delete_thingy(dcon::thingy_id(0));
+		});
+	}
+	for(auto& w : workers)
+		w.join();
+
+	ptr->queue_delete_thingy2(dcon::thingy2_id(19));
+	ptr->queue_delete_thingy2(dcon::thingy2_id(5));
+	ptr->queue_delete_pooled_thingy(dcon::pooled_thingy_id(6));
+
+	REQUIRE(ptr->thingy_is_pending_delete(dcon::thingy_id(3)));
+	REQUIRE(!ptr->thingy_is_pending_delete(dcon::thingy_id(4)));
+	REQUIRE(!ptr->thingy_is_pending_delete(dcon::thingy_id()));
+	REQUIRE(ptr->thingy_size() == 100);
+
+	ptr->counter = 0;
+	ptr->commit_deletes();
+	REQUIRE(ptr->thingy_size() == 66);
+	REQUIRE(ptr->counter > 34); // one on_delete per instance, plus the moves that fill the holes
+	ptr->for_each_thingy([&](dcon::thingy_id id) {
+		REQUIRE(ptr->thingy_get_some_value(id) % 3 != 0);
+		REQUIRE(!ptr->thingy_is_pending_delete(id));
+	});
+	REQUIRE(ptr->thingy2_size() == 18);
+	REQUIRE(ptr->pooled_thingy_live_count() == 6);
+	REQUIRE(!ptr->pooled_thingy_is_valid(dcon::pooled_thingy_id(6)));
+
+	ptr->counter = 0;
+	ptr->commit_deletes();
+	REQUIRE(ptr->counter == 0);
+	REQUIRE(ptr->thingy_size() == 66);
+
+	// invalid handles are ignored
+	ptr->queue_delete_thingy(dcon::thingy_id());
+	REQUIRE(!ptr->thingy_is_pending_delete(dcon::thingy_id()));
+
+	// a queued instance that is deleted directly takes its mark with it, even if its slot is reused
+	ptr->queue_delete_pooled_thingy(dcon::pooled_thingy_id(3));
+	ptr->delete_pooled_thingy(dcon::pooled_thingy_id(3));
+	auto reused = ptr->create_pooled_thingy();
+	REQUIRE(reused == dcon::pooled_thingy_id(3));
+	REQUIRE(!ptr->pooled_thingy_is_pending_delete(reused));
+
+	// and an instance moved to fill a hole keeps its mark
+	auto last = dcon::thingy_id(dcon::thingy_id::value_base_t(ptr->thingy_size() - 1));
+	auto last_value = ptr->thingy_get_some_value(last);
+	ptr->queue_delete_thingy(dcon::thingy_id(10));
+	ptr->queue_delete_thingy(last);
+	ptr->delete_thingy(dcon::thingy_id(10));
+	REQUIRE(ptr->thingy_get_some_value(dcon::thingy_id(10)) == last_value);
+	REQUIRE(ptr->thingy_is_pending_delete(dcon::thingy_id(10)));
+	REQUIRE(!ptr->thingy_is_pending_delete(last));
+	ptr->create_thingy();
+	REQUIRE(!ptr->thingy_is_pending_delete(last));
+
+	ptr->commit_deletes();
+	REQUIRE(ptr->thingy_size() == 65);
+	REQUIRE(ptr->pooled_thingy_is_valid(reused));
+	ptr->for_each_thingy([&](dcon::thingy_id id) {
+		REQUIRE(ptr->thingy_get_some_value(id) != last_value);
+	});
+}
+
 TEST_CASE("property_types", "[objects_and_properties_tests]") {
 	auto ptr = std::make_unique< dcon::data_container >();
 
@@ -196,6 +946,36 @@ TEST_CASE("expandable_property_types", "[objects_and_properties_tests]") {
 	REQUIRE(ptr->thingy2_get_big_array_bf(target, 3) == false);
 }
 
+TEST_CASE("expandable bitfield arrays across moves", "[objects_and_properties_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	// the gap left by the first thread's slab is filled by moving the second thread's instance down,
+	// which must work while the bitfield array has never been resized
+	REQUIRE(ptr->thingy2_get_big_array_bf_size() == 0);
+	ptr->begin_concurrent_create_thingy2(64, 2);
+	ptr->create_thingy2_concurrent(0);
+	auto b = ptr->create_thingy2_concurrent(1);
+	ptr->thingy2_set_some_value(b, 7);
+	auto remap = ptr->merge_thingy2_creations();
+	REQUIRE(ptr->thingy2_size() == 2);
+	REQUIRE(remap[b.index()] == dcon::thingy2_id(1));
+	REQUIRE(ptr->thingy2_get_some_value(dcon::thingy2_id(1)) == 7);
+
+	ptr->thingy2_resize_big_array_bf(3);
+	ptr->begin_concurrent_create_thingy2(64, 2);
+	ptr->create_thingy2_concurrent(0);
+	auto d = ptr->create_thingy2_concurrent(1);
+	ptr->thingy2_set_big_array_bf(d, 0, true);
+	ptr->thingy2_set_big_array_bf(d, 2, true);
+	remap = ptr->merge_thingy2_creations();
+	REQUIRE(ptr->thingy2_size() == 4);
+	auto moved = remap[d.index() - 2];
+	REQUIRE(moved == dcon::thingy2_id(3));
+	REQUIRE(ptr->thingy2_get_big_array_bf(moved, 0) == true);
+	REQUIRE(ptr->thingy2_get_big_array_bf(moved, 1) == false);
+	REQUIRE(ptr->thingy2_get_big_array_bf(moved, 2) == true);
+}
+
 TEST_CASE("hooked property getter, setter", "[objects_and_properties_tests]") {
 	auto ptr = std::make_unique< dcon::data_container >();
 	auto thng = dcon::fatten(*ptr, ptr->create_thingy());
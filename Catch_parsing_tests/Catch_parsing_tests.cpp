@@ -241,3 +241,27 @@ TEST_CASE("query parsing", "[parsing_tests]") {
 		REQUIRE(s1.group_by == "Y");
 	}
 }
+
+TEST_CASE("traversal parsing", "[parsing_tests]") {
+	{
+		error_record err("dummy_file");
+		char text[] = "traversal{ name{hops} step{edge}{ends}{ends} step{road}{from}{to} }";
+		auto parsed = parse_file(text, text + strlen(text), err);
+
+		REQUIRE(err.accumulated.length() == 0);
+		REQUIRE(parsed.traversals.size() == 1);
+		REQUIRE(parsed.traversals[0].name == std::string("hops"));
+		REQUIRE(parsed.traversals[0].steps.size() == 2);
+		REQUIRE(parsed.traversals[0].steps[0].relation_name == std::string("edge"));
+		REQUIRE(parsed.traversals[0].steps[1].from_link == std::string("from"));
+		REQUIRE(parsed.traversals[0].steps[1].to_link == std::string("to"));
+	}
+	{
+		error_record err("dummy_file");
+		char text[] = "traversal{ name{hops} step{edge}{ends} }";
+		auto parsed = parse_file(text, text + strlen(text), err);
+
+		REQUIRE(err.accumulated.length() > 0);
+		REQUIRE(parsed.traversals[0].steps.size() == 0);
+	}
+}
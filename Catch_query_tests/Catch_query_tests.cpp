@@ -3,6 +3,8 @@
 #include "catch.hpp"
 #include "common_types.hpp"
 #include "common_types.cpp"
+#include <mutex>
+#include <tuple>
 
 float sum(float a, float b) {
 	return a + b;
@@ -808,4 +810,59 @@ TEST_CASE("siblings test", "[query_tests]") {
 	REQUIRE(cb1);
 	REQUIRE(cb2);
 	REQUIRE(cb3);
-}
\ No newline at end of file
+}
+
+TEST_CASE("parallel queries", "[query_tests]") {
+	auto ptr = std::make_unique<dcon::data_container>();
+
+	for(int32_t i = 0; i < 100; ++i) {
+		auto p = ptr->create_person();
+		ptr->person_set_age(p, (i * 37) % 90);
+	}
+	// each person from 10 on has two parents with lower indices
+	for(int32_t i = 10; i < 100; ++i) {
+		ptr->try_create_parentage(dcon::person_id(dcon::person_id::value_base_t(i)),
+			dcon::person_id(dcon::person_id::value_base_t(i / 2)), dcon::person_id(dcon::person_id::value_base_t(i / 3)));
+	}
+	for(int32_t i = 0; i < 300; ++i) {
+		auto c = ptr->create_car();
+		if(i % 5 != 0)
+			ptr->try_create_car_ownership(dcon::person_id(dcon::person_id::value_base_t((i * 13) % 100)), c);
+	}
+
+	{
+		std::vector<std::tuple<int32_t, int32_t, int32_t>> serial;
+		for(auto& q : ptr->query_group_grandchildren(60))
+			serial.emplace_back(q.get_grandparent().id.index(), q.get_count_gc(), q.get_max_age());
+
+		std::mutex m;
+		std::vector<std::tuple<int32_t, int32_t, int32_t>> parallel;
+		ptr->query_group_grandchildren_parallel(60, [&](auto const& q) {
+			std::lock_guard<std::mutex> lock(m);
+			parallel.emplace_back(q.get_grandparent().id.index(), q.get_count_gc(), q.get_max_age());
+		}, 3);
+		std::sort(parallel.begin(), parallel.end());
+
+		REQUIRE(serial.size() > 10);
+		REQUIRE(parallel == serial);
+	}
+	{
+		std::vector<std::tuple<int32_t, int32_t, int32_t>> serial;
+		for(auto& q : ptr->query_pairs_of_cars())
+			serial.emplace_back(q.get_person_id().id.index(), q.get_car_a_id().id.index(), q.get_car_b_id().id.index());
+		std::sort(serial.begin(), serial.end());
+
+		// per thread result lists, merged at the end
+		std::vector<std::vector<std::tuple<int32_t, int32_t, int32_t>>> per_thread(ve::thread_count());
+		std::as_const(*ptr).query_pairs_of_cars_parallel([&](auto const& q, int32_t thread) {
+			per_thread[thread].emplace_back(q.get_person_id().id.index(), q.get_car_a_id().id.index(), q.get_car_b_id().id.index());
+		});
+		std::vector<std::tuple<int32_t, int32_t, int32_t>> parallel;
+		for(auto& v : per_thread)
+			parallel.insert(parallel.end(), v.begin(), v.end());
+		std::sort(parallel.begin(), parallel.end());
+
+		REQUIRE(serial.size() > 240);
+		REQUIRE(parallel == serial);
+	}
+}
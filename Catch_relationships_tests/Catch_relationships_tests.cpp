@@ -4,6 +4,7 @@
 #include "common_types.hpp"
 #include "relation.hpp"
 #include <array>
+#include <thread>
 #include "common_types.cpp"
 
 TEST_CASE("double relation test", "[relationships_tests]") {
@@ -467,6 +468,154 @@ TEST_CASE("list index storage", "[relationships_tests]") {
 	}
 }
 
+TEST_CASE("csr index storage", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto a1 = fatten(*ptr, ptr->create_thingyA());
+	auto a2 = fatten(*ptr, ptr->create_thingyA());
+	auto a3 = fatten(*ptr, ptr->create_thingyA());
+	auto a4 = fatten(*ptr, ptr->create_thingyA());
+	auto a5 = fatten(*ptr, ptr->create_thingyA());
+	auto a6 = fatten(*ptr, ptr->create_thingyA());
+	auto a7 = fatten(*ptr, ptr->create_thingyA());
+
+	auto b1 = fatten(*ptr, ptr->create_thingyB());
+	auto b2 = fatten(*ptr, ptr->create_thingyB());
+	auto b3 = fatten(*ptr, ptr->create_thingyB());
+
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a7, b3)));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a3, b3)));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a2, b2)));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a5, b2)));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a4, b3)));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a1, b1)));
+
+	REQUIRE(ptr->relate_in_csr_pending_index_changes() == 3);
+
+	auto count_of = [&](dcon::thingyB_id b) {
+		int32_t found_count = 0;
+		ptr->thingyB_for_each_relate_in_csr(b, [&](dcon::relate_in_csr_id) { ++found_count; });
+		return found_count;
+	};
+
+	REQUIRE(count_of(b1) == 1);
+	REQUIRE(count_of(b2) == 2);
+	REQUIRE(count_of(b3) == 3);
+
+	ptr->freeze_relate_in_csr();
+	REQUIRE(ptr->relate_in_csr_pending_index_changes() == 0);
+
+	REQUIRE(count_of(b1) == 1);
+	REQUIRE(count_of(b2) == 2);
+	REQUIRE(count_of(b3) == 3);
+
+	{
+		auto r2 = ptr->thingyB_range_of_relate_in_csr(b2);
+		auto r3 = ptr->thingyB_range_of_relate_in_csr(b3);
+		REQUIRE(r2.second == r3.first);
+		REQUIRE(r2.second - r2.first == 2);
+		REQUIRE(r3.second - r3.first == 3);
+
+		std::array<bool, 7> foundvals{ false, false, false, false, false, false, false };
+		for(auto rid : b3.get_relate_in_csr()) {
+			foundvals[rid.get_left().id.index()] = true;
+		}
+		REQUIRE(foundvals[6]);
+		REQUIRE(foundvals[2]);
+		REQUIRE(foundvals[3]);
+	}
+
+	a4.get_relate_in_csr().set_right(b1);
+	REQUIRE(ptr->relate_in_csr_pending_index_changes() == 2);
+	REQUIRE(count_of(b1) == 2);
+	REQUIRE(count_of(b3) == 2);
+	REQUIRE(a4.get_right_from_relate_in_csr() == b1);
+
+	ptr->delete_thingyA(a2);
+	REQUIRE(count_of(b2) == 1);
+	REQUIRE(a2.get_right_from_relate_in_csr() == b3);
+	REQUIRE(a6.get_right_from_relate_in_csr() == dcon::thingyB_id());
+
+	ptr->freeze_relate_in_csr();
+	REQUIRE(ptr->relate_in_csr_pending_index_changes() == 0);
+	REQUIRE(count_of(b1) == 2);
+	REQUIRE(count_of(b2) == 1);
+	REQUIRE(count_of(b3) == 2);
+	for(auto rid : b1.get_relate_in_csr()) {
+		REQUIRE(rid.get_right() == b1);
+	}
+
+	ptr->delete_thingyB(b3);
+	REQUIRE(count_of(b3) == 0);
+	REQUIRE(!a2.get_relate_in_csr().is_valid());
+	REQUIRE(!a3.get_relate_in_csr().is_valid());
+	REQUIRE(a4.get_relate_in_csr().is_valid());
+}
+
+TEST_CASE("sorted array index storage", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto a1 = fatten(*ptr, ptr->create_thingyA());
+	auto a2 = fatten(*ptr, ptr->create_thingyA());
+	auto a3 = fatten(*ptr, ptr->create_thingyA());
+
+	auto b1 = fatten(*ptr, ptr->create_thingyB());
+	auto b2 = fatten(*ptr, ptr->create_thingyB());
+
+	auto is_sorted = [](auto range) {
+		return std::is_sorted(range.first, range.second, [](dcon::relate_in_sorted_id l, dcon::relate_in_sorted_id r) { return l.value < r.value; });
+	};
+
+	std::vector<dcon::relate_in_sorted_id> created;
+	for(int32_t i = 0; i < 30; ++i) {
+		auto a = (i % 3 == 0) ? a1 : ((i % 3 == 1) ? a2 : a3);
+		auto b = (i % 2 == 0) ? b1 : b2;
+		created.push_back(ptr->try_create_relate_in_sorted(a, b));
+		REQUIRE(bool(created.back()));
+	}
+
+	REQUIRE(ptr->thingyB_range_of_relate_in_sorted_as_right(b1).second - ptr->thingyB_range_of_relate_in_sorted_as_right(b1).first == 15);
+	REQUIRE(ptr->thingyA_range_of_relate_in_sorted_as_left(a2).second - ptr->thingyA_range_of_relate_in_sorted_as_left(a2).first == 10);
+
+	for(int32_t i = 0; i < 30; i += 4) {
+		ptr->delete_relate_in_sorted(created[i]);
+	}
+	for(int32_t i = 0; i < 6; ++i) {
+		auto r = ptr->try_create_relate_in_sorted(a3, b1);
+		REQUIRE(bool(r));
+	}
+
+	REQUIRE(is_sorted(ptr->thingyB_range_of_relate_in_sorted_as_right(b1)));
+	REQUIRE(is_sorted(ptr->thingyB_range_of_relate_in_sorted_as_right(b2)));
+	REQUIRE(is_sorted(ptr->thingyA_range_of_relate_in_sorted_as_left(a1)));
+	REQUIRE(is_sorted(ptr->thingyA_range_of_relate_in_sorted_as_left(a2)));
+	REQUIRE(is_sorted(ptr->thingyA_range_of_relate_in_sorted_as_left(a3)));
+
+	int32_t b1_count = 0;
+	for(auto r : b1.get_relate_in_sorted_as_right()) {
+		REQUIRE(r.get_right() == b1);
+		++b1_count;
+	}
+	REQUIRE(b1_count == 15 - 8 + 6);
+
+	fatten(*ptr, created[3]).set_right(b1);
+	REQUIRE(is_sorted(ptr->thingyB_range_of_relate_in_sorted_as_right(b1)));
+	REQUIRE(is_sorted(ptr->thingyB_range_of_relate_in_sorted_as_right(b2)));
+	REQUIRE(b1.contains_relate_in_sorted_as_right(created[3]));
+	REQUIRE(!ptr->thingyB_contains_relate_in_sorted_as_right(b2, created[3]));
+	REQUIRE(!ptr->thingyB_contains_relate_in_sorted_as_right(b1, created[0]));
+	REQUIRE(ptr->thingyA_contains_relate_in_sorted_as_left(a1, created[3]));
+	REQUIRE(!ptr->thingyA_contains_relate_in_sorted_as_left(a2, created[3]));
+
+	ptr->delete_thingyB(b1);
+	REQUIRE(ptr->thingyB_range_of_relate_in_sorted_as_right(b2).second - ptr->thingyB_range_of_relate_in_sorted_as_right(b2).first == 14);
+	REQUIRE(is_sorted(ptr->thingyA_range_of_relate_in_sorted_as_left(a1)));
+	REQUIRE(is_sorted(ptr->thingyA_range_of_relate_in_sorted_as_left(a3)));
+	for(auto r : a2.get_relate_in_sorted_as_left()) {
+		REQUIRE(r.get_right() == b2);
+	}
+}
+
 TEST_CASE("many many relation test", "[relationships_tests]") {
 
 	auto ptr = std::make_unique< dcon::data_container >();
@@ -713,4 +862,628 @@ TEST_CASE("undirected unindexed non reflexive graph like", "[relationships_tests
 	ptr->delete_thingyA(o5);
 	REQUIRE(r1.is_valid());
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("bulk creation", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto a1 = fatten(*ptr, ptr->create_thingyA());
+	auto a2 = fatten(*ptr, ptr->create_thingyA());
+	auto a3 = fatten(*ptr, ptr->create_thingyA());
+	auto a4 = fatten(*ptr, ptr->create_thingyA());
+
+	auto b1 = fatten(*ptr, ptr->create_thingyB());
+	auto b2 = fatten(*ptr, ptr->create_thingyB());
+
+	{
+		std::array<dcon::data_container::relate_in_array_link_tuple, 5> links{ {
+			{ a1, b1 }, { a2, b1 }, { a1, b2 }, { a3, b2 }, { a4, dcon::thingyB_id() }
+		} };
+		std::array<dcon::relate_in_array_id, 5> ids;
+
+		REQUIRE(ptr->bulk_create_relate_in_array(links.data(), uint32_t(links.size()), ids.data()) == 3);
+		REQUIRE(bool(ids[0]));
+		REQUIRE(bool(ids[1]));
+		REQUIRE(!bool(ids[2]));
+		REQUIRE(bool(ids[3]));
+		REQUIRE(!bool(ids[4]));
+
+		REQUIRE(fatten(*ptr, ids[1]).get_left() == a2);
+		REQUIRE(fatten(*ptr, ids[3]).get_right() == b2);
+		REQUIRE(a1.get_relate_in_array_as_left() == ids[0]);
+
+		int32_t found_count = 0;
+		for(auto rid : b1.get_relate_in_array_as_right()) {
+			REQUIRE((rid == ids[0] || rid == ids[1]));
+			found_count++;
+		}
+		REQUIRE(found_count == 2);
+
+		REQUIRE(!bool(ptr->try_create_relate_in_array(a3, b1)));
+		REQUIRE(ptr->bulk_create_relate_in_array(links.data(), uint32_t(links.size())) == 0);
+	}
+	{
+		std::array<dcon::data_container::relate_same_link_tuple, 4> links{ {
+			{ a1, a2 }, { a2, a1 }, { a1, a3 }, { a3, a3 }
+		} };
+		REQUIRE(ptr->bulk_create_relate_same(links.data(), uint32_t(links.size())) == 3);
+		REQUIRE(a1.get_relate_same_as_left().get_right() == a2);
+		REQUIRE(ptr->get_relate_same_by_joint(a3, a3) == a3.get_relate_same_as_left());
+		REQUIRE(ptr->get_relate_same_by_joint(a1, a3) == dcon::relate_same_id());
+	}
+	{
+		std::array<dcon::data_container::relate_as_multipleB_link_tuple, 4> links{ {
+			{ { a1, a2 } }, { { a2, a3 } }, { { a4, a4 } }, { { a3, a4 } }
+		} };
+		std::array<dcon::relate_as_multipleB_id, 4> ids;
+
+		REQUIRE(ptr->bulk_create_relate_as_multipleB(links.data(), uint32_t(links.size()), ids.data()) == 2);
+		REQUIRE(bool(ids[0]));
+		REQUIRE(!bool(ids[1]));
+		REQUIRE(!bool(ids[2]));
+		REQUIRE(bool(ids[3]));
+		REQUIRE(a2.get_relate_as_multipleB() == ids[0]);
+		REQUIRE(a4.get_relate_as_multipleB() == ids[3]);
+	}
+	{
+		std::array<dcon::data_container::relate_as_multipleA_link_tuple, 3> links{ {
+			{ { a1, a2 } }, { { a2, a1 } }, { { a3, a1 } }
+		} };
+		REQUIRE(ptr->bulk_create_relate_as_multipleA(links.data(), uint32_t(links.size())) == 2);
+		REQUIRE(bool(ptr->get_relate_as_multipleA_by_joint(a1, a2)));
+		REQUIRE(bool(ptr->get_relate_as_multipleA_by_joint(a1, a3)));
+		REQUIRE(fatten(*ptr, ptr->get_relate_as_multipleA_by_joint(a1, a2)).get_left(0) == a1);
+	}
+}
+
+TEST_CASE("many link reductions", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto b1 = ptr->create_thingyB();
+	auto b2 = ptr->create_thingyB();
+	auto b3 = ptr->create_thingyB();
+	auto a1 = ptr->create_thingyA();
+
+	float expected_sum = 0.0f;
+	for(int32_t i = 0; i < 19; ++i) {
+		auto r = ptr->force_create_weighted_holding(b1, a1);
+		ptr->weighted_holding_set_weight(r, float(i) * 0.5f - 2.0f);
+		ptr->weighted_holding_set_count(r, int16_t(i));
+		expected_sum += float(i) * 0.5f - 2.0f;
+	}
+	auto last = ptr->force_create_weighted_holding(b2, a1);
+	ptr->weighted_holding_set_weight(last, 7.0f);
+	ptr->weighted_holding_set_count(last, int16_t(-3));
+
+	REQUIRE(ptr->thingyB_sum_weight_from_weighted_holding(b1) == Approx(expected_sum));
+	REQUIRE(ptr->thingyB_min_weight_from_weighted_holding(b1) == -2.0f);
+	REQUIRE(ptr->thingyB_max_weight_from_weighted_holding_as_holder(b1) == 7.0f);
+	REQUIRE(ptr->thingyB_sum_count_from_weighted_holding(b1) == 171);
+	REQUIRE(ptr->thingyB_min_count_from_weighted_holding(b2) == -3);
+
+	REQUIRE(ptr->thingyB_sum_weight_from_weighted_holding(b3) == 0.0f);
+	REQUIRE(ptr->thingyB_min_weight_from_weighted_holding(b3) == std::numeric_limits<float>::max());
+	REQUIRE(ptr->thingyA_max_count_from_weighted_holding(a1) == 18);
+	REQUIRE(ptr->thingyA_sum_weight_from_weighted_holding(a1) == Approx(expected_sum + 7.0f));
+
+	ptr->delete_weighted_holding(last);
+
+	auto totals = ptr->thingyB_make_vectorizable_float_buffer();
+	ptr->thingyB_sum_weight_from_weighted_holding(totals);
+	REQUIRE(totals.get(b1) == Approx(expected_sum));
+	REQUIRE(totals.get(b2) == 0.0f);
+	REQUIRE(totals.get(b3) == 0.0f);
+
+	ve::vectorizable_buffer<int16_t, dcon::thingyB_id> counts(ptr->thingyB_size());
+	ptr->thingyB_max_count_from_weighted_holding(counts);
+	REQUIRE(counts.get(b1) == 18);
+	REQUIRE(counts.get(b2) == std::numeric_limits<int16_t>::lowest());
+
+	// integer sums are widened, whether the values are gathered or read one at a time
+	uint32_t k = 0;
+	ptr->thingyB_for_each_weighted_holding_as_holder(b1, [&](dcon::weighted_holding_id r) {
+		ptr->weighted_holding_set_count(r, int16_t(30000));
+		ptr->weighted_holding_set_amount(r, 4000000000u - k);
+		++k;
+	});
+	static_assert(std::is_same_v<decltype(ptr->thingyB_sum_count_from_weighted_holding(b1)), int64_t>);
+	static_assert(std::is_same_v<decltype(ptr->thingyB_sum_amount_from_weighted_holding(b1)), uint64_t>);
+	REQUIRE(ptr->thingyB_sum_count_from_weighted_holding(b1) == 19 * 30000);
+	REQUIRE(ptr->thingyA_sum_count_from_weighted_holding(a1) == 19 * 30000);
+	REQUIRE(ptr->thingyB_sum_amount_from_weighted_holding(b1) == 19 * uint64_t(4000000000u) - 18 * 19 / 2);
+	REQUIRE(ptr->thingyB_max_amount_from_weighted_holding(b1) == 4000000000u);
+	REQUIRE(ptr->thingyB_min_count_from_weighted_holding(b1) == 30000);
+
+	ve::vectorizable_buffer<int64_t, dcon::thingyB_id> count_totals(ptr->thingyB_size());
+	ptr->thingyB_sum_count_from_weighted_holding(count_totals);
+	REQUIRE(count_totals.get(b1) == 19 * 30000);
+	REQUIRE(count_totals.get(b3) == 0);
+}
+
+TEST_CASE("scatter add through links", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	for(int32_t i = 0; i < 10; ++i)
+		ptr->create_thingyB();
+	auto a1 = ptr->create_thingyA();
+
+	for(int32_t i = 0; i < 300; ++i) {
+		auto r = ptr->force_create_weighted_holding(dcon::thingyB_id(dcon::thingyB_id::value_base_t(i % 7)), a1);
+		ptr->weighted_holding_set_weight(r, float(i) * 0.25f - 3.0f);
+		ptr->weighted_holding_set_count(r, int16_t(i % 5));
+	}
+	ptr->delete_weighted_holding(dcon::weighted_holding_id(3));
+	ptr->delete_weighted_holding(dcon::weighted_holding_id(250));
+
+	std::vector<float> expected_weight(10, 0.0f);
+	std::vector<int32_t> expected_count(10, 0);
+	ptr->for_each_weighted_holding([&](dcon::weighted_holding_id r) {
+		expected_weight[ptr->weighted_holding_get_holder(r).index()] += ptr->weighted_holding_get_weight(r);
+		expected_count[ptr->weighted_holding_get_holder(r).index()] += ptr->weighted_holding_get_count(r);
+	});
+
+	// lanes sharing a holder are added in order, so the result matches the scalar loop exactly
+	std::vector<float> weight(10, 0.0f);
+	std::vector<int32_t> count(10, 0);
+	ve::execute_serial<dcon::weighted_holding_id>(ptr->weighted_holding_size(), [&](auto ids) {
+		auto holders = ptr->weighted_holding_get_holder(ids);
+		ve::scatter_add(holders, weight.data(), ptr->weighted_holding_get_weight(ids));
+		ve::scatter_add(holders, count.data(), ptr->weighted_holding_get_count(ids));
+	});
+	REQUIRE(weight == expected_weight);
+	REQUIRE(count == expected_count);
+
+	std::vector<float> parallel_weight(10, 1.0f);
+	ve::scatter_add_parallel<dcon::weighted_holding_id>(ptr->weighted_holding_size(), parallel_weight.data(), 10, [&](auto ids, float* buffer) {
+		ve::scatter_add(ptr->weighted_holding_get_holder(ids), buffer, ptr->weighted_holding_get_weight(ids));
+	});
+	for(int32_t i = 0; i < 10; ++i)
+		REQUIRE(parallel_weight[i] == Approx(expected_weight[i] + 1.0f));
+}
+
+TEST_CASE("graph traversal", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::array<dcon::thingyA_id, 7> n;
+	for(auto& i : n)
+		i = ptr->create_thingyA();
+
+	// a path 0 - 1 - 2 - 3 - 4 with a branch 1 - 5 and 6 left unconnected
+	ptr->try_create_relate_as_multipleC(n[0], n[1]);
+	ptr->try_create_relate_as_multipleC(n[2], n[1]);
+	ptr->try_create_relate_as_multipleC(n[2], n[3]);
+	ptr->try_create_relate_as_multipleC(n[3], n[4]);
+	ptr->try_create_relate_as_multipleC(n[5], n[1]);
+
+	int32_t neighbor_count = 0;
+	ptr->for_each_adjacent_neighbor(n[1], [&](dcon::thingyA_id m) {
+		REQUIRE((m == n[0] || m == n[2] || m == n[5]));
+		++neighbor_count;
+	});
+	REQUIRE(neighbor_count == 3);
+
+	std::array<int32_t, 7> depths{ -1, -1, -1, -1, -1, -1, -1 };
+	ptr->bfs_adjacent(n[0], 10, [&](dcon::thingyA_id m, int32_t depth) {
+		REQUIRE(depths[m.index()] == -1);
+		depths[m.index()] = depth;
+	});
+	REQUIRE(depths == std::array<int32_t, 7>{ 0, 1, 2, 3, 4, 2, -1 });
+
+	auto two_hops = ptr->k_hop_adjacent(n[0], 2);
+	std::sort(two_hops.begin(), two_hops.end(), [](auto a, auto b) { return a.index() < b.index(); });
+	REQUIRE(two_hops == std::vector<dcon::thingyA_id>{ n[1], n[2], n[5] });
+	REQUIRE(ptr->k_hop_adjacent(n[6], 3).empty());
+
+#ifndef VE_NO_TBB
+	std::array<std::atomic<int32_t>, 7> parallel_depths;
+	for(auto& d : parallel_depths)
+		d.store(-1);
+	ptr->bfs_adjacent_parallel(n[0], 10, [&](dcon::thingyA_id m, int32_t depth) {
+		parallel_depths[m.index()].store(depth);
+	});
+	for(int32_t i = 0; i < 7; ++i)
+		REQUIRE(parallel_depths[i].load() == depths[i]);
+
+	auto parallel_hops = ptr->k_hop_adjacent_parallel(n[0], 2);
+	std::sort(parallel_hops.begin(), parallel_hops.end(), [](auto a, auto b) { return a.index() < b.index(); });
+	REQUIRE(parallel_hops == two_hops);
+#endif
+
+	auto b1 = ptr->create_thingyB();
+	auto b2 = ptr->create_thingyB();
+	ptr->try_create_relate_in_array(n[0], b1);
+	ptr->try_create_relate_in_array(n[3], b1);
+	ptr->try_create_relate_in_array(n[6], b2);
+
+	auto via_b = ptr->k_hop_shares_b(n[0], 1);
+	REQUIRE(via_b == std::vector<dcon::thingyA_id>{ n[3] });
+	REQUIRE(ptr->k_hop_shares_b(n[6], 5).empty());
+}
+
+TEST_CASE("hierarchy index", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+	auto range_size = [](auto r) { return r.second - r.first; };
+
+	std::array<dcon::tree_node_id, 7> n;
+	for(auto& i : n)
+		i = ptr->create_tree_node();
+
+	ptr->try_create_node_parent(n[1], n[0]);
+	ptr->try_create_node_parent(n[2], n[0]);
+	ptr->try_create_node_parent(n[3], n[1]);
+	ptr->try_create_node_parent(n[4], n[1]);
+	ptr->try_create_node_parent(n[5], n[3]);
+
+	REQUIRE(ptr->node_parent_is_ancestor(n[0], n[5]));
+	REQUIRE(ptr->node_parent_is_ancestor(n[1], n[4]));
+	REQUIRE(!ptr->node_parent_is_ancestor(n[1], n[2]));
+	REQUIRE(!ptr->node_parent_is_ancestor(n[5], n[5]));
+	REQUIRE(!ptr->node_parent_is_ancestor(n[5], n[0]));
+	REQUIRE(!ptr->node_parent_is_ancestor(n[0], n[6]));
+
+	auto sub = ptr->node_parent_subtree_of(n[1]);
+	REQUIRE(std::vector<dcon::tree_node_id>(sub.first, sub.second) == std::vector<dcon::tree_node_id>{ n[1], n[3], n[5], n[4] });
+	REQUIRE(range_size(ptr->node_parent_subtree_of(n[6])) == 1);
+
+	REQUIRE(ptr->node_parent_depth_of(n[0]) == 0);
+	REQUIRE(ptr->node_parent_depth_of(n[5]) == 3);
+	REQUIRE(ptr->node_parent_level_count() == 4);
+	REQUIRE(range_size(ptr->node_parent_by_depth()) == 7);
+
+	auto top = ptr->node_parent_at_depth(0);
+	REQUIRE(std::vector<dcon::tree_node_id>(top.first, top.second) == std::vector<dcon::tree_node_id>{ n[0], n[6] });
+	auto second = ptr->node_parent_at_depth(2);
+	REQUIRE(std::vector<dcon::tree_node_id>(second.first, second.second) == std::vector<dcon::tree_node_id>{ n[3], n[4] });
+	REQUIRE(range_size(ptr->node_parent_at_depth(4)) == 0);
+
+	ptr->node_parent_set_parent(dcon::node_parent_id(dcon::node_parent_id::value_base_t(n[2].index())), n[5]);
+
+	REQUIRE(ptr->node_parent_is_ancestor(n[3], n[2]));
+	REQUIRE(ptr->node_parent_depth_of(n[2]) == 4);
+	sub = ptr->node_parent_subtree_of(n[1]);
+	REQUIRE(std::vector<dcon::tree_node_id>(sub.first, sub.second) == std::vector<dcon::tree_node_id>{ n[1], n[3], n[5], n[2], n[4] });
+
+	// n[6] is moved into the slot of n[3]; n[5] loses its parent
+	ptr->delete_tree_node(n[3]);
+
+	REQUIRE(ptr->tree_node_size() == 6);
+	REQUIRE(!ptr->node_parent_is_ancestor(n[0], n[5]));
+	sub = ptr->node_parent_subtree_of(n[1]);
+	REQUIRE(std::vector<dcon::tree_node_id>(sub.first, sub.second) == std::vector<dcon::tree_node_id>{ n[1], n[4] });
+	sub = ptr->node_parent_subtree_of(n[5]);
+	REQUIRE(std::vector<dcon::tree_node_id>(sub.first, sub.second) == std::vector<dcon::tree_node_id>{ n[5], n[2] });
+	REQUIRE(ptr->node_parent_depth_of(n[2]) == 1);
+	top = ptr->node_parent_at_depth(0);
+	REQUIRE(std::vector<dcon::tree_node_id>(top.first, top.second) == std::vector<dcon::tree_node_id>{ n[0], n[3], n[5] });
+
+	// invalid and out of range handles are not part of the layout
+	REQUIRE(ptr->node_parent_depth_of(dcon::tree_node_id()) == 0);
+	REQUIRE(ptr->node_parent_depth_of(dcon::tree_node_id(dcon::tree_node_id::value_base_t(50))) == 0);
+	REQUIRE(!ptr->node_parent_is_ancestor(n[0], dcon::tree_node_id(dcon::tree_node_id::value_base_t(50))));
+	REQUIRE(range_size(ptr->node_parent_subtree_of(dcon::tree_node_id(dcon::tree_node_id::value_base_t(50)))) == 0);
+
+	// several threads may query through a const reference while the layout is out of date
+	ptr->node_parent_set_parent(dcon::node_parent_id(dcon::node_parent_id::value_base_t(n[2].index())), n[4]);
+	dcon::data_container const& cref = *ptr;
+	std::array<std::thread, 4> readers;
+	std::array<uint32_t, 4> depths = { 0, 0, 0, 0 };
+	for(uint32_t t = 0; t < 4; ++t) {
+		readers[t] = std::thread([&, t]() {
+			depths[t] = cref.node_parent_depth_of(n[2]);
+		});
+	}
+	for(auto& r : readers)
+		r.join();
+	for(auto d : depths)
+		REQUIRE(d == 3);
+}
+
+TEST_CASE("lazy reverse index", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::array<dcon::thingyB_id, 10> b;
+	for(auto& i : b)
+		i = ptr->create_thingyB();
+
+	auto r0 = ptr->try_create_lazy_pointer(b[2]);
+	auto r1 = ptr->try_create_lazy_pointer(b[2]);
+	auto r2 = ptr->try_create_lazy_pointer(b[5]);
+
+	auto rng = ptr->thingyB_range_of_lazy_pointer(b[2]);
+	REQUIRE(rng.second - rng.first == 2);
+	REQUIRE(rng.first[0] == r0);
+	REQUIRE(rng.first[1] == r1);
+	REQUIRE(ptr->thingyB_range_of_lazy_pointer(b[3]).first == ptr->thingyB_range_of_lazy_pointer(b[3]).second);
+
+	ptr->lazy_pointer_set_target(r1, b[5]);
+	std::vector<dcon::lazy_pointer_id> seen;
+	ptr->thingyB_for_each_lazy_pointer_as_target(b[5], [&](dcon::lazy_pointer_id r) { seen.push_back(r); });
+	REQUIRE(seen == std::vector<dcon::lazy_pointer_id>{ r1, r2 });
+
+	ptr->delete_lazy_pointer(r2);
+	REQUIRE(ptr->thingyB_range_of_lazy_pointer(b[5]).second - ptr->thingyB_range_of_lazy_pointer(b[5]).first == 1);
+
+	// enough instances for the rebuild to take the parallel path
+	for(int32_t i = 0; i < 5000; ++i)
+		ptr->try_create_lazy_pointer(b[i % 10]);
+
+	for(int32_t j = 0; j < 10; ++j) {
+		auto r = ptr->thingyB_range_of_lazy_pointer(b[j]);
+		size_t expected = 500 + (j == 2 ? 1 : 0) + (j == 5 ? 1 : 0);
+		REQUIRE(size_t(r.second - r.first) == expected);
+		REQUIRE(std::is_sorted(r.first, r.second, [](dcon::lazy_pointer_id x, dcon::lazy_pointer_id y) { return x.value < y.value; }));
+		bool all_match = true;
+		for(auto p = r.first; p != r.second; ++p)
+			all_match = all_match && ptr->lazy_pointer_get_target(*p) == b[j];
+		REQUIRE(all_match);
+	}
+
+	// a link to a target that is created after the index was built
+	auto late = ptr->try_create_lazy_pointer(b[0]);
+	ptr->lazy_pointer_set_target(late, dcon::thingyB_id(dcon::thingyB_id::value_base_t(20)));
+	REQUIRE(ptr->thingyB_range_of_lazy_pointer(b[0]).second - ptr->thingyB_range_of_lazy_pointer(b[0]).first == 500);
+	dcon::thingyB_id b20;
+	for(int32_t i = 0; i < 11; ++i)
+		b20 = ptr->create_thingyB();
+	REQUIRE(b20 == dcon::thingyB_id(dcon::thingyB_id::value_base_t(20)));
+	REQUIRE(ptr->thingyB_range_of_lazy_pointer(b20).second - ptr->thingyB_range_of_lazy_pointer(b20).first == 1);
+	REQUIRE(*ptr->thingyB_range_of_lazy_pointer(b20).first == late);
+
+	// the first lookups after a write, made from several threads at once, share a single rebuild
+	ptr->lazy_pointer_set_target(late, b[3]);
+	dcon::data_container const& cref = *ptr;
+	std::array<size_t, 4> counts{};
+	std::vector<std::thread> readers;
+	for(size_t t = 0; t < counts.size(); ++t) {
+		readers.emplace_back([&cref, &counts, &b, t]() {
+			auto r = cref.thingyB_range_of_lazy_pointer(b[3]);
+			counts[t] = size_t(r.second - r.first);
+		});
+	}
+	for(auto& t : readers)
+		t.join();
+	for(auto c : counts)
+		REQUIRE(c == 501);
+}
+
+TEST_CASE("many link statistics", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::array<dcon::thingyB_id, 4> b;
+	for(auto& i : b)
+		i = ptr->create_thingyB();
+	std::array<dcon::thingyA_id, 6> a;
+	for(auto& i : a)
+		i = ptr->create_thingyA();
+
+	for(int32_t i = 0; i < 5; ++i)
+		ptr->try_create_weighted_holding(b[1], a[i]);
+	ptr->try_create_weighted_holding(b[3], a[5]);
+	ptr->try_create_weighted_holding(b[3], a[5]);
+
+	auto stats = ptr->weighted_holding_link_stats_holder();
+	REQUIRE(stats.owner_count == 4);
+	REQUIRE(stats.total_links == 7);
+	REQUIRE(stats.max_degree == 5);
+	REQUIRE(stats.max_degree_owner == b[1]);
+	REQUIRE(stats.degree_histogram[0] == 2);
+	REQUIRE(stats.degree_histogram[2] == 1);
+	REQUIRE(stats.degree_histogram[3] == 1);
+	REQUIRE(stats.mean_degree() == Approx(1.75));
+	REQUIRE(stats.storage_bytes >= 7 * sizeof(dcon::weighted_holding_id));
+
+	std::vector<std::pair<dcon::thingyB_id, uint32_t>> flagged;
+	ptr->weighted_holding_link_stats_holder(2, [&](dcon::thingyB_id owner, uint32_t degree) { flagged.emplace_back(owner, degree); });
+	REQUIRE(flagged.size() == 1);
+	REQUIRE(flagged[0].first == b[1]);
+	REQUIRE(flagged[0].second == 5);
+
+	auto held = ptr->weighted_holding_link_stats_held();
+	REQUIRE(held.owner_count == 6);
+	REQUIRE(held.max_degree == 2);
+	REQUIRE(held.max_degree_owner == a[5]);
+	REQUIRE(held.degree_histogram[1] == 5);
+	REQUIRE(held.storage_bytes == 0);
+}
+
+TEST_CASE("erasable compaction", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto a0 = fatten(*ptr, ptr->create_thingyA());
+	auto a1 = fatten(*ptr, ptr->create_thingyA());
+	auto a2 = fatten(*ptr, ptr->create_thingyA());
+	auto a3 = fatten(*ptr, ptr->create_thingyA());
+
+	std::vector<dcon::thingyB_id> bs;
+	for(int32_t i = 0; i < 6; ++i) {
+		bs.push_back(ptr->create_thingyB());
+		ptr->thingyB_set_some_value(bs.back(), 10 * i);
+	}
+
+	REQUIRE(bool(ptr->try_create_relate_in_array(a0, bs[5])));
+	REQUIRE(bool(ptr->try_create_relate_in_list(a1, bs[5])));
+	REQUIRE(bool(ptr->try_create_relate_in_csr(a2, bs[4])));
+	REQUIRE(bool(ptr->try_create_relate_in_list(a3, bs[1])));
+
+	ptr->delete_thingyB(bs[0]);
+	ptr->delete_thingyB(bs[2]);
+	ptr->delete_thingyB(bs[3]);
+
+	auto remap = ptr->compact_thingyB();
+	REQUIRE(remap.size() == 6);
+	REQUIRE(remap[0] == dcon::thingyB_id());
+	REQUIRE(remap[1] == dcon::thingyB_id(1));
+	REQUIRE(remap[3] == dcon::thingyB_id());
+	REQUIRE(remap[4] == dcon::thingyB_id(2));
+	REQUIRE(remap[5] == dcon::thingyB_id(0));
+
+	REQUIRE(ptr->thingyB_size() == 3);
+	REQUIRE(ptr->thingyB_live_count() == 3);
+	REQUIRE(ptr->thingyB_get_some_value(dcon::thingyB_id(0)) == 50);
+	REQUIRE(ptr->thingyB_get_some_value(dcon::thingyB_id(1)) == 10);
+	REQUIRE(ptr->thingyB_get_some_value(dcon::thingyB_id(2)) == 40);
+
+	REQUIRE(a0.get_right_from_relate_in_array() == dcon::thingyB_id(0));
+	REQUIRE(a1.get_right_from_relate_in_list() == dcon::thingyB_id(0));
+	REQUIRE(a2.get_right_from_relate_in_csr() == dcon::thingyB_id(2));
+	REQUIRE(a3.get_right_from_relate_in_list() == dcon::thingyB_id(1));
+
+	int32_t in_array = 0;
+	ptr->thingyB_for_each_relate_in_array(dcon::thingyB_id(0), [&](dcon::relate_in_array_id r) {
+		REQUIRE(ptr->relate_in_array_get_left(r) == a0);
+		++in_array;
+	});
+	REQUIRE(in_array == 1);
+	int32_t in_list = 0;
+	ptr->thingyB_for_each_relate_in_list(dcon::thingyB_id(0), [&](dcon::relate_in_list_id) { ++in_list; });
+	REQUIRE(in_list == 1);
+	int32_t in_csr = 0;
+	ptr->thingyB_for_each_relate_in_csr(dcon::thingyB_id(2), [&](dcon::relate_in_csr_id) { ++in_csr; });
+	REQUIRE(in_csr == 1);
+
+	auto fresh = ptr->create_thingyB();
+	REQUIRE(fresh == dcon::thingyB_id(3));
+	REQUIRE(ptr->thingyB_get_some_value(fresh) == 0);
+}
+
+TEST_CASE("object reorder", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::array<dcon::thingyA_id, 5> n;
+	for(int32_t i = 0; i < 5; ++i) {
+		n[i] = ptr->create_thingyA();
+		ptr->thingyA_set_some_value(n[i], 10 * i);
+	}
+	auto b = ptr->create_thingyB();
+
+	// a path 0 - 3 - 1 - 4 - 2
+	ptr->try_create_relate_as_multipleC(n[0], n[3]);
+	ptr->try_create_relate_as_multipleC(n[3], n[1]);
+	ptr->try_create_relate_as_multipleC(n[1], n[4]);
+	ptr->try_create_relate_as_multipleC(n[4], n[2]);
+
+	REQUIRE(bool(ptr->try_create_relate_same(n[0], n[4])));
+	REQUIRE(bool(ptr->try_create_relate_same(n[2], n[1])));
+	REQUIRE(bool(ptr->try_create_relate_in_array(n[3], b)));
+	auto d = ptr->try_create_relate_as_multipleD(n[1], n[2]);
+
+	auto by_value = ptr->thingyA_order_by([&](dcon::thingyA_id id) { return -ptr->thingyA_get_some_value(id); });
+	REQUIRE(by_value == std::vector<dcon::thingyA_id>{ n[4], n[3], n[2], n[1], n[0] });
+	ptr->reorder_thingyA(by_value.data(), uint32_t(by_value.size()));
+
+	REQUIRE(ptr->thingyA_size() == 5);
+	for(int32_t i = 0; i < 5; ++i)
+		REQUIRE(ptr->thingyA_get_some_value(dcon::thingyA_id(dcon::thingyA_id::value_base_t(i))) == 40 - 10 * i);
+
+	// old index k is now at 4 - k
+	auto at = [](int32_t old_index) { return dcon::thingyA_id(dcon::thingyA_id::value_base_t(4 - old_index)); };
+	REQUIRE(ptr->get_relate_same_by_joint(at(0), at(4)) == ptr->thingyA_get_relate_same_as_left(at(0)));
+	REQUIRE(ptr->relate_same_get_right(ptr->thingyA_get_relate_same_as_left(at(2))) == at(1));
+	REQUIRE(ptr->relate_in_array_get_right(ptr->thingyA_get_relate_in_array_as_left(at(3))) == b);
+	REQUIRE(!bool(ptr->relate_in_array_get_right(ptr->thingyA_get_relate_in_array_as_left(at(0)))));
+	ptr->thingyB_for_each_relate_in_array(b, [&](dcon::relate_in_array_id r) {
+		REQUIRE(ptr->relate_in_array_get_left(r) == at(3));
+	});
+	REQUIRE(ptr->relate_as_multipleD_get_left(d, 0) == at(1));
+	REQUIRE(ptr->relate_as_multipleD_get_left(d, 1) == at(2));
+
+	int32_t neighbor_count = 0;
+	ptr->for_each_adjacent_neighbor(at(1), [&](dcon::thingyA_id m) {
+		REQUIRE((m == at(3) || m == at(4)));
+		++neighbor_count;
+	});
+	REQUIRE(neighbor_count == 2);
+
+	// after a reverse Cuthill-McKee ordering every edge of the path joins neighboring indices
+	auto rcm = ptr->rcm_order_adjacent();
+	REQUIRE(rcm.size() == 5);
+	ptr->reorder_thingyA(rcm.data(), uint32_t(rcm.size()));
+	ptr->for_each_thingyA([&](dcon::thingyA_id id) {
+		ptr->for_each_adjacent_neighbor(id, [&](dcon::thingyA_id m) {
+			REQUIRE(std::abs(m.index() - id.index()) == 1);
+		});
+	});
+
+	auto by_curve = ptr->thingyA_order_by_curve(
+		[&](dcon::thingyA_id id) { return float(ptr->thingyA_get_some_value(id)); },
+		[](dcon::thingyA_id) { return 0.0f; }, dcon::space_filling_curve::morton);
+	REQUIRE(by_curve.size() == 5);
+	for(size_t i = 1; i < by_curve.size(); ++i)
+		REQUIRE(ptr->thingyA_get_some_value(by_curve[i - 1]) < ptr->thingyA_get_some_value(by_curve[i]));
+}
+
+TEST_CASE("command buffer playback", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	auto existing_a = ptr->create_thingyA();
+	auto existing_b = ptr->create_thingyB();
+	auto doomed_b = ptr->create_thingyB();
+	ptr->thingyB_set_some_value(existing_b, 1);
+
+	dcon::command_buffer buffer(2);
+	std::array<std::thread, 2> workers;
+	for(uint32_t t = 0; t < 2; ++t) {
+		workers[t] = std::thread([&, t]() {
+			auto& rec = buffer.for_thread(t);
+			for(int32_t i = 0; i < 3; ++i) {
+				auto a = rec.create_thingyA();
+				rec.thingyA_set_some_value(a, int32_t(10 * t + i));
+				auto b = rec.create_thingyB();
+				rec.thingyB_set_some_value(b, int32_t(100 + 10 * t + i));
+				rec.try_create_relate_in_list(a, b);
+			}
+			rec.try_create_relate_in_array(existing_a, existing_b);
+			rec.delete_thingyB(doomed_b);
+		});
+	}
+	for(auto& w : workers)
+		w.join();
+
+	// nothing is applied until playback
+	REQUIRE(ptr->thingyA_size() == 1);
+	buffer.playback(*ptr);
+
+	REQUIRE(ptr->thingyA_size() == 7);
+	REQUIRE(ptr->thingyB_live_count() == 7);
+	REQUIRE(!ptr->thingyB_is_valid(doomed_b));
+
+	// creations are numbered by thread index, then by sequence
+	for(int32_t i = 0; i < 6; ++i) {
+		auto a = dcon::thingyA_id(dcon::thingyA_id::value_base_t(1 + i));
+		REQUIRE(ptr->thingyA_get_some_value(a) == 10 * (i / 3) + i % 3);
+		auto b = ptr->relate_in_list_get_right(ptr->thingyA_get_relate_in_list_as_left(a));
+		REQUIRE(ptr->thingyB_get_some_value(b) == 100 + ptr->thingyA_get_some_value(a));
+	}
+	REQUIRE(ptr->relate_in_array_get_right(ptr->thingyA_get_relate_in_array_as_left(existing_a)) == existing_b);
+
+	// playback leaves the buffer empty
+	buffer.playback(*ptr);
+	REQUIRE(ptr->thingyA_size() == 7);
+}
+
+TEST_CASE("command buffer playback follows relationships", "[relationships_tests]") {
+	auto ptr = std::make_unique< dcon::data_container >();
+
+	std::array<dcon::thingyA_id, 6> a;
+	for(auto& v : a)
+		v = ptr->create_thingyA();
+	auto doomed = ptr->try_create_relate_as_multipleB(a[0], a[1]);
+	REQUIRE(bool(doomed));
+
+	dcon::command_buffer buffer(2);
+	// the first force create deletes the doomed instance, and the second one reuses its handle
+	buffer.for_thread(0).force_create_relate_as_multipleB(a[0], a[2]);
+	buffer.for_thread(0).force_create_relate_as_multipleB(a[3], a[4]);
+	buffer.for_thread(1).delete_relate_as_multipleB(doomed);
+	buffer.playback(*ptr);
+
+	REQUIRE(ptr->relate_as_multipleB_is_valid(doomed));
+	REQUIRE(ptr->relate_as_multipleB_get_left(doomed, 0) == a[3]);
+	REQUIRE(bool(ptr->thingyA_get_relate_as_multipleB(a[0])));
+	REQUIRE(bool(ptr->thingyA_get_relate_as_multipleB(a[3])));
+	REQUIRE(!bool(ptr->thingyA_get_relate_as_multipleB(a[1])));
+
+	// the tracker is detached once playback is done
+	ptr->delete_relate_as_multipleB(doomed);
+	REQUIRE(!bool(ptr->thingyA_get_relate_as_multipleB(a[3])));
+}
@@ -248,6 +248,7 @@ namespace ns {
 			}
 			m_custom_struct;
 			
+			std::vector<dcon::bitfield_type> pending_delete = std::vector<dcon::bitfield_type>(150);
 			uint32_t size_used = 0;
 
 
@@ -277,6 +278,7 @@ namespace ns {
 			}
 			m_some_value;
 			
+			std::vector<dcon::bitfield_type> pending_delete = std::vector<dcon::bitfield_type>(38);
 			uint32_t size_used = 0;
 
 
@@ -1590,6 +1592,9 @@ namespace ns {
 			} else if(new_size > old_size) {
 			}
 			thingy.size_used = new_size;
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(thingy.pending_delete.data(), int32_t(i), false);
+			}
 		}
 		
 		//
@@ -1606,6 +1611,125 @@ namespace ns {
 			return new_id;
 		}
 		
+		//
+		// container batch create for thingy
+		//
+		thingy_id create_thingy_batch(uint32_t count) {
+			if(count == 0) return thingy_id();
+			const uint32_t first = thingy.size_used;
+			thingy_resize(first + count);
+			return thingy_id(thingy_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for thingy
+		//
+		void internal_move_thingy(thingy_id last_id, thingy_id id_removed) {
+			dcon::bit_vector_set(thingy.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(thingy.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(thingy.pending_delete.data(), last_id.index(), false);
+			thingy_for_each_dummy_rel_as_left(last_id, [this, id_removed, last_id](dummy_rel_id i) {
+				dummy_rel.hashm_joint.erase(dummy_rel.to_joint_keydata(dummy_rel.m_left.vptr()[i.index()], thingy2_id(thingy2_id::value_base_t(i.index()))));
+				dummy_rel.m_left.vptr()[i.index()] = id_removed;
+				dummy_rel.hashm_joint.insert_or_assign(dummy_rel.to_joint_keydata(dummy_rel.m_left.vptr()[i.index()], thingy2_id(thingy2_id::value_base_t(i.index()))), i);
+			} );
+			dummy_rel.m_array_left.vptr()[id_removed.index()] = std::move(dummy_rel.m_array_left.vptr()[last_id.index()]);
+			dummy_rel.m_array_left.vptr()[last_id.index()] = std::vector<dummy_rel_id>{};
+			thingy.m_i_value.vptr()[id_removed.index()] = std::move(thingy.m_i_value.vptr()[last_id.index()]);
+			thingy.m_i_value.vptr()[last_id.index()] = int16_t{};
+			thingy.m_f_value.vptr()[id_removed.index()] = std::move(thingy.m_f_value.vptr()[last_id.index()]);
+			thingy.m_f_value.vptr()[last_id.index()] = float{};
+			thingy.m_obj_value.vptr()[id_removed.index()] = std::move(thingy.m_obj_value.vptr()[last_id.index()]);
+			thingy.m_obj_value.vptr()[last_id.index()] = c_struct_b{};
+			thingy.m_custom_struct.vptr()[id_removed.index()] = std::move(thingy.m_custom_struct.vptr()[last_id.index()]);
+			thingy.m_custom_struct.vptr()[last_id.index()] = c_struct{};
+		}
+		
+		public:
+		//
+		// container reorder for thingy
+		//
+		void reorder_thingy(thingy_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = thingy.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<thingy_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = thingy_id(thingy_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == thingy_id(thingy_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = thingy_id(thingy_id::value_base_t(count));
+			#ifndef DCON_USE_EXCEPTIONS
+			if(thingy.size_used >= 1200) std::abort();
+			#else
+			if(thingy.size_used >= 1200) throw dcon::out_of_space{};
+			#endif
+			++thingy.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = thingy_id(thingy_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_thingy(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_thingy(scratch, dest);
+						break;
+					}
+					internal_move_thingy(src, dest);
+					dest = src;
+				}
+			}
+			--thingy.size_used;
+		}
+		template<typename F>
+		std::vector<thingy_id> thingy_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(thingy_id()))>;
+			std::vector<key_type> keys;
+			std::vector<thingy_id> result;
+			keys.reserve(thingy.size_used);
+			result.reserve(thingy.size_used);
+			for(uint32_t i = 0; i < thingy.size_used; ++i) {
+				auto id = thingy_id(thingy_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](thingy_id a, thingy_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<thingy_id> thingy_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = thingy.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = thingy_id(thingy_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return thingy_order_by([&](thingy_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container compactable delete for thingy
 		//
@@ -1616,8 +1740,11 @@ namespace ns {
 			assert(uint32_t(id.index()) < thingy.size_used );
 			assert(thingy.size_used != 0);
 			#endif
+			dcon::bit_vector_set(thingy.pending_delete.data(), id_removed.index(), false);
 			thingy_id last_id(thingy_id::value_base_t(thingy.size_used - 1));
 			if(id_removed == last_id) { pop_back_thingy(); return; }
+			dcon::bit_vector_set(thingy.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(thingy.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(thingy.pending_delete.data(), last_id.index(), false);
 			thingy_remove_all_dummy_rel_as_left(id_removed);
 			thingy_for_each_dummy_rel_as_left(last_id, [this, id_removed, last_id](dummy_rel_id i) {
 				dummy_rel.hashm_joint.erase(dummy_rel.to_joint_keydata(dummy_rel.m_left.vptr()[i.index()], thingy2_id(thingy2_id::value_base_t(i.index()))));
@@ -1637,6 +1764,58 @@ namespace ns {
 			--thingy.size_used;
 		}
 		
+		//
+		// container batch delete for thingy
+		//
+		void delete_thingy_batch(thingy_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((thingy.size_used + 7) / 8);
+			std::vector<thingy_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!thingy_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			std::sort(victims.begin(), victims.end(), [](thingy_id a, thingy_id b){ return a.value < b.value; });
+			size_t low = 0;
+			size_t high = victims.size();
+			while(low < high) {
+				thingy_id last_id(thingy_id::value_base_t(thingy.size_used - 1));
+				if(victims[high - 1] == last_id) {
+					delete_thingy(last_id);
+					--high;
+				} else {
+					delete_thingy(victims[low]);
+					++low;
+				}
+			}
+		}
+		
+		//
+		// container deferred delete for thingy
+		//
+		void queue_delete_thingy(thingy_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < thingy.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(thingy.pending_delete.data(), id.index());
+		}
+		bool thingy_is_pending_delete(thingy_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(thingy.pending_delete.data(), id.index());
+		}
+		void commit_deletes_thingy() {
+			const uint32_t count = thingy_size();
+			std::vector<thingy_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(thingy.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(thingy.pending_delete.data(), i + 1, count)) {
+				victims.push_back(thingy_id(thingy_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(thingy.pending_delete.begin(), thingy.pending_delete.end(), dcon::bitfield_type{0});
+			delete_thingy_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container pop_back for thingy2
 		//
@@ -1664,6 +1843,9 @@ namespace ns {
 			} else if(new_size > old_size) {
 			}
 			thingy2.size_used = new_size;
+			for(uint32_t i = new_size; i < old_size; ++i) {
+				dcon::bit_vector_set(thingy2.pending_delete.data(), int32_t(i), false);
+			}
 		}
 		
 		//
@@ -1680,6 +1862,113 @@ namespace ns {
 			return new_id;
 		}
 		
+		//
+		// container batch create for thingy2
+		//
+		thingy2_id create_thingy2_batch(uint32_t count) {
+			if(count == 0) return thingy2_id();
+			const uint32_t first = thingy2.size_used;
+			thingy2_resize(first + count);
+			return thingy2_id(thingy2_id::value_base_t(first));
+		}
+		
+		private:
+		//
+		// container move object for thingy2
+		//
+		void internal_move_thingy2(thingy2_id last_id, thingy2_id id_removed) {
+			dcon::bit_vector_set(thingy2.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(thingy2.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(thingy2.pending_delete.data(), last_id.index(), false);
+			internal_move_relationship_dummy_rel(dummy_rel_id(dummy_rel_id::value_base_t(last_id.index())), dummy_rel_id(dummy_rel_id::value_base_t(id_removed.index())));
+			thingy2.m_some_value.vptr()[id_removed.index()] = std::move(thingy2.m_some_value.vptr()[last_id.index()]);
+			thingy2.m_some_value.vptr()[last_id.index()] = int32_t{};
+		}
+		
+		public:
+		//
+		// container reorder for thingy2
+		//
+		void reorder_thingy2(thingy2_id const* new_order, uint32_t new_order_count) {
+			const uint32_t count = thingy2.size_used;
+			#ifndef NDEBUG
+			assert(new_order_count == count);
+			#endif
+			std::vector<thingy2_id> new_position(count);
+			bool is_identity = true;
+			for(uint32_t i = 0; i < count; ++i) {
+				#ifndef NDEBUG
+				assert(!bool(new_position[new_order[i].index()]));
+				#endif
+				new_position[new_order[i].index()] = thingy2_id(thingy2_id::value_base_t(i));
+				is_identity = is_identity && new_order[i] == thingy2_id(thingy2_id::value_base_t(i));
+			}
+			if(is_identity) return;
+			auto scratch = thingy2_id(thingy2_id::value_base_t(count));
+			#ifndef DCON_USE_EXCEPTIONS
+			if(thingy2.size_used >= 300) std::abort();
+			#else
+			if(thingy2.size_used >= 300) throw dcon::out_of_space{};
+			#endif
+			++thingy2.size_used;
+			std::vector<dcon::bitfield_type> placed((count + 7) / 8);
+			for(uint32_t i = 0; i < count; ++i) {
+				auto start = thingy2_id(thingy2_id::value_base_t(i));
+				if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;
+				internal_move_thingy2(start, scratch);
+				auto dest = start;
+				while(true) {
+					dcon::bit_vector_set(placed.data(), dest.index(), true);
+					auto src = new_order[dest.index()];
+					if(src == start) {
+						internal_move_thingy2(scratch, dest);
+						break;
+					}
+					internal_move_thingy2(src, dest);
+					dest = src;
+				}
+			}
+			--thingy2.size_used;
+		}
+		template<typename F>
+		std::vector<thingy2_id> thingy2_order_by(F&& key) const {
+			using key_type = std::decay_t<decltype(key(thingy2_id()))>;
+			std::vector<key_type> keys;
+			std::vector<thingy2_id> result;
+			keys.reserve(thingy2.size_used);
+			result.reserve(thingy2.size_used);
+			for(uint32_t i = 0; i < thingy2.size_used; ++i) {
+				auto id = thingy2_id(thingy2_id::value_base_t(i));
+				keys.push_back(key(id));
+				result.push_back(id);
+			}
+			std::stable_sort(result.begin(), result.end(), [&](thingy2_id a, thingy2_id b) { return keys[a.index()] < keys[b.index()]; });
+			return result;
+		}
+		template<typename FX, typename FY>
+		std::vector<thingy2_id> thingy2_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const {
+			const uint32_t count = thingy2.size_used;
+			std::vector<float> xs(count);
+			std::vector<float> ys(count);
+			float min_x = std::numeric_limits<float>::max();
+			float max_x = std::numeric_limits<float>::lowest();
+			float min_y = std::numeric_limits<float>::max();
+			float max_y = std::numeric_limits<float>::lowest();
+			for(uint32_t i = 0; i < count; ++i) {
+				auto id = thingy2_id(thingy2_id::value_base_t(i));
+				xs[i] = float(x(id));
+				ys[i] = float(y(id));
+				min_x = std::min(min_x, xs[i]);
+				max_x = std::max(max_x, xs[i]);
+				min_y = std::min(min_y, ys[i]);
+				max_y = std::max(max_y, ys[i]);
+			}
+			return thingy2_order_by([&](thingy2_id id) {
+				auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);
+				auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);
+				return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);
+			} );
+		}
+		
 		//
 		// container compactable delete for thingy2
 		//
@@ -1690,8 +1979,11 @@ namespace ns {
 			assert(uint32_t(id.index()) < thingy2.size_used );
 			assert(thingy2.size_used != 0);
 			#endif
+			dcon::bit_vector_set(thingy2.pending_delete.data(), id_removed.index(), false);
 			thingy2_id last_id(thingy2_id::value_base_t(thingy2.size_used - 1));
 			if(id_removed == last_id) { pop_back_thingy2(); return; }
+			dcon::bit_vector_set(thingy2.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(thingy2.pending_delete.data(), last_id.index()));
+			dcon::bit_vector_set(thingy2.pending_delete.data(), last_id.index(), false);
 			delete_dummy_rel(dummy_rel_id(dummy_rel_id::value_base_t(id_removed.index())));
 			internal_move_relationship_dummy_rel(dummy_rel_id(dummy_rel_id::value_base_t(last_id.index())), dummy_rel_id(dummy_rel_id::value_base_t(id_removed.index())));
 			thingy2.m_some_value.vptr()[id_removed.index()] = std::move(thingy2.m_some_value.vptr()[last_id.index()]);
@@ -1699,6 +1991,58 @@ namespace ns {
 			--thingy2.size_used;
 		}
 		
+		//
+		// container batch delete for thingy2
+		//
+		void delete_thingy2_batch(thingy2_id const* ids, uint32_t count) {
+			std::vector<dcon::bitfield_type> marked((thingy2.size_used + 7) / 8);
+			std::vector<thingy2_id> victims;
+			victims.reserve(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto id = ids[k];
+				if(!thingy2_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;
+				dcon::bit_vector_set(marked.data(), id.index(), true);
+				victims.push_back(id);
+			}
+			std::sort(victims.begin(), victims.end(), [](thingy2_id a, thingy2_id b){ return a.value < b.value; });
+			size_t low = 0;
+			size_t high = victims.size();
+			while(low < high) {
+				thingy2_id last_id(thingy2_id::value_base_t(thingy2.size_used - 1));
+				if(victims[high - 1] == last_id) {
+					delete_thingy2(last_id);
+					--high;
+				} else {
+					delete_thingy2(victims[low]);
+					++low;
+				}
+			}
+		}
+		
+		//
+		// container deferred delete for thingy2
+		//
+		void queue_delete_thingy2(thingy2_id id) noexcept {
+			if(!bool(id)) return;
+			#ifndef NDEBUG
+			assert(uint32_t(id.index()) < thingy2.pending_delete.size() * 8);
+			#endif
+			dcon::bit_vector_atomic_set(thingy2.pending_delete.data(), id.index());
+		}
+		bool thingy2_is_pending_delete(thingy2_id id) const noexcept {
+			return bool(id) && dcon::bit_vector_atomic_test(thingy2.pending_delete.data(), id.index());
+		}
+		void commit_deletes_thingy2() {
+			const uint32_t count = thingy2_size();
+			std::vector<thingy2_id> victims;
+			for(uint32_t i = dcon::bit_vector_next_set(thingy2.pending_delete.data(), 0, count); i < count; i = dcon::bit_vector_next_set(thingy2.pending_delete.data(), i + 1, count)) {
+				victims.push_back(thingy2_id(thingy2_id::value_base_t(i)));
+			}
+			if(victims.empty()) return;
+			std::fill(thingy2.pending_delete.begin(), thingy2.pending_delete.end(), dcon::bitfield_type{0});
+			delete_thingy2_batch(victims.data(), uint32_t(victims.size()));
+		}
+		
 		//
 		// container resize for dummy_rel
 		//
@@ -1792,6 +2136,76 @@ namespace ns {
 			return new_id;
 		}
 		
+		//
+		// container bulk create relationship for dummy_rel
+		//
+		struct dummy_rel_link_tuple {
+			thingy_id left;
+			thingy2_id right;
+		};
+		uint32_t bulk_create_dummy_rel(dummy_rel_link_tuple const* links, uint32_t link_count, dummy_rel_id* ids_out = nullptr) {
+			std::vector<uint32_t> accepted;
+			accepted.reserve(link_count);
+			std::vector<dcon::bitfield_type> claimed_right((thingy2_size() + 7) / 8);
+			std::vector<decltype(dummy_rel.hashm_joint)::key_type> keys_joint;
+			keys_joint.reserve(link_count);
+			dummy_rel.hashm_joint.reserve(dummy_rel.hashm_joint.size() + link_count);
+			for(uint32_t i = 0; i < link_count; ++i) {
+				if(ids_out) ids_out[i] = dummy_rel_id();
+				auto left_p = links[i].left;
+				if(!bool(left_p)) continue;
+				auto right_p = links[i].right;
+				if(!bool(right_p)) continue;
+				if(dummy_rel_is_valid(dummy_rel_id(dummy_rel_id::value_base_t(right_p.index()))) || (uint32_t(right_p.index()) < claimed_right.size() * 8 && dcon::bit_vector_test(claimed_right.data(), right_p.index()))) continue;
+				auto key_joint = dummy_rel.to_joint_keydata(left_p, right_p);
+				if(bool(right_p)) {
+					if(uint32_t(right_p.index()) >= claimed_right.size() * 8) claimed_right.resize(right_p.index() / 8 + 1);
+					dcon::bit_vector_set(claimed_right.data(), right_p.index(), true);
+				}
+				keys_joint.push_back(key_joint);
+				accepted.push_back(i);
+			}
+			const uint32_t count = uint32_t(accepted.size());
+			if(count == 0) return 0;
+			std::vector<dummy_rel_id> new_ids(count);
+			for(uint32_t k = 0; k < count; ++k) {
+				auto right_p = links[accepted[k]].right;
+				new_ids[k] = dummy_rel_id(dummy_rel_id::value_base_t(right_p.index()));
+				if(thingy2.size_used < uint32_t(right_p.value)) thingy2_resize(uint32_t(right_p.value));
+			}
+			for(uint32_t k = 0; k < count; ++k) {
+				auto const& e = links[accepted[k]];
+				auto new_id = new_ids[k];
+				dummy_rel.m_left.vptr()[new_id.index()] = e.left;
+			}
+			 {
+				std::vector<std::pair<thingy_id, dummy_rel_id>> pending;
+				pending.reserve(size_t(count) * 1);
+				for(uint32_t k = 0; k < count; ++k) {
+					if(auto v = dummy_rel.m_left.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);
+				}
+				std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });
+				for(size_t j = 0; j < pending.size(); ) {
+					auto target = pending[j].first;
+					size_t run_end = j + 1;
+					while(run_end < pending.size() && pending[run_end].first == target) ++run_end;
+					auto& vref = dummy_rel.m_array_left.vptr()[target.index()];
+					vref.reserve(vref.size() + (run_end - j));
+					for(; j < run_end; ++j) vref.push_back(pending[j].second);
+				}
+			}
+			for(uint32_t k = 0; k < count; ++k) dummy_rel.hashm_joint.insert_or_assign(keys_joint[k], new_ids[k]);
+			if(ids_out) {
+				for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];
+			}
+			return count;
+		}
+		
+		void commit_deletes() {
+			commit_deletes_thingy();
+			commit_deletes_thingy2();
+		}
+
 		template <typename T>
 		DCON_RELEASE_INLINE void for_each_thingy(T&& func) {
 			for(uint32_t i = 0; i < thingy.size_used; ++i) {
@@ -1799,6 +2213,31 @@ namespace ns {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_thingy(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(thingy.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, thingy_id, int32_t>)
+						func(thingy_id(thingy_id::value_base_t(i)), thread);
+					else
+						func(thingy_id(thingy_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_thingy(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<thingy_id>(thingy.size_used, identity, [&](thingy_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_thingy;
 		friend internal::object_iterator_thingy;
 		struct {
@@ -1823,6 +2262,31 @@ namespace ns {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_thingy2(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(thingy2.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, thingy2_id, int32_t>)
+						func(thingy2_id(thingy2_id::value_base_t(i)), thread);
+					else
+						func(thingy2_id(thingy2_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_thingy2(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<thingy2_id>(thingy2.size_used, identity, [&](thingy2_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_thingy2;
 		friend internal::object_iterator_thingy2;
 		struct {
@@ -1847,6 +2311,31 @@ namespace ns {
 				func(tmp);
 			}
 		}
+		#ifndef DCON_NO_VE
+		#ifndef VE_NO_TBB
+		template <typename T>
+		void parallel_for_each_dummy_rel(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic) {
+			ve::execute_parallel_chunks(thingy2.size_used, grain, part, [&](uint32_t first, uint32_t last) {
+				[[maybe_unused]] int32_t const thread = ve::thread_index();
+				auto call = [&](uint32_t i) {
+					if constexpr(std::is_invocable_v<T&, dummy_rel_id, int32_t>)
+						func(dummy_rel_id(dummy_rel_id::value_base_t(i)), thread);
+					else
+						func(dummy_rel_id(dummy_rel_id::value_base_t(i)));
+				} ;
+				for(uint32_t i = first; i < last; ++i) {
+					call(i);
+				}
+			} );
+		}
+		template <typename T, typename F, typename C>
+		T reduce_over_dummy_rel(T identity, F&& func, C&& combine) const {
+			return ve::reduce_custom<dummy_rel_id>(thingy2.size_used, identity, [&](dummy_rel_id id) -> T {
+				return T(func(id));
+			} , combine);
+		}
+		#endif
+		#endif
 		friend internal::const_object_iterator_dummy_rel;
 		friend internal::object_iterator_dummy_rel;
 		struct {
@@ -1864,6 +2353,28 @@ namespace ns {
 			}
 		}  in_dummy_rel ;
 		
+		//
+		// container link statistics for dummy_rel left
+		//
+		dcon::link_statistics<thingy_id> dummy_rel_link_stats_left() const {
+			return dummy_rel_link_stats_left(std::numeric_limits<uint32_t>::max(), [](thingy_id, uint32_t) {});
+		}
+		template<typename F>
+		dcon::link_statistics<thingy_id> dummy_rel_link_stats_left(uint32_t threshold, F&& on_exceeded) const {
+			dcon::link_statistics<thingy_id> result;
+			const uint32_t n = thingy_size();
+			for(uint32_t i = 0; i < n; ++i) {
+				auto owner = thingy_id(thingy_id::value_base_t(i));
+				if(!thingy_is_valid(owner)) continue;
+				auto& vref = dummy_rel.m_array_left.vptr()[i];
+				uint32_t degree = uint32_t(vref.size());
+				result.storage_bytes += uint64_t(vref.capacity()) * sizeof(dummy_rel_id);
+				result.record(owner, degree);
+				if(degree > threshold) on_exceeded(owner, degree);
+			}
+			return result;
+		}
+		
 
 
 		void deserialize(std::byte const*& input_buffer, std::vector<float>& obj, std::byte const* end) const;
@@ -1898,6 +2409,19 @@ namespace ns {
 			ve::execute_parallel_exact<thingy_id>(thingy.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_thingy_range(thingy_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<thingy_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<thingy_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<thingy_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, thingy2_id> thingy2_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, thingy2_id>(thingy2.size_used);
 		}
@@ -1914,6 +2438,19 @@ namespace ns {
 			ve::execute_parallel_exact<thingy2_id>(thingy2.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_thingy2_range(thingy2_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<thingy2_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<thingy2_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<thingy2_id>(aligned_end, end - aligned_end));
+		}
 		ve::vectorizable_buffer<float, dummy_rel_id> dummy_rel_make_vectorizable_float_buffer() const noexcept {
 			return ve::vectorizable_buffer<float, dummy_rel_id>(thingy2.size_used);
 		}
@@ -1930,6 +2467,19 @@ namespace ns {
 			ve::execute_parallel_exact<dummy_rel_id>(thingy2.size_used, functor);
 		}
 #endif
+		template<typename F>
+		DCON_RELEASE_INLINE void execute_serial_over_dummy_rel_range(dummy_rel_id first, uint32_t count, F&& functor) {
+			const uint32_t start = uint32_t(first.index());
+			const uint32_t end = start + count;
+			const uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));
+			const uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));
+			if(aligned_start != start)
+				functor(ve::partial_contiguous_tags<dummy_rel_id>(start, aligned_start - start));
+			for(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)
+				functor(ve::contiguous_tags<dummy_rel_id>(i));
+			if(aligned_end != end)
+				functor(ve::partial_contiguous_tags<dummy_rel_id>(aligned_end, end - aligned_end));
+		}
 		#endif
 
 		load_record make_serialize_record_store_simple() const noexcept {
@@ -2672,6 +3222,152 @@ namespace ns {
 	};
 
 
+	//
+	// command buffer
+	//
+	class command_buffer {
+		public:
+		class alignas(64) recorder {
+			friend class command_buffer;
+			dcon::command_arena commands;
+			uint32_t thingy_created = 0;
+			uint32_t thingy2_created = 0;
+			public:
+			dcon::deferred_id<thingy_id> create_thingy() {
+				commands.write(uint16_t(0));
+				return dcon::deferred_id<thingy_id>::make_placeholder(thingy_created++);
+			}
+			void delete_thingy(dcon::deferred_id<thingy_id> id) {
+				commands.write(uint16_t(1));
+				commands.write(id);
+			}
+			void thingy_set_i_value(dcon::deferred_id<thingy_id> id, int16_t value) {
+				commands.write(uint16_t(2));
+				commands.write(id);
+				commands.write(value);
+			}
+			void thingy_set_f_value(dcon::deferred_id<thingy_id> id, float value) {
+				commands.write(uint16_t(3));
+				commands.write(id);
+				commands.write(value);
+			}
+			dcon::deferred_id<thingy2_id> create_thingy2() {
+				commands.write(uint16_t(4));
+				return dcon::deferred_id<thingy2_id>::make_placeholder(thingy2_created++);
+			}
+			void delete_thingy2(dcon::deferred_id<thingy2_id> id) {
+				commands.write(uint16_t(5));
+				commands.write(id);
+			}
+			void thingy2_set_some_value(dcon::deferred_id<thingy2_id> id, int32_t value) {
+				commands.write(uint16_t(6));
+				commands.write(id);
+				commands.write(value);
+			}
+			void try_create_dummy_rel(dcon::deferred_id<thingy_id> left_p, dcon::deferred_id<thingy2_id> right_p) {
+				commands.write(uint16_t(7));
+				commands.write(left_p);
+				commands.write(right_p);
+			}
+			void force_create_dummy_rel(dcon::deferred_id<thingy_id> left_p, dcon::deferred_id<thingy2_id> right_p) {
+				commands.write(uint16_t(8));
+				commands.write(left_p);
+				commands.write(right_p);
+			}
+			void dummy_rel_set_left(dummy_rel_id id, dcon::deferred_id<thingy_id> value) {
+				commands.write(uint16_t(9));
+				commands.write(id);
+				commands.write(value);
+			}
+		};
+		private:
+		std::vector<recorder> recorders;
+		public:
+		explicit command_buffer(uint32_t thread_count) : recorders(thread_count) { }
+		recorder& for_thread(uint32_t thread_index) noexcept {
+			return recorders[thread_index];
+		}
+		void clear() noexcept {
+			for(auto& rec : recorders) {
+				rec.commands.clear();
+				rec.thingy_created = 0;
+				rec.thingy2_created = 0;
+			}
+		}
+		void playback(data_container& dc) {
+			std::vector<uint32_t> thingy_offsets(recorders.size());
+			uint32_t thingy_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				thingy_offsets[r] = thingy_total;
+				thingy_total += recorders[r].thingy_created;
+			}
+			thingy_id thingy_first = thingy_total != 0 ? dc.create_thingy_batch(thingy_total) : thingy_id();
+			auto resolve_thingy = [&](size_t r, dcon::deferred_id<thingy_id> d) {
+				return d.placeholder == 0 ? d.id : thingy_id(thingy_id::value_base_t(thingy_first.index() + thingy_offsets[r] + d.placeholder - 1));
+			} ;
+			std::vector<uint32_t> thingy2_offsets(recorders.size());
+			uint32_t thingy2_total = 0;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				thingy2_offsets[r] = thingy2_total;
+				thingy2_total += recorders[r].thingy2_created;
+			}
+			thingy2_id thingy2_first = thingy2_total != 0 ? dc.create_thingy2_batch(thingy2_total) : thingy2_id();
+			auto resolve_thingy2 = [&](size_t r, dcon::deferred_id<thingy2_id> d) {
+				return d.placeholder == 0 ? d.id : thingy2_id(thingy2_id::value_base_t(thingy2_first.index() + thingy2_offsets[r] + d.placeholder - 1));
+			} ;
+			std::vector<thingy_id> thingy_deletes;
+			std::vector<thingy2_id> thingy2_deletes;
+			for(size_t r = 0; r < recorders.size(); ++r) {
+				auto const& commands = recorders[r].commands;
+				size_t pos = 0;
+				while(pos < commands.size()) {
+					switch(commands.read<uint16_t>(pos)) {
+						case 0:
+							break;
+						case 1:
+							thingy_deletes.push_back(resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos)));
+							break;
+						case 2: {
+							auto id = resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos));
+							dc.thingy_set_i_value(id, commands.read<int16_t>(pos));
+						} break;
+						case 3: {
+							auto id = resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos));
+							dc.thingy_set_f_value(id, commands.read<float>(pos));
+						} break;
+						case 4:
+							break;
+						case 5:
+							thingy2_deletes.push_back(resolve_thingy2(r, commands.read<dcon::deferred_id<thingy2_id>>(pos)));
+							break;
+						case 6: {
+							auto id = resolve_thingy2(r, commands.read<dcon::deferred_id<thingy2_id>>(pos));
+							dc.thingy2_set_some_value(id, commands.read<int32_t>(pos));
+						} break;
+						case 7: {
+							auto left_p = resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos));
+							auto right_p = resolve_thingy2(r, commands.read<dcon::deferred_id<thingy2_id>>(pos));
+							dc.try_create_dummy_rel(left_p, right_p);
+						} break;
+						case 8: {
+							auto left_p = resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos));
+							auto right_p = resolve_thingy2(r, commands.read<dcon::deferred_id<thingy2_id>>(pos));
+							dc.force_create_dummy_rel(left_p, right_p);
+						} break;
+						case 9: {
+							auto id = commands.read<dummy_rel_id>(pos);
+							auto value = resolve_thingy(r, commands.read<dcon::deferred_id<thingy_id>>(pos));
+							dc.dummy_rel_set_left(id, value);
+						} break;
+					}
+				}
+			}
+			dc.delete_thingy_batch(thingy_deletes.data(), uint32_t(thingy_deletes.size()));
+			dc.delete_thingy2_batch(thingy2_deletes.data(), uint32_t(thingy2_deletes.size()));
+			clear();
+		}
+	};
+	
 }
 
 #undef DCON_RELEASE_INLINE
@@ -1,4 +1,5 @@
 #define CATCH_CONFIG_MAIN 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #pragma warning(disable : 4127)
 
 #define DCON_TRAP_INVALID_STORE
@@ -6,6 +7,9 @@
 #include "..\CommonIncludes\catch.hpp"
 #include "..\CommonIncludes\ve.hpp"
 #include "..\CommonIncludes\common_types.hpp"
+#include "..\CommonIncludes\ve_thread_pool.hpp"
+#include <atomic>
+#include <vector>
 
 
 class dummy_id {
@@ -2167,4 +2171,79 @@ TEST_CASE("id variations", "[ve_tests]") {
 	
 }
 
+TEST_CASE("work stealing pool", "[ve_tests]") {
+	ve::thread_pool::set_worker_count(4);
+	REQUIRE(ve::thread_pool::default_pool().worker_count() == 4);
+
+	{
+		std::vector<std::atomic<int32_t>> visits(1000);
+		ve::thread_pool::parallel_for(uint32_t(0), uint32_t(1000), uint32_t(1), [&](uint32_t i) {
+			visits[i].fetch_add(1, std::memory_order_relaxed);
+		}, ve::thread_pool::partitioning::dynamic);
+		for(auto& v : visits)
+			REQUIRE(v.load() == 1);
+	}
+	{
+		std::vector<std::atomic<int32_t>> visits(1000);
+		ve::thread_pool::parallel_for(uint32_t(0), uint32_t(1000), uint32_t(16), [&](uint32_t i) {
+			for(uint32_t j = i; j < i + 16 && j < 1000; ++j)
+				visits[j].fetch_add(1, std::memory_order_relaxed);
+		}, ve::thread_pool::partitioning::static_shares);
+		for(auto& v : visits)
+			REQUIRE(v.load() == 1);
+	}
+	{
+		std::atomic<int64_t> total = 0;
+		ve::thread_pool::parallel_for(int32_t(0), int32_t(64), int32_t(1), [&](int32_t i) {
+			ve::thread_pool::parallel_for(int32_t(0), int32_t(64), int32_t(1), [&](int32_t j) {
+				total.fetch_add(i * 64 + j, std::memory_order_relaxed);
+			}, ve::thread_pool::partitioning::dynamic);
+		}, ve::thread_pool::partitioning::dynamic);
+		REQUIRE(total.load() == int64_t(4096) * 4095 / 2);
+	}
+	{
+		int32_t count = 0;
+		ve::thread_pool::parallel_for(uint32_t(5), uint32_t(5), uint32_t(1), [&](uint32_t) { ++count; }, ve::thread_pool::partitioning::dynamic);
+		REQUIRE(count == 0);
+	}
+
+	ve::thread_pool::set_worker_count(1);
+	{
+		int32_t count = 0;
+		ve::thread_pool::parallel_for(uint32_t(0), uint32_t(100), uint32_t(1), [&](uint32_t) { ++count; }, ve::thread_pool::partitioning::dynamic);
+		REQUIRE(count == 100);
+	}
+}
+
+// hidden from normal runs; run with the [benchmark] tag to time the parallel_for that ve uses, and build once more with
+// PREFER_ONE_TBB (or with MSVC and without VE_BUILTIN_POOL) to compare the built-in pool against the other back ends
+TEST_CASE("parallel_for throughput", "[.][benchmark]") {
+	std::vector<float> values(size_t(1) << 24, 1.0f);
+	const uint32_t chunks = uint32_t(values.size() / 16);
+	auto chunk = [&](uint32_t c) {
+		for(uint32_t j = c * 16; j < c * 16 + 16; ++j)
+			values[j] = values[j] * 0.5f + 1.0f;
+	};
+
+	BENCHMARK("static partitioner, 2^20 chunks of 16 floats") {
+		concurrency::parallel_for(uint32_t(0), chunks, uint32_t(1), chunk, concurrency::static_partitioner());
+		return values[0];
+	};
+	BENCHMARK("auto partitioner, 2^20 chunks of 16 floats") {
+		concurrency::parallel_for(uint32_t(0), chunks, uint32_t(1), chunk, concurrency::auto_partitioner());
+		return values[0];
+	};
+	// the cost of an item grows with its index, so equal shares are badly balanced
+	BENCHMARK("auto partitioner, 2^16 items of skewed work") {
+		std::atomic<uint64_t> total = 0;
+		concurrency::parallel_for(uint32_t(0), uint32_t(1) << 16, uint32_t(1), [&](uint32_t i) {
+			uint64_t acc = i;
+			for(uint32_t k = 0; k < i / 16; ++k)
+				acc = acc * 6364136223846793005ull + 1442695040888963407ull;
+			total.fetch_add(acc, std::memory_order_relaxed);
+		}, concurrency::auto_partitioner());
+		return total.load();
+	};
+}
+
 #undef RELEASE_INLINE
@@ -16,6 +16,9 @@
 #include <limits>
 #include <vector>
 #include <bit>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef _MSC_VER 
 #include <intrin.h>
@@ -65,6 +68,199 @@ namespace dcon {
 		return (v[real_index].v & (uint32_t(1) << sub_index)) != 0;
 	}
 
+	// returns the index of the first set bit in [start, end), or end if there is none
+	inline uint32_t bit_vector_next_set(bitfield_type const* v, uint32_t start, uint32_t end) {
+		if(start >= end)
+			return start;
+		const uint32_t end_byte = (end + 7) >> 3;
+		uint32_t byte_index = start >> 3;
+		uint64_t word = 0;
+		uint32_t chunk = std::min(end_byte - byte_index, uint32_t(8));
+		std::memcpy(&word, v + byte_index, chunk);
+		word >>= (start & 7);
+		while(word == 0) {
+			byte_index += chunk;
+			if(byte_index >= end_byte)
+				return end;
+			chunk = std::min(end_byte - byte_index, uint32_t(8));
+			word = 0;
+			std::memcpy(&word, v + byte_index, chunk);
+			start = byte_index << 3;
+		}
+#ifdef _MSC_VER
+		unsigned long lowest = 0;
+		_BitScanForward64(&lowest, word);
+		return std::min(end, start + uint32_t(lowest));
+#else
+		return std::min(end, start + uint32_t(__builtin_ctzll(word)));
+#endif
+	}
+
+	// returns the index of the last set bit at or before start, or uint32_t(-1) if there is none
+	inline uint32_t bit_vector_prev_set(bitfield_type const* v, uint32_t start) {
+		int32_t byte_index = int32_t(start >> 3);
+		uint32_t bits = uint32_t(v[byte_index].v) & ((uint32_t(2) << (start & 7)) - 1);
+		while(bits == 0) {
+			if(--byte_index < 0)
+				return uint32_t(-1);
+			bits = v[byte_index].v;
+		}
+#ifdef _MSC_VER
+		unsigned long highest = 0;
+		_BitScanReverse(&highest, bits);
+		return uint32_t(byte_index) * 8 + uint32_t(highest);
+#else
+		return uint32_t(byte_index) * 8 + uint32_t(31 - __builtin_clz(bits));
+#endif
+	}
+
+	// for bitsets written from several threads at once: the other bits in the same byte are left intact
+	inline void bit_vector_atomic_set(bitfield_type* v, int32_t index) {
+#ifdef _MSC_VER
+		_InterlockedOr8(reinterpret_cast<char volatile*>(&v[index >> 3].v), char(1 << (index & 7)));
+#else
+		__atomic_fetch_or(&v[index >> 3].v, uint8_t(1 << (index & 7)), __ATOMIC_RELAXED);
+#endif
+	}
+	inline bool bit_vector_atomic_test(bitfield_type const* v, int32_t index) {
+#ifdef _MSC_VER
+		const uint8_t bits = *reinterpret_cast<uint8_t const volatile*>(&v[index >> 3].v); // byte reads are atomic on x86
+#else
+		const uint8_t bits = __atomic_load_n(&v[index >> 3].v, __ATOMIC_RELAXED);
+#endif
+		return (bits & uint8_t(1 << (index & 7))) != 0;
+	}
+
+	// read-modify-write operations on the plain storage of atomic{...} properties (int32_t, uint32_t, int64_t or float)
+#ifndef _MSC_VER
+	constexpr int atomic_success_order(std::memory_order order) noexcept {
+		return order == std::memory_order_relaxed ? __ATOMIC_RELAXED
+			: order == std::memory_order_consume ? __ATOMIC_CONSUME
+			: order == std::memory_order_acquire ? __ATOMIC_ACQUIRE
+			: order == std::memory_order_release ? __ATOMIC_RELEASE
+			: order == std::memory_order_acq_rel ? __ATOMIC_ACQ_REL
+			: __ATOMIC_SEQ_CST;
+	}
+	constexpr int atomic_failure_order(std::memory_order order) noexcept {
+		return order == std::memory_order_release ? __ATOMIC_RELAXED
+			: order == std::memory_order_acq_rel ? __ATOMIC_ACQUIRE
+			: atomic_success_order(order);
+	}
+#endif
+	template<typename T>
+	T atomic_load_relaxed(T const& target) noexcept {
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+#ifdef _MSC_VER
+		return *reinterpret_cast<T const volatile*>(&target); // aligned reads are atomic on x64
+#else
+		T result;
+		__atomic_load(&target, &result, __ATOMIC_RELAXED);
+		return result;
+#endif
+	}
+	template<typename T>
+	bool atomic_compare_exchange(T& target, T& expected, T desired, std::memory_order order) noexcept {
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+#ifdef _MSC_VER
+		// interlocked operations are full barriers, which satisfies every order
+		if constexpr(sizeof(T) == 4) {
+			long e = 0;
+			long d = 0;
+			std::memcpy(&e, &expected, sizeof(T));
+			std::memcpy(&d, &desired, sizeof(T));
+			const long previous = _InterlockedCompareExchange(reinterpret_cast<long volatile*>(&target), d, e);
+			if(previous == e)
+				return true;
+			std::memcpy(&expected, &previous, sizeof(T));
+			return false;
+		} else {
+			__int64 e = 0;
+			__int64 d = 0;
+			std::memcpy(&e, &expected, sizeof(T));
+			std::memcpy(&d, &desired, sizeof(T));
+			const __int64 previous = _InterlockedCompareExchange64(reinterpret_cast<__int64 volatile*>(&target), d, e);
+			if(previous == e)
+				return true;
+			std::memcpy(&expected, &previous, sizeof(T));
+			return false;
+		}
+#else
+		return __atomic_compare_exchange(&target, &expected, &desired, false, atomic_success_order(order), atomic_failure_order(order));
+#endif
+	}
+	template<typename T>
+	T atomic_fetch_add(T& target, T value, std::memory_order order) noexcept {
+		if constexpr(std::is_integral_v<T>) {
+#ifdef _MSC_VER
+			if constexpr(sizeof(T) == 4)
+				return T(_InterlockedExchangeAdd(reinterpret_cast<long volatile*>(&target), long(value)));
+			else
+				return T(_InterlockedExchangeAdd64(reinterpret_cast<__int64 volatile*>(&target), __int64(value)));
+#else
+			return __atomic_fetch_add(&target, value, atomic_success_order(order));
+#endif
+		} else {
+			T previous = atomic_load_relaxed(target);
+			while(!atomic_compare_exchange(target, previous, T(previous + value), order))
+				;
+			return previous;
+		}
+	}
+	template<typename T>
+	T atomic_max(T& target, T value, std::memory_order order) noexcept {
+		T previous = atomic_load_relaxed(target);
+		while(previous < value && !atomic_compare_exchange(target, previous, value, order))
+			;
+		return previous;
+	}
+
+	enum class space_filling_curve : uint8_t {
+		morton, hilbert
+	};
+
+	// interleaves the bits of x and y, with x in the even positions
+	inline uint32_t morton_index(uint16_t x, uint16_t y) {
+		auto spread = [](uint32_t v) {
+			v = (v | (v << 8)) & 0x00FF00FFu;
+			v = (v | (v << 4)) & 0x0F0F0F0Fu;
+			v = (v | (v << 2)) & 0x33333333u;
+			v = (v | (v << 1)) & 0x55555555u;
+			return v;
+		};
+		return spread(x) | (spread(y) << 1);
+	}
+
+	// position of (x, y) along a hilbert curve covering the 65536 x 65536 grid
+	inline uint32_t hilbert_index(uint16_t x, uint16_t y) {
+		uint32_t rx = 0;
+		uint32_t ry = 0;
+		uint32_t d = 0;
+		uint32_t px = x;
+		uint32_t py = y;
+		for(uint32_t s = uint32_t(1) << 15; s > 0; s >>= 1) {
+			rx = (px & s) != 0 ? 1 : 0;
+			ry = (py & s) != 0 ? 1 : 0;
+			d += s * s * ((3 * rx) ^ ry);
+			if(ry == 0) {
+				if(rx == 1) {
+					px = s - 1 - (px & (s - 1));
+					py = s - 1 - (py & (s - 1));
+				}
+				std::swap(px, py);
+			}
+			px &= (s - 1);
+			py &= (s - 1);
+		}
+		return d;
+	}
+
+	inline uint16_t quantize_coordinate(float v, float min_v, float max_v) {
+		if(!(max_v > min_v))
+			return 0;
+		auto const t = (v - min_v) / (max_v - min_v);
+		return uint16_t(std::clamp(t, 0.0f, 1.0f) * 65535.0f);
+	}
+
 	inline bool char_span_equals_str(char const* start, char const* end, char const* n) {
 		while(start != end) {
 			if(*start != *n)
@@ -98,6 +294,122 @@ namespace dcon {
 #endif
 	struct invalid_iterator_type {};
 
+	// a handle recorded into a command_buffer: either an existing instance, or an instance created earlier by the same recorder,
+	// in which case placeholder is one more than the position of that creation among the recorder's creations of that type
+	template<typename id_type>
+	struct deferred_id {
+		id_type id;
+		uint32_t placeholder = 0;
+
+		deferred_id() noexcept = default;
+		deferred_id(id_type i) noexcept : id(i) { }
+
+		static deferred_id make_placeholder(uint32_t creation) noexcept {
+			deferred_id result;
+			result.placeholder = creation + 1;
+			return result;
+		}
+	};
+
+	// marks a cache that is rebuilt on first use after a change; the rebuild is done by only one thread, so const queries
+	// that use the cache may be made from several threads at once, but not at the same time as a change
+	class rebuild_flag {
+		std::atomic<bool> dirty = true;
+		std::mutex rebuild_lock;
+	public:
+		void mark() noexcept {
+			dirty.store(true, std::memory_order_relaxed);
+		}
+		template<typename F>
+		void ensure(F&& rebuild) {
+			if(!dirty.load(std::memory_order_acquire))
+				return;
+			std::lock_guard<std::mutex> lock(rebuild_lock);
+			if(dirty.load(std::memory_order_relaxed)) {
+				rebuild();
+				dirty.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	// follows the instances of a relationship that existed when it was attached through any deletions and moves made while it
+	// stays attached, so that handles taken before then can still be used; it detaches itself when destroyed
+	class relocation_tracker {
+		relocation_tracker** slot = nullptr;
+		std::vector<int32_t> to_current;
+		std::vector<int32_t> to_original;
+	public:
+		relocation_tracker(relocation_tracker*& attach_to, uint32_t size) : slot(&attach_to), to_current(size), to_original(size) {
+			for(uint32_t i = 0; i < size; ++i) {
+				to_current[i] = int32_t(i);
+				to_original[i] = int32_t(i);
+			}
+			attach_to = this;
+		}
+		relocation_tracker(relocation_tracker const&) = delete;
+		relocation_tracker& operator=(relocation_tracker const&) = delete;
+		~relocation_tracker() {
+			*slot = nullptr;
+		}
+
+		void erased(int32_t index) noexcept {
+			if(uint32_t(index) < to_original.size() && to_original[index] >= 0) {
+				to_current[to_original[index]] = -1;
+				to_original[index] = -1;
+			}
+		}
+		// the instance at from is now at to, where nothing was before
+		void moved(int32_t from, int32_t to) noexcept {
+			if(uint32_t(from) >= to_original.size())
+				return;
+			auto const original = to_original[from];
+			to_original[from] = -1;
+			if(uint32_t(to) < to_original.size())
+				to_original[to] = original;
+			if(original >= 0)
+				to_current[original] = uint32_t(to) < to_original.size() ? to : -1;
+		}
+		// -1 if the instance has been deleted
+		int32_t current(int32_t original) const noexcept {
+			return uint32_t(original) < to_current.size() ? to_current[original] : -1;
+		}
+	};
+
+	// the positions [next, end) of a pool of reserved instances that one thread has claimed for concurrent creation
+	struct alignas(64) creation_slab {
+		static constexpr uint32_t max_size = 256;
+
+		uint32_t next = 0;
+		uint32_t end = 0;
+	};
+
+	// recorded commands, stored back to back as raw bytes
+	class command_arena {
+		std::vector<uint8_t> bytes;
+	public:
+		template<typename T>
+		void write(T const& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			auto const pos = bytes.size();
+			bytes.resize(pos + sizeof(T));
+			std::memcpy(bytes.data() + pos, &value, sizeof(T));
+		}
+		template<typename T>
+		T read(size_t& pos) const {
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value;
+			std::memcpy(&value, bytes.data() + pos, sizeof(T));
+			pos += sizeof(T);
+			return value;
+		}
+		size_t size() const noexcept {
+			return bytes.size();
+		}
+		void clear() noexcept {
+			bytes.clear();
+		}
+	};
+
 	template<typename T>
 	class local_vector {
 		// yes, I am aware that boost has a better version of the small vector optimization,
@@ -769,6 +1081,87 @@ namespace dcon {
 
 	}
 
+	// the sorted_ functions below keep the contents of a list ordered by index, and must not be mixed with
+	// the unordered functions above on the same list
+
+	namespace detail {
+		template<typename object_type>
+		object_type* sorted_lower_bound(object_type* first, object_type* last, object_type obj) {
+			// branchless binary search: the loop performs the same sequence of steps for every key
+			const int32_t key = get_index(obj);
+			auto n = last - first;
+			if(n == 0)
+				return first;
+			while(n > 1) {
+				const auto half = n / 2;
+				first = (get_index(first[half]) < key) ? first + half : first;
+				n -= half;
+			}
+			return first + (get_index(*first) < key ? 1 : 0);
+		}
+	}
+
+	template<typename object_type>
+	bool sorted_contains_item(stable_variable_vector_base<object_type> const& storage, stable_mk_2_tag i, object_type obj) {
+		const auto range = get_range(storage, i);
+		auto pos = detail::sorted_lower_bound(range.first, range.second, obj);
+		return pos != range.second && *pos == obj;
+	}
+
+	template<typename object_type>
+	void sorted_add_item(stable_variable_vector_base<object_type>& storage, stable_mk_2_tag& i, object_type obj) {
+		push_back(storage, i, obj);
+		const auto range = get_range(storage, i);
+		auto pos = detail::sorted_lower_bound(range.first, range.second - 1, obj);
+		std::memmove(pos + 1, pos, (range.second - 1 - pos) * sizeof(object_type));
+		*pos = obj;
+	}
+
+	template<typename object_type>
+	void sorted_remove_unique_item(stable_variable_vector_base<object_type>& storage, stable_mk_2_tag i, object_type obj) {
+		const auto range = get_range(storage, i);
+		auto pos = detail::sorted_lower_bound(range.first, range.second, obj);
+		if(pos != range.second && *pos == obj) {
+			std::memmove(pos, pos + 1, (range.second - pos - 1) * sizeof(object_type));
+			pop_back(storage, i);
+		}
+	}
+
+	template<typename object_type>
+	void sorted_remove_all_items(stable_variable_vector_base<object_type>& storage, stable_mk_2_tag& i, object_type obj) {
+		const auto range = get_range(storage, i);
+		auto first = detail::sorted_lower_bound(range.first, range.second, obj);
+		auto last = first;
+		while(last != range.second && *last == obj)
+			++last;
+		if(first != last) {
+			std::memmove(first, last, (range.second - last) * sizeof(object_type));
+			resize(storage, i, uint32_t((range.second - range.first) - (last - first)));
+		}
+	}
+
+	template<typename object_type>
+	void sorted_replace_unique_item(stable_variable_vector_base<object_type>& storage, stable_mk_2_tag& i, object_type obj, object_type new_val) {
+		if(sorted_contains_item(storage, i, obj)) {
+			sorted_remove_unique_item(storage, i, obj);
+			sorted_add_item(storage, i, new_val);
+		}
+	}
+
+	template<typename object_type>
+	void sorted_replace_all_items(stable_variable_vector_base<object_type>& storage, stable_mk_2_tag& i, object_type obj, object_type new_val) {
+		const auto range = get_range(storage, i);
+		auto first = detail::sorted_lower_bound(range.first, range.second, obj);
+		uint32_t count = 0;
+		while(first + count != range.second && *(first + count) == obj)
+			++count;
+		if(count != 0) {
+			sorted_remove_all_items(storage, i, obj);
+			for(uint32_t j = 0; j < count; ++j)
+				sorted_add_item(storage, i, new_val);
+		}
+	}
+
 	template<typename object_type>
 	class dcon_vv_fat_id {
 	private:
@@ -870,6 +1263,430 @@ namespace dcon {
 		}
 	};
 
+	template<typename object_type>
+	class csr_index {
+		// the frozen part of the index: the lists for all targets packed back to back, with
+		// offsets[i] .. offsets[i + 1] giving the range for target i
+
+		std::vector<object_type> values;
+		std::vector<uint32_t> offsets;
+
+		// lists modified since the last freeze are copied out into the overlay and read from there
+		// overlay_slot[i] == 0 means that target i is still read from the frozen data
+
+		std::vector<uint32_t> overlay_slot;
+		std::vector<std::vector<object_type>> overlay;
+
+		std::pair<object_type const*, object_type const*> frozen_range(uint32_t i) const {
+			if(i + 1 < uint32_t(offsets.size()))
+				return std::pair<object_type const*, object_type const*>(values.data() + offsets[i], values.data() + offsets[i + 1]);
+			else
+				return std::pair<object_type const*, object_type const*>(nullptr, nullptr);
+		}
+		std::vector<object_type>& make_mutable(uint32_t i) {
+			if(i >= uint32_t(overlay_slot.size()))
+				overlay_slot.resize(i + 1, uint32_t(0));
+			if(overlay_slot[i] == 0) {
+				auto frozen = frozen_range(i);
+				overlay.emplace_back(frozen.first, frozen.second);
+				overlay_slot[i] = uint32_t(overlay.size());
+			}
+			return overlay[overlay_slot[i] - 1];
+		}
+	public:
+		std::pair<object_type const*, object_type const*> range(uint32_t i) const {
+			if(i < uint32_t(overlay_slot.size()) && overlay_slot[i] != 0) {
+				auto& v = overlay[overlay_slot[i] - 1];
+				return std::pair<object_type const*, object_type const*>(v.data(), v.data() + v.size());
+			}
+			return frozen_range(i);
+		}
+		uint32_t size(uint32_t i) const {
+			auto r = range(i);
+			return uint32_t(r.second - r.first);
+		}
+		bool contains(uint32_t i, object_type obj) const {
+			auto r = range(i);
+			return std::find(r.first, r.second, obj) != r.second;
+		}
+		void push_back(uint32_t i, object_type obj) {
+			make_mutable(i).push_back(obj);
+		}
+		void remove_unique(uint32_t i, object_type obj) {
+			auto r = range(i);
+			if(std::find(r.first, r.second, obj) == r.second)
+				return;
+			auto& v = make_mutable(i);
+			if(auto pos = std::find(v.begin(), v.end(), obj); pos != v.end()) {
+				*pos = v.back();
+				v.pop_back();
+			}
+		}
+		void remove_all(uint32_t i, object_type obj) {
+			auto r = range(i);
+			if(std::find(r.first, r.second, obj) == r.second)
+				return;
+			auto& v = make_mutable(i);
+			v.erase(std::remove(v.begin(), v.end(), obj), v.end());
+		}
+		void replace_unique(uint32_t i, object_type obj, object_type new_val) {
+			auto r = range(i);
+			if(std::find(r.first, r.second, obj) == r.second)
+				return;
+			auto& v = make_mutable(i);
+			if(auto pos = std::find(v.begin(), v.end(), obj); pos != v.end())
+				*pos = new_val;
+		}
+		void replace_all(uint32_t i, object_type obj, object_type new_val) {
+			auto r = range(i);
+			if(std::find(r.first, r.second, obj) == r.second)
+				return;
+			auto& v = make_mutable(i);
+			std::replace(v.begin(), v.end(), obj, new_val);
+		}
+		void clear(uint32_t i) {
+			auto r = range(i);
+			if(r.first != r.second)
+				make_mutable(i).clear();
+		}
+		void load_range(uint32_t i, object_type const* first, object_type const* last) {
+			auto& v = make_mutable(i);
+			v.assign(first, last);
+		}
+		// moves the list of target from into target to, replacing its contents and leaving from empty
+		void move_list(uint32_t from, uint32_t to) {
+			auto r = range(from);
+			if(r.first == r.second) {
+				clear(to);
+			} else {
+				std::vector<object_type> temp(r.first, r.second);
+				make_mutable(to) = std::move(temp);
+				make_mutable(from).clear();
+			}
+		}
+		void clear() {
+			values.clear();
+			offsets.clear();
+			overlay_slot.clear();
+			overlay.clear();
+		}
+		uint32_t pending_changes() const {
+			return uint32_t(overlay.size());
+		}
+		// merges the overlay back into the packed representation
+		void freeze() {
+			if(overlay.empty())
+				return;
+
+			const uint32_t frozen_count = offsets.empty() ? uint32_t(0) : uint32_t(offsets.size() - 1);
+			const uint32_t target_count = std::max(frozen_count, uint32_t(overlay_slot.size()));
+
+			std::vector<uint32_t> new_offsets(target_count + 1);
+			uint32_t total = 0;
+			for(uint32_t i = 0; i < target_count; ++i) {
+				new_offsets[i] = total;
+				total += size(i);
+			}
+			new_offsets[target_count] = total;
+
+			std::vector<object_type> new_values(total);
+			for(uint32_t i = 0; i < target_count; ++i) {
+				auto r = range(i);
+				std::copy(r.first, r.second, new_values.data() + new_offsets[i]);
+			}
+
+			values = std::move(new_values);
+			offsets = std::move(new_offsets);
+			overlay_slot.clear();
+			overlay.clear();
+		}
+	};
+
+	// summary of the lists stored for a many link, as produced by the generated link_stats functions
+	// bucket 0 of the histogram counts empty lists, and bucket k counts lists with 2^(k-1) to 2^k - 1 entries
+	template<typename owner_type>
+	struct link_statistics {
+		std::array<uint32_t, 33> degree_histogram = {};
+		owner_type max_degree_owner;
+		uint32_t max_degree = 0;
+		uint32_t owner_count = 0;
+		uint64_t total_links = 0;
+		uint64_t storage_bytes = 0;
+
+		void record(owner_type owner, uint32_t degree) {
+			++degree_histogram[degree == 0 ? 0 : detail::rt_log2(degree) + 1];
+			if(degree > max_degree || !bool(max_degree_owner)) {
+				max_degree = degree;
+				max_degree_owner = owner;
+			}
+			++owner_count;
+			total_links += degree;
+		}
+		double mean_degree() const {
+			return owner_count != 0 ? double(total_links) / double(owner_count) : 0.0;
+		}
+	};
+
+	// per stripe of 64 instances, the number of writes that have begun and the number that have finished. The counts
+	// are kept apart and only ever compared for equality, so they may wrap around freely (start exists so that the
+	// wrap around can be tested). A reader retries if a write to its stripes was in progress or began while it ran.
+	class write_stripes {
+		std::unique_ptr<std::atomic<uint32_t>[]> begun;
+		std::unique_ptr<std::atomic<uint32_t>[]> finished;
+		uint32_t stripe_count = 1;
+	public:
+		explicit write_stripes(uint32_t stripes, uint32_t start = 0) : begun(new std::atomic<uint32_t>[stripes]), finished(new std::atomic<uint32_t>[stripes]), stripe_count(stripes) {
+			for(uint32_t i = 0; i < stripes; ++i) {
+				begun[i].store(start, std::memory_order_relaxed);
+				finished[i].store(start, std::memory_order_relaxed);
+			}
+		}
+
+		// bracket stores to the instances [first, last)
+		void begin(uint32_t first, uint32_t last) noexcept {
+			for(uint32_t c = first >> 6; c <= ((last - 1) >> 6); ++c)
+				begun[c % stripe_count].fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+		void end(uint32_t first, uint32_t last) noexcept {
+			for(uint32_t c = first >> 6; c <= ((last - 1) >> 6); ++c)
+				finished[c % stripe_count].fetch_add(1, std::memory_order_release);
+		}
+
+		// runs func until it completes with no write to the (at most two, adjacent) chunks of 64 instances first_chunk
+		// and last_chunk in progress when it started, or begun while it ran
+		template<typename F>
+		auto read(uint32_t first_chunk, uint32_t last_chunk, F&& func) const -> decltype(func()) {
+			auto const a = first_chunk % stripe_count;
+			auto const b = last_chunk % stripe_count;
+			while(true) {
+				// finished is read first: a write counted in begun is never counted in finished before it
+				uint32_t const a_finished = finished[a].load(std::memory_order_acquire);
+				uint32_t const b_finished = finished[b].load(std::memory_order_acquire);
+				uint32_t const a_begun = begun[a].load(std::memory_order_acquire);
+				uint32_t const b_begun = begun[b].load(std::memory_order_acquire);
+				if(a_begun != a_finished || b_begun != b_finished) {
+					std::this_thread::yield();
+					continue;
+				}
+				if constexpr(std::is_void_v<decltype(func())>) {
+					func();
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if(begun[a].load(std::memory_order_relaxed) == a_begun && begun[b].load(std::memory_order_relaxed) == b_begun)
+						return;
+				} else {
+					auto result = func();
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if(begun[a].load(std::memory_order_relaxed) == a_begun && begun[b].load(std::memory_order_relaxed) == b_begun)
+						return result;
+				}
+			}
+		}
+	};
+
+	// the epochs at which snapshots are currently pinned; pinning and releasing take a lock, while writers
+	// only read newest_pinned and oldest_pinned
+	class epoch_registry {
+		std::atomic<uint64_t> next_epoch{ 1 };
+		std::atomic<uint64_t> newest{ 0 };
+		std::atomic<uint64_t> oldest{ 0 };
+		// stores that are between checking for pinned snapshots and finishing, counted under the phase that was
+		// current when they began; pin flips the phase and waits only for the old one to drain, so it is not held
+		// up by stores that begin afterwards
+		std::atomic<uint32_t> store_phase{ 0 };
+		alignas(64) std::atomic<uint32_t> stores_in_flight[2] = { 0, 0 };
+		std::mutex pins_lock;
+		std::vector<uint64_t> pins;
+
+		void update_bounds() noexcept {
+			newest.store(pins.empty() ? 0 : *std::max_element(pins.begin(), pins.end()), std::memory_order_seq_cst);
+			oldest.store(pins.empty() ? 0 : *std::min_element(pins.begin(), pins.end()), std::memory_order_seq_cst);
+		}
+	public:
+		uint64_t pin() {
+			std::lock_guard<std::mutex> lock(pins_lock);
+			auto const e = next_epoch.fetch_add(1, std::memory_order_seq_cst);
+			pins.push_back(e);
+			update_bounds();
+			// a store that began before the pin was visible did not save a copy, so it has to land before anything is read
+			auto const old_phase = store_phase.fetch_xor(1, std::memory_order_seq_cst);
+			while(stores_in_flight[old_phase].load(std::memory_order_acquire) != 0)
+				std::this_thread::yield();
+			return e;
+		}
+		// bracket each store to a versioned column; may be called from any number of threads at once
+		uint32_t begin_store() noexcept {
+			auto const phase = store_phase.load(std::memory_order_seq_cst);
+			stores_in_flight[phase].fetch_add(1, std::memory_order_seq_cst);
+			return phase;
+		}
+		void end_store(uint32_t phase) noexcept {
+			stores_in_flight[phase].fetch_sub(1, std::memory_order_release);
+		}
+		void release(uint64_t e) {
+			std::lock_guard<std::mutex> lock(pins_lock);
+			if(auto it = std::find(pins.begin(), pins.end(), e); it != pins.end()) {
+				*it = pins.back();
+				pins.pop_back();
+			}
+			update_bounds();
+		}
+		// 0 if nothing is pinned
+		uint64_t newest_pinned() const noexcept {
+			return newest.load(std::memory_order_seq_cst);
+		}
+		uint64_t oldest_pinned() const noexcept {
+			return oldest.load(std::memory_order_acquire);
+		}
+		uint64_t current() const noexcept {
+			return next_epoch.load(std::memory_order_seq_cst);
+		}
+	};
+
+	// copies of chunks of a column (of values, or of bits when T is bitfield_type) saved by the setters before the first
+	// write to the chunk after a snapshot is pinned. Each chunk keeps its copies newest first, labeled with the newest
+	// epoch pinned when the copy was made, and a snapshot reads the oldest copy labeled at or after its own epoch, or the
+	// live column if there is none. Copies that no pinned snapshot can read are unlinked and, once every snapshot that
+	// might still be looking at them is released, freed.
+	template<typename T>
+	class versioned_column {
+	public:
+		static constexpr uint32_t chunk_size = 256;
+		static constexpr uint32_t chunk_elements = std::is_same_v<T, bitfield_type> ? chunk_size / 8 : chunk_size;
+	private:
+		// the saved_label of a chunk while one thread is saving a copy of it; the others wait for it to finish
+		static constexpr uint64_t saving = std::numeric_limits<uint64_t>::max();
+
+		struct version {
+			// aligned like the live columns, so that the same aligned vector loads can read from it
+			alignas(64) T values[chunk_elements];
+			uint64_t label = 0;
+			std::atomic<version*> older{ nullptr };
+		};
+		struct chunk_versions {
+			std::atomic<version*> head{ nullptr };
+			std::atomic<uint64_t> saved_label{ 0 };
+		};
+
+		std::unique_ptr<chunk_versions[]> chunks;
+		uint32_t chunk_count = 0;
+		// only touched when a copy is saved or by reclaim, so a lock costs little
+		std::mutex retired_lock;
+		std::vector<std::pair<uint64_t, version*>> retired;
+
+		version const* find(uint32_t chunk, uint64_t epoch) const noexcept {
+			version const* found = nullptr;
+			for(version const* v = chunks[chunk].head.load(std::memory_order_acquire); v && v->label >= epoch; v = v->older.load(std::memory_order_acquire))
+				found = v;
+			return found;
+		}
+		static void free_chain(version* v) noexcept {
+			while(v) {
+				auto next = v->older.load(std::memory_order_relaxed);
+				delete v;
+				v = next;
+			}
+		}
+		// called only by the thread that holds the chunk (by having claimed its save, or from reclaim)
+		void trim(uint32_t chunk, uint64_t oldest, uint64_t now) {
+			version* prev = nullptr;
+			for(version* v = chunks[chunk].head.load(std::memory_order_relaxed); v; v = v->older.load(std::memory_order_relaxed)) {
+				if(oldest == 0 || v->label < oldest) {
+					if(prev)
+						prev->older.store(nullptr, std::memory_order_seq_cst);
+					else
+						chunks[chunk].head.store(nullptr, std::memory_order_seq_cst);
+					std::lock_guard<std::mutex> lock(retired_lock);
+					retired.emplace_back(now, v);
+					return;
+				}
+				prev = v;
+			}
+		}
+		void free_retired(uint64_t oldest) noexcept {
+			std::lock_guard<std::mutex> lock(retired_lock);
+			auto last = std::remove_if(retired.begin(), retired.end(), [oldest](std::pair<uint64_t, version*> const& r) {
+				if(oldest != 0 && oldest <= r.first)
+					return false;
+				free_chain(r.second);
+				return true;
+			});
+			retired.erase(last, retired.end());
+		}
+	public:
+		explicit versioned_column(uint32_t instances) : chunks(new chunk_versions[(instances + chunk_size - 1) / chunk_size]), chunk_count((instances + chunk_size - 1) / chunk_size) { }
+		versioned_column(versioned_column const&) = delete;
+		versioned_column& operator=(versioned_column const&) = delete;
+		~versioned_column() {
+			for(uint32_t c = 0; c < chunk_count; ++c)
+				free_chain(chunks[c].head.load(std::memory_order_relaxed));
+			for(auto& r : retired)
+				free_chain(r.second);
+		}
+
+		// called by a setter before it stores to the instances [first, last) of the live column; setters on different
+		// instances may call this from several threads at once, and only one of them saves each copy
+		void save(T const* live, uint32_t first, uint32_t last, epoch_registry const& epochs) {
+			auto const newest = epochs.newest_pinned();
+			if(newest == 0 || first >= last)
+				return;
+			bool saved = false;
+			for(uint32_t c = first / chunk_size; c <= (last - 1) / chunk_size; ++c) {
+				auto label = chunks[c].saved_label.load(std::memory_order_acquire);
+				while(label == saving || label < newest) {
+					if(label != saving && chunks[c].saved_label.compare_exchange_weak(label, saving, std::memory_order_acquire, std::memory_order_acquire)) {
+						auto v = new version();
+						v->label = newest;
+						std::memcpy(v->values, live + size_t(c) * chunk_elements, sizeof(v->values));
+						v->older.store(chunks[c].head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+						chunks[c].head.store(v, std::memory_order_release);
+						trim(c, epochs.oldest_pinned(), epochs.current());
+						// the copy must be visible before the stores that follow, here or in the threads waiting for it
+						chunks[c].saved_label.store(newest, std::memory_order_release);
+						saved = true;
+						break;
+					}
+					if(label == saving) {
+						std::this_thread::yield();
+						label = chunks[c].saved_label.load(std::memory_order_acquire);
+					}
+				}
+			}
+			if(saved)
+				free_retired(epochs.oldest_pinned());
+		}
+		// unlinks every copy that no pinned snapshot can read, and frees the ones that nothing can be looking at;
+		// must not run at the same time as any setter
+		void reclaim(epoch_registry const& epochs) {
+			auto const oldest = epochs.oldest_pinned();
+			auto const now = epochs.current();
+			for(uint32_t c = 0; c < chunk_count; ++c)
+				trim(c, oldest, now);
+			free_retired(epochs.oldest_pinned());
+		}
+		// calls f with a pointer to the start of the given chunk as seen by a snapshot pinned at epoch
+		template<typename F>
+		auto read(T const* live, uint32_t chunk, uint64_t epoch, F&& f) const {
+			while(true) {
+				if(auto v = find(chunk, epoch); v)
+					return f(v->values);
+				auto result = f(live + size_t(chunk) * chunk_elements);
+				// a copy saved while the live values were being read replaces them
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(!find(chunk, epoch))
+					return result;
+			}
+		}
+		size_t saved_bytes() const noexcept {
+			size_t total = 0;
+			for(uint32_t c = 0; c < chunk_count; ++c) {
+				for(version const* v = chunks[c].head.load(std::memory_order_relaxed); v; v = v->older.load(std::memory_order_relaxed))
+					total += sizeof(version);
+			}
+			return total;
+		}
+	};
+
 	template <typename T>
 	struct cache_aligned_allocator {
 		using value_type = T;
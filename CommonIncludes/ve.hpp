@@ -10,6 +10,9 @@
 #include <cassert>
 #include <type_traits>
 #include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include "common_types.hpp"
 
 
@@ -17,8 +20,14 @@
 #ifdef PREFER_ONE_TBB
 #include "oneapi/tbb.h"
 namespace concurrency = oneapi::tbb;
-#else
+#elif defined(_MSC_VER) && !defined(VE_BUILTIN_POOL)
 #include <ppl.h>
+#include <thread>
+#else
+#ifndef VE_BUILTIN_POOL
+#define VE_BUILTIN_POOL
+#endif
+#include "ve_thread_pool.hpp"
 #endif
 #endif
 
@@ -80,16 +89,25 @@ namespace ve {
 
 		RELEASE_INLINE T const& get(index_type i) const noexcept { return vptr()[i.index()]; }
 		RELEASE_INLINE T& get(index_type i) noexcept { return vptr()[i.index()]; }
-		RELEASE_INLINE value_to_vector_type<T> get(contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
-		RELEASE_INLINE value_to_vector_type<T> get(unaligned_contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
-		RELEASE_INLINE value_to_vector_type<T> get(partial_contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
-		RELEASE_INLINE value_to_vector_type<T> get(tagged_vector<index_type> i) const noexcept { return ve::load(i, vptr()); }
+		// the vector accessors are templates so that buffers of types without a vector form (such as int64_t) can still be declared
+		template<typename U = T>
+		RELEASE_INLINE value_to_vector_type<U> get(contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
+		template<typename U = T>
+		RELEASE_INLINE value_to_vector_type<U> get(unaligned_contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
+		template<typename U = T>
+		RELEASE_INLINE value_to_vector_type<U> get(partial_contiguous_tags<index_type> i) const noexcept { return ve::load(i, vptr()); }
+		template<typename U = T>
+		RELEASE_INLINE value_to_vector_type<U> get(tagged_vector<index_type> i) const noexcept { return ve::load(i, vptr()); }
 
 		RELEASE_INLINE void set(index_type i, T value) noexcept { vptr()[i.index()] = value; }
-		RELEASE_INLINE void set(contiguous_tags<index_type> i, value_to_vector_type<T> vin) noexcept { ve::store(i, vptr(), vin); }
-		RELEASE_INLINE void set(unaligned_contiguous_tags<index_type> i, value_to_vector_type<T> vin) noexcept { ve::store(i, vptr(), vin); }
-		RELEASE_INLINE void set(partial_contiguous_tags<index_type> i, value_to_vector_type<T> vin) noexcept { ve::store(i, vptr(), vin); }
-		RELEASE_INLINE void set(tagged_vector<index_type> i, value_to_vector_type<T> vin) noexcept { ve::store(i, vptr(), vin); }
+		template<typename U = T>
+		RELEASE_INLINE void set(contiguous_tags<index_type> i, value_to_vector_type<U> vin) noexcept { ve::store(i, vptr(), vin); }
+		template<typename U = T>
+		RELEASE_INLINE void set(unaligned_contiguous_tags<index_type> i, value_to_vector_type<U> vin) noexcept { ve::store(i, vptr(), vin); }
+		template<typename U = T>
+		RELEASE_INLINE void set(partial_contiguous_tags<index_type> i, value_to_vector_type<U> vin) noexcept { ve::store(i, vptr(), vin); }
+		template<typename U = T>
+		RELEASE_INLINE void set(tagged_vector<index_type> i, value_to_vector_type<U> vin) noexcept { ve::store(i, vptr(), vin); }
 
 	};
 
@@ -202,6 +220,33 @@ namespace ve {
 		}
 	}
 
+	// adds the value in each lane to dest at the index in that lane, skipping lanes with an invalid index; lanes
+	// that share an index are added one after another, in lane order
+	template<typename U>
+	RELEASE_INLINE void scatter_add(tagged_vector<U> indices, float* dest, fp_vector values) {
+#ifdef VE_CONFLICT_SCATTER_ADD
+		conflict_scatter_add(indices, dest, values);
+#else
+		for(int32_t i = 0; i < vector_size; ++i) {
+			if(auto const index = indices[i].index(); index >= 0)
+				dest[index] += values[i];
+		}
+#endif
+	}
+	template<typename U, typename I>
+	RELEASE_INLINE auto scatter_add(tagged_vector<U> indices, I* dest, int_vector values) -> std::enable_if_t<std::numeric_limits<I>::is_integer && sizeof(I) <= 4, void> {
+#ifdef VE_CONFLICT_SCATTER_ADD
+		if constexpr(sizeof(I) == 4) {
+			conflict_scatter_add(indices, dest, values);
+			return;
+		}
+#endif
+		for(int32_t i = 0; i < vector_size; ++i) {
+			if(auto const index = indices[i].index(); index >= 0)
+				dest[index] = I(dest[index] + values[i]);
+		}
+	}
+
 #ifndef VE_NO_TBB
 	template<typename tag_type, typename F>
 	RELEASE_INLINE void execute_parallel(uint32_t start, uint32_t count, F&& functor) {
@@ -352,6 +397,120 @@ namespace ve {
 	RELEASE_INLINE void execute_parallel_exact(uint32_t count, F&& functor) {
 		execute_parallel_exact<tag_type>(0, count, functor);
 	}
+
+	enum class partitioning : uint8_t { dynamic, static_shares };
+
+	// an index below thread_count() that is not shared with any other thread running parallel work at the same time
+	inline int32_t thread_index() noexcept {
+#ifdef PREFER_ONE_TBB
+		const int32_t i = oneapi::tbb::this_task_arena::current_thread_index();
+		return i < 0 ? 0 : i;
+#elif defined(VE_BUILTIN_POOL)
+		const int32_t i = ve::thread_pool::pool::current_thread();
+		return i < 0 ? 0 : i;
+#else
+		// threads outside of the scheduler have no virtual processor and share index 0
+		const unsigned int i = concurrency::Context::VirtualProcessorId();
+		return i == unsigned(-1) ? 0 : int32_t(i) + 1;
+#endif
+	}
+	inline int32_t thread_count() noexcept {
+#ifdef PREFER_ONE_TBB
+		return oneapi::tbb::this_task_arena::max_concurrency();
+#elif defined(VE_BUILTIN_POOL)
+		return int32_t(ve::thread_pool::default_pool().worker_count());
+#else
+		const unsigned int n = concurrency::CurrentScheduler::GetNumberOfVirtualProcessors();
+		return n == unsigned(-1) ? int32_t(std::thread::hardware_concurrency()) + 1 : int32_t(n) + 1;
+#endif
+	}
+
+	// calls functor(first, last) for consecutive chunks of [0, count), each grain indices long except possibly the last
+	template<typename F>
+	RELEASE_INLINE void execute_parallel_chunks(uint32_t count, uint32_t grain, partitioning part, F&& functor) {
+		if(grain == 0)
+			grain = 1;
+		const uint32_t chunks = count / grain + uint32_t(count % grain != 0);
+		auto chunk = [&functor, count, grain](uint32_t c) {
+			const uint32_t first = c * grain;
+			functor(first, first + std::min(count - first, grain));
+		};
+		if(part == partitioning::static_shares)
+			concurrency::parallel_for(uint32_t(0), chunks, uint32_t(1), chunk, concurrency::static_partitioner());
+		else
+			concurrency::parallel_for(uint32_t(0), chunks, uint32_t(1), chunk, concurrency::auto_partitioner());
+	}
+
+	// the number of consecutive indices folded into each partial result of a reduction; fixed so that
+	// the order in which values are combined does not depend on the number of threads
+	constexpr uint32_t reduction_chunk_size = 1024;
+
+	// folds functor(i) for every i in [0, count) with combine, starting each chunk from identity; the chunks are
+	// folded left to right and their results combined pairwise in a fixed tree, so that the same inputs always
+	// produce the same (bitwise) result
+	template<typename tag_type, typename T, typename F, typename C>
+	T reduce_custom(uint32_t count, T identity, F&& functor, C&& combine) {
+		const uint32_t chunks = count / reduction_chunk_size + uint32_t(count % reduction_chunk_size != 0);
+		if(chunks == 0)
+			return identity;
+		// std::vector<bool> packs its elements into shared words, which chunks finishing on different threads would race on
+		using partial_type = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+		std::vector<partial_type> partials(chunks, partial_type(identity));
+		execute_parallel_chunks(count, reduction_chunk_size, partitioning::dynamic, [&](uint32_t first, uint32_t last) {
+			T acc = identity;
+			for(uint32_t i = first; i < last; ++i)
+				acc = combine(acc, functor(tag_type(typename tag_type::value_base_t(i))));
+			partials[first / reduction_chunk_size] = partial_type(acc);
+		});
+		for(uint32_t width = 1; width < chunks; width *= 2) {
+			for(uint32_t i = 0; i + width < chunks; i += width * 2)
+				partials[i] = partial_type(combine(T(partials[i]), T(partials[i + width])));
+		}
+		return T(partials[0]);
+	}
+	template<typename tag_type, typename F>
+	auto reduce_sum(uint32_t count, F&& functor) {
+		using T = std::decay_t<decltype(functor(tag_type()))>;
+		return reduce_custom<tag_type>(count, T(0), std::forward<F>(functor), [](T a, T b) { return a + b; });
+	}
+	template<typename tag_type, typename F>
+	auto reduce_min(uint32_t count, F&& functor) {
+		using T = std::decay_t<decltype(functor(tag_type()))>;
+		constexpr T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+		return reduce_custom<tag_type>(count, identity, std::forward<F>(functor), [](T a, T b) { return b < a ? b : a; });
+	}
+	template<typename tag_type, typename F>
+	auto reduce_max(uint32_t count, F&& functor) {
+		using T = std::decay_t<decltype(functor(tag_type()))>;
+		constexpr T identity = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+		return reduce_custom<tag_type>(count, identity, std::forward<F>(functor), [](T a, T b) { return a < b ? b : a; });
+	}
+
+	// runs functor(tags, T* buffer) over [0, count) in parallel, where buffer is a zero initialized array of dest_size values
+	// private to the calling thread, into which the functor is expected to scatter_add; once every call has returned
+	// the buffers are added into dest
+	template<typename tag_type, typename T, typename F>
+	void scatter_add_parallel(uint32_t count, T* dest, uint32_t dest_size, F&& functor) {
+		std::vector<std::vector<T>> buffers(static_cast<size_t>(thread_count()));
+		execute_parallel_chunks(count, uint32_t(64 * vector_size), partitioning::dynamic, [&](uint32_t first, uint32_t last) {
+			auto& buffer = buffers[size_t(thread_index())];
+			if(buffer.empty())
+				buffer.resize(dest_size, T(0));
+			uint32_t i = first;
+			for(; i + vector_size <= last; i += vector_size)
+				functor(contiguous_tags<tag_type>(i), buffer.data());
+			if(i < last)
+				functor(partial_contiguous_tags<tag_type>(i, last - i), buffer.data());
+		});
+		execute_parallel_chunks(dest_size, uint32_t(4096), partitioning::static_shares, [&](uint32_t first, uint32_t last) {
+			for(auto& buffer : buffers) {
+				if(buffer.empty())
+					continue;
+				for(uint32_t i = first; i < last; ++i)
+					dest[i] += buffer[i];
+			}
+		});
+	}
 #endif
 
 	struct serial_exact {
@@ -1818,6 +1818,37 @@ namespace ve {
 		}
 	}
 
+	// the scatter_add in ve.hpp uses these for float and 32 bit integer values: lanes holding the same index are found
+	// with vpconflictd, and each round adds the lanes that have no earlier duplicate still waiting to be added
+#ifdef __AVX512CD__
+#define VE_CONFLICT_SCATTER_ADD
+	template<typename U>
+	RELEASE_INLINE void conflict_scatter_add(tagged_vector<U> indices, float* dest, fp_vector values) {
+		__mmask16 remaining = _mm512_cmpge_epi32_mask(indices.value, _mm512_setzero_si512());
+		// bit j of lane i is set when lane j < i holds the same index
+		__m512i const conflicts = _mm512_conflict_epi32(indices.value);
+		while(remaining != 0) {
+			// the lanes with no earlier duplicate left to add; these all hold different indices
+			__mmask16 const ready = _mm512_mask_testn_epi32_mask(remaining, conflicts, _mm512_set1_epi32(int32_t(remaining)));
+			__m512 const current = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), ready, indices.value, dest, 4);
+			_mm512_mask_i32scatter_ps(dest, ready, indices.value, _mm512_add_ps(current, values), 4);
+			remaining &= ~ready;
+		}
+	}
+	template<typename U, typename I>
+	RELEASE_INLINE void conflict_scatter_add(tagged_vector<U> indices, I* dest, int_vector values) {
+		static_assert(sizeof(I) == 4);
+		__mmask16 remaining = _mm512_cmpge_epi32_mask(indices.value, _mm512_setzero_si512());
+		__m512i const conflicts = _mm512_conflict_epi32(indices.value);
+		while(remaining != 0) {
+			__mmask16 const ready = _mm512_mask_testn_epi32_mask(remaining, conflicts, _mm512_set1_epi32(int32_t(remaining)));
+			__m512i const current = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ready, indices.value, dest, 4);
+			_mm512_mask_i32scatter_epi32(dest, ready, indices.value, _mm512_add_epi32(current, values.value), 4);
+			remaining &= ~ready;
+		}
+	}
+#endif
+
 	template<typename U>
 	RELEASE_INLINE void store(tagged_vector<U> indices, vbitfield_type mask, float* dest, fp_vector values) {
 		for(int32_t i = 0; i < vector_size; ++i) {
@@ -0,0 +1,370 @@
+#pragma once
+
+//
+// This file provided as part of the DataContainer project
+//
+
+// A dependency-free work-stealing scheduler, used by ve for parallel execution when neither
+// oneTBB (PREFER_ONE_TBB) nor PPL (MSVC) is in use, or when VE_BUILTIN_POOL is defined. With
+// VE_BUILTIN_POOL defined it also provides the small part of the concurrency::parallel_for
+// interface that ve and the generated code use.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ve {
+namespace thread_pool {
+
+	// a contiguous range of iterations [begin, end) belonging to one parallel_for call
+	class job {
+	public:
+		std::atomic<uint32_t> remaining;
+		const uint32_t grain;
+		const bool splittable;
+		// set by the first range to throw; the ranges that have not started yet are then skipped
+		std::atomic<bool> failed{ false };
+		std::exception_ptr error;
+
+		job(uint32_t count, uint32_t grain, bool splittable) noexcept : remaining(count), grain(grain), splittable(splittable) { }
+		virtual void run(uint32_t begin, uint32_t end) = 0;
+
+		void record_failure(std::exception_ptr e) noexcept {
+			bool expected = false;
+			if(failed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+				error = e;
+		}
+	protected:
+		~job() = default;
+	};
+
+	struct range_task {
+		job* owner = nullptr;
+		uint32_t begin = 0;
+		uint32_t end = 0;
+	};
+
+	// Chase-Lev deque with a fixed capacity: the owning thread pushes and pops at the bottom, other
+	// threads steal from the top. A full deque refuses the push and the owner runs the range itself.
+	class task_deque {
+		static constexpr int64_t capacity = 256;
+
+		struct slot {
+			std::atomic<job*> owner{ nullptr };
+			std::atomic<uint32_t> begin{ 0 };
+			std::atomic<uint32_t> end{ 0 };
+		};
+
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+		alignas(64) slot slots[capacity];
+
+		void write(int64_t i, range_task t) noexcept {
+			auto& s = slots[i & (capacity - 1)];
+			s.owner.store(t.owner, std::memory_order_relaxed);
+			s.begin.store(t.begin, std::memory_order_relaxed);
+			s.end.store(t.end, std::memory_order_relaxed);
+		}
+		range_task read(int64_t i) const noexcept {
+			auto& s = slots[i & (capacity - 1)];
+			return range_task{ s.owner.load(std::memory_order_relaxed), s.begin.load(std::memory_order_relaxed), s.end.load(std::memory_order_relaxed) };
+		}
+	public:
+		bool push(range_task t) noexcept {
+			const int64_t b = bottom.load(std::memory_order_relaxed);
+			const int64_t tp = top.load(std::memory_order_acquire);
+			if(b - tp >= capacity)
+				return false;
+			write(b, t);
+			bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+		bool pop(range_task& out) noexcept {
+			const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t tp = top.load(std::memory_order_relaxed);
+			if(tp > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+			out = read(b);
+			if(tp == b) {
+				// the last task: race any thieves for it
+				const bool won = top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+		bool steal(range_task& out) noexcept {
+			int64_t tp = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t b = bottom.load(std::memory_order_acquire);
+			if(tp >= b)
+				return false;
+			auto t = read(tp);
+			if(!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return false;
+			out = t;
+			return true;
+		}
+	};
+
+	class pool {
+		// slot 0 belongs to whichever outside thread is currently calling parallel_for; the worker threads use the rest
+		std::unique_ptr<task_deque[]> deques;
+		std::vector<std::thread> workers;
+		const uint32_t slot_count;
+		std::atomic<uint32_t> epoch{ 0 };
+		std::atomic<uint32_t> sleeping{ 0 };
+		std::atomic<bool> stopping{ false };
+		std::mutex sleep_lock;
+		std::condition_variable wake;
+		std::mutex outside_caller;
+
+		static int32_t& current_slot() noexcept {
+			thread_local int32_t slot = -1;
+			return slot;
+		}
+
+		// new work has been published: the epoch change stops sleepers from going to sleep, and the
+		// lock is only taken when some worker may already be waiting on the condition variable
+		void wake_workers() {
+			epoch.fetch_add(1, std::memory_order_seq_cst);
+			if(sleeping.load(std::memory_order_seq_cst) != 0) {
+				std::lock_guard<std::mutex> lock(sleep_lock);
+				wake.notify_all();
+			}
+		}
+
+		// runs a range, first splitting off the upper halves for other threads to steal; an exception
+		// is stored in the job instead of escaping, so that the range is always counted as finished
+		void execute(uint32_t slot, range_task t) noexcept {
+			auto* j = t.owner;
+			const uint32_t count = t.end - t.begin;
+			if(!j->failed.load(std::memory_order_acquire)) {
+				if(j->splittable) {
+					bool pushed = false;
+					while(t.end - t.begin > j->grain) {
+						const uint32_t mid = t.begin + ((t.end - t.begin) / 2 + j->grain - 1) / j->grain * j->grain;
+						if(mid >= t.end || !deques[slot].push(range_task{ j, mid, t.end }))
+							break;
+						t.end = mid;
+						pushed = true;
+					}
+					if(pushed)
+						wake_workers();
+				}
+				try {
+					j->run(t.begin, t.end);
+				} catch(...) {
+					j->record_failure(std::current_exception());
+				}
+				j->remaining.fetch_sub(t.end - t.begin, std::memory_order_acq_rel);
+			} else {
+				j->remaining.fetch_sub(count, std::memory_order_acq_rel);
+			}
+		}
+		bool try_steal(uint32_t slot, uint32_t& seed, range_task& out) noexcept {
+			seed = seed * 1664525u + 1013904223u;
+			const uint32_t start = seed % slot_count;
+			for(uint32_t i = 0; i < slot_count; ++i) {
+				const uint32_t victim = (start + i) % slot_count;
+				if(victim != slot && deques[victim].steal(out))
+					return true;
+			}
+			return false;
+		}
+		bool run_one(uint32_t slot, uint32_t& seed) {
+			range_task t;
+			if(deques[slot].pop(t) || try_steal(slot, seed, t)) {
+				execute(slot, t);
+				return true;
+			}
+			return false;
+		}
+		void worker_loop(uint32_t slot) {
+			current_slot() = int32_t(slot);
+			uint32_t seed = slot * 2654435761u + 1;
+			while(!stopping.load(std::memory_order_acquire)) {
+				const uint32_t seen = epoch.load(std::memory_order_acquire);
+				bool found = false;
+				for(int32_t spin = 0; spin < 2048 && !found; ++spin) {
+					found = run_one(slot, seed);
+					if(!found)
+						std::this_thread::yield();
+				}
+				if(!found) {
+					std::unique_lock<std::mutex> lock(sleep_lock);
+					sleeping.fetch_add(1, std::memory_order_seq_cst);
+					wake.wait(lock, [&]() {
+						return epoch.load(std::memory_order_seq_cst) != seen || stopping.load(std::memory_order_acquire);
+					});
+					sleeping.fetch_sub(1, std::memory_order_relaxed);
+				}
+			}
+		}
+	public:
+		explicit pool(uint32_t worker_count) : slot_count(worker_count < 1 ? 1 : worker_count) {
+			deques = std::unique_ptr<task_deque[]>(new task_deque[slot_count]);
+			for(uint32_t i = 1; i < slot_count; ++i)
+				workers.emplace_back([this, i]() { worker_loop(i); });
+		}
+		~pool() {
+			{
+				std::lock_guard<std::mutex> lock(sleep_lock);
+				stopping.store(true, std::memory_order_release);
+				wake.notify_all();
+			}
+			for(auto& w : workers)
+				w.join();
+		}
+		pool(pool const&) = delete;
+		pool& operator=(pool const&) = delete;
+
+		uint32_t worker_count() const noexcept {
+			return slot_count;
+		}
+		// the index of the calling thread's deque, or -1 if it is not taking part in any parallel work
+		static int32_t current_thread() noexcept {
+			return current_slot();
+		}
+
+		// runs j over [0, count), with the calling thread taking part until every iteration is done; if any
+		// iteration throws, the iterations that have not started are skipped and the first exception is
+		// rethrown here once the others have finished
+		void run(job& j, uint32_t count, uint32_t initial_chunks) {
+			if(count == 0)
+				return;
+			if(slot_count == 1) {
+				j.run(0, count);
+				j.remaining.store(0, std::memory_order_relaxed);
+				return;
+			}
+			std::unique_lock<std::mutex> outside_lock;
+			int32_t slot = current_slot();
+			const bool outside = slot < 0;
+			if(outside) {
+				outside_lock = std::unique_lock<std::mutex>(outside_caller);
+				slot = 0;
+				current_slot() = 0;
+			}
+
+			const uint32_t chunks = initial_chunks < 1 ? 1 : (initial_chunks > count ? count : initial_chunks);
+			for(uint32_t c = chunks; c-- > 1; ) {
+				const uint32_t b = uint32_t(uint64_t(count) * c / chunks);
+				const uint32_t e = uint32_t(uint64_t(count) * (c + 1) / chunks);
+				if(!deques[slot].push(range_task{ &j, b, e }))
+					execute(uint32_t(slot), range_task{ &j, b, e });
+			}
+			wake_workers();
+			execute(uint32_t(slot), range_task{ &j, 0, uint32_t(uint64_t(count) / chunks) });
+
+			uint32_t seed = uint32_t(slot) * 2654435761u + 7;
+			while(j.remaining.load(std::memory_order_acquire) != 0) {
+				if(!run_one(uint32_t(slot), seed))
+					std::this_thread::yield();
+			}
+
+			if(outside)
+				current_slot() = -1;
+			if(j.error)
+				std::rethrow_exception(j.error);
+		}
+	};
+
+	inline std::unique_ptr<pool>& default_pool_storage() {
+		static std::unique_ptr<pool> p;
+		return p;
+	}
+	inline uint32_t default_worker_count() {
+		if(auto env = std::getenv("VE_WORKER_COUNT"); env) {
+			if(auto n = std::atoi(env); n > 0)
+				return uint32_t(n);
+		}
+		auto n = std::thread::hardware_concurrency();
+		return n == 0 ? 1 : n;
+	}
+	inline std::mutex& default_pool_mutex() {
+		static std::mutex m;
+		return m;
+	}
+	inline pool& default_pool() {
+		std::lock_guard<std::mutex> lock(default_pool_mutex());
+		auto& p = default_pool_storage();
+		if(!p)
+			p = std::make_unique<pool>(default_worker_count());
+		return *p;
+	}
+	// replaces the shared pool; must not be called while any parallel work is running
+	inline void set_worker_count(uint32_t count) {
+		std::lock_guard<std::mutex> lock(default_pool_mutex());
+		auto& p = default_pool_storage();
+		p.reset();
+		p = std::make_unique<pool>(count);
+	}
+
+	template<typename I, typename F>
+	class index_job final : public job {
+		I first;
+		I step;
+		F const& func;
+	public:
+		index_job(I first, I step, F const& func, uint32_t count, uint32_t grain, bool splittable) noexcept :
+			job(count, grain, splittable), first(first), step(step), func(func) { }
+		void run(uint32_t begin, uint32_t end) override {
+			for(uint32_t k = begin; k < end; ++k)
+				func(I(first + I(k) * step));
+		}
+	};
+
+	// static: one equal share of the iterations per worker, which are only moved between workers whole;
+	// dynamic: ranges are split in half on demand, down to the grain size, and stolen by idle workers
+	enum class partitioning : uint8_t { static_shares, dynamic };
+
+	template<typename I, typename F>
+	void parallel_for(I first, I last, I step, F const& func, partitioning part, uint32_t grain = 1) {
+		if(!(first < last) || step <= I(0))
+			return;
+		const uint32_t count = uint32_t((last - first + step - I(1)) / step);
+		auto& p = default_pool();
+		// splitting all the way down to single iterations costs more than it balances; aim for a few dozen pieces per worker
+		const uint32_t min_grain = count / (p.worker_count() * 32);
+		index_job<I, F> j(first, step, func, count, grain > min_grain ? grain : (min_grain < 1 ? 1 : min_grain), part == partitioning::dynamic);
+		p.run(j, count, part == partitioning::dynamic ? 1 : p.worker_count());
+	}
+
+}
+}
+
+#ifdef VE_BUILTIN_POOL
+namespace concurrency {
+	struct static_partitioner { };
+	struct auto_partitioner { };
+	struct simple_partitioner { };
+
+	template<typename I, typename F>
+	void parallel_for(I first, I last, I step, F const& func, static_partitioner) {
+		ve::thread_pool::parallel_for(first, last, step, func, ve::thread_pool::partitioning::static_shares);
+	}
+	template<typename I, typename F>
+	void parallel_for(I first, I last, I step, F const& func, auto_partitioner = auto_partitioner{}) {
+		ve::thread_pool::parallel_for(first, last, step, func, ve::thread_pool::partitioning::dynamic);
+	}
+	template<typename I, typename F>
+	void parallel_for(I first, I last, I step, F const& func, simple_partitioner) {
+		ve::thread_pool::parallel_for(first, last, step, func, ve::thread_pool::partitioning::dynamic);
+	}
+	template<typename I, typename F>
+	void parallel_for(I first, I last, F const& func) {
+		ve::thread_pool::parallel_for(first, last, I(1), func, ve::thread_pool::partitioning::dynamic);
+	}
+}
+#endif
@@ -297,6 +297,203 @@ int main(int argc, char *argv[]) {
 			return -1;
 		}
 
+		// resolve traversal paths
+
+		for(auto& tv : parsed_file.traversals) {
+			if(tv.steps.size() == 0) {
+				err.add(row_col_pair{ 0,0 }, 1008, std::string("Traversal ") + tv.name + " has no steps");
+				break;
+			}
+			for(size_t i = 0; i < tv.steps.size(); ++i) {
+				auto& s = tv.steps[i];
+				auto rel = find_by_name(parsed_file, s.relation_name);
+				if(!rel || !rel->is_relationship) {
+					err.add(row_col_pair{ 0,0 }, 1009, std::string("Traversal ") + tv.name + " refers to an unknown relationship: " + s.relation_name);
+					break;
+				}
+				s.rel_ptr = rel;
+				for(auto& l : rel->indexed_objects) {
+					if(l.property_name == s.from_link)
+						s.from = &l;
+					if(l.property_name == s.to_link)
+						s.to = &l;
+				}
+				if(!s.from || !s.to) {
+					err.add(row_col_pair{ 0,0 }, 1010, std::string("Traversal ") + tv.name + " refers to an unknown link in relationship: " + s.relation_name);
+					break;
+				}
+				if(s.from->index == index_type::none) {
+					err.add(row_col_pair{ 0,0 }, 1011, std::string("Traversal ") + tv.name + " steps out of the unindexed link " + s.from_link +
+						" in relationship: " + s.relation_name);
+					break;
+				}
+				if(i == 0) {
+					tv.start_object = s.from->related_to;
+				} else if(tv.steps[i - 1].to->related_to != s.from->related_to) {
+					err.add(row_col_pair{ 0,0 }, 1012, std::string("Traversal ") + tv.name + " has a step from " + s.from->type_name +
+						" that does not follow on from a step to " + tv.steps[i - 1].to->type_name);
+					break;
+				}
+			}
+			if(err.accumulated.length() == 0 && tv.steps.back().to->related_to != tv.start_object) {
+				err.add(row_col_pair{ 0,0 }, 1012, std::string("Traversal ") + tv.name + " does not end at the type of object that it starts from");
+			}
+			if(err.accumulated.length() > 0)
+				break;
+		}
+		if(err.accumulated.length() > 0) {
+			error_to_file(output_file_name);
+			std::cout << err.accumulated;
+			return -1;
+		}
+
+		// check lazy indexes
+
+		for(auto& r : parsed_file.relationship_objects) {
+			for(auto& l : r.indexed_objects) {
+				if(l.is_lazy_index && l.index != index_type::none) {
+					err.add(row_col_pair{ 0,0 }, 1015, std::string("Link ") + l.property_name + " in relationship " + r.name +
+						" must be unindexed to have a lazy index");
+				}
+			}
+		}
+		if(err.accumulated.length() > 0) {
+			error_to_file(output_file_name);
+			std::cout << err.accumulated;
+			return -1;
+		}
+
+		// check hierarchy relationships
+
+		for(auto& r : parsed_file.relationship_objects) {
+			if(r.hierarchy_link.length() == 0)
+				continue;
+			related_object const* parent_link = nullptr;
+			for(auto& l : r.indexed_objects) {
+				if(l.property_name == r.hierarchy_link)
+					parent_link = &l;
+			}
+			if(!parent_link || parent_link->index != index_type::many || parent_link->multiplicity != 1) {
+				err.add(row_col_pair{ 0,0 }, 1013, std::string("Relationship ") + r.name + " must have a many link named "
+					+ r.hierarchy_link + " with a multiplicity of one to be a hierarchy");
+				break;
+			}
+			if(!r.primary_key.points_to || r.primary_key.points_to != parent_link->related_to || r.indexed_objects.size() != 2) {
+				err.add(row_col_pair{ 0,0 }, 1014, std::string("Relationship ") + r.name + " must consist of a primary key link and "
+					+ r.hierarchy_link + ", both to the same type of object, to be a hierarchy");
+				break;
+			}
+		}
+		if(err.accumulated.length() > 0) {
+			error_to_file(output_file_name);
+			std::cout << err.accumulated;
+			return -1;
+		}
+
+		// check versioned objects
+
+		bool const any_versioned = std::find_if(parsed_file.relationship_objects.begin(), parsed_file.relationship_objects.end(),
+			[](relationship_object_def const& ob) { return ob.versioned; }) != parsed_file.relationship_objects.end();
+		for(auto& r : parsed_file.relationship_objects) {
+			if(r.versioned && r.is_expandable) {
+				err.add(row_col_pair{ 0,0 }, 1019, std::string("Object ") + r.name + " cannot be versioned because its size is expandable");
+			}
+		}
+
+		// check reductions
+
+		for(auto& r : parsed_file.relationship_objects) {
+			for(auto& p : r.properties) {
+				if(!p.reduce_sum && !p.reduce_min && !p.reduce_max)
+					continue;
+				if(!r.is_relationship) {
+					err.add(row_col_pair{ 0,0 }, 1021, std::string("Property ") + p.name + " of " + r.name + " cannot be reduced because " + r.name + " is not a relationship");
+				} else if(p.is_derived || p.protection == protection_type::hidden || (p.type != property_type::vectorizable && p.type != property_type::other) || !is_common_type(p.data_type)) {
+					err.add(row_col_pair{ 0,0 }, 1022, std::string("Property ") + p.name + " of relationship " + r.name + " cannot be reduced because it is not a visible property of an arithmetic type");
+				}
+			}
+		}
+		if(err.accumulated.length() > 0) {
+			error_to_file(output_file_name);
+			std::cout << err.accumulated;
+			return -1;
+		}
+
+		// resolve systems and schedule them
+
+		for(uint32_t i = 0; i < parsed_file.systems.size(); ++i) {
+			auto& sys = parsed_file.systems[i];
+			if(sys.name.length() == 0) {
+				err.add(row_col_pair{ 0,0 }, 1016, std::string("A system must have a name"));
+				break;
+			}
+			for(uint32_t j = 0; j < i; ++j) {
+				if(parsed_file.systems[j].name == sys.name)
+					err.add(row_col_pair{ 0,0 }, 1020, std::string("System ") + sys.name + " is defined more than once");
+			}
+			for(auto* accesses : { &sys.reads, &sys.writes }) {
+				for(auto& a : *accesses) {
+					a.object = find_by_name(parsed_file, a.object_name);
+					if(!a.object) {
+						err.add(row_col_pair{ 0,0 }, 1017, std::string("System ") + sys.name + " refers to an unknown object or relationship: " + a.object_name);
+						continue;
+					}
+					if(a.property_name.length() == 0)
+						continue;
+					bool found = false;
+					for(auto& p : a.object->properties)
+						found = found || p.name == a.property_name;
+					for(auto& l : a.object->indexed_objects)
+						found = found || l.property_name == a.property_name;
+					if(!found) {
+						err.add(row_col_pair{ 0,0 }, 1018, std::string("System ") + sys.name + " refers to an unknown property or link: " +
+							a.object_name + "." + a.property_name);
+					}
+				}
+			}
+		}
+		if(err.accumulated.length() > 0) {
+			error_to_file(output_file_name);
+			std::cout << err.accumulated;
+			return -1;
+		}
+
+		{
+			// a whole object or relationship overlaps with every one of its properties and links, and writing a whole object
+			// (creating or deleting instances of it) also writes every relationship that it is involved in
+			auto covers = [](system_access const& write, system_access const& other) {
+				if(write.object == other.object)
+					return write.property_name.length() == 0 || other.property_name.length() == 0 || write.property_name == other.property_name;
+				if(write.property_name.length() != 0 || write.object->is_relationship)
+					return false;
+				for(auto& l : other.object->indexed_objects) {
+					if(l.related_to == write.object)
+						return true;
+				}
+				return false;
+			};
+			auto overlaps = [&](std::vector<system_access> const& writes, std::vector<system_access> const& b, bool b_writes) {
+				for(auto& x : writes) {
+					for(auto& y : b) {
+						if(covers(x, y) || (b_writes && covers(y, x)))
+							return true;
+					}
+				}
+				return false;
+			};
+			// conflicting systems keep the order in which they were declared; each one waits for every earlier system it conflicts with, and its level is its depth in that graph
+			for(uint32_t i = 0; i < parsed_file.systems.size(); ++i) {
+				auto& sys = parsed_file.systems[i];
+				for(uint32_t j = 0; j < i; ++j) {
+					auto& prior = parsed_file.systems[j];
+					if(overlaps(sys.writes, prior.writes, true) || overlaps(sys.writes, prior.reads, false) || overlaps(prior.writes, sys.reads, false)) {
+						sys.after.push_back(j);
+						sys.level = std::max(sys.level, prior.level + 1);
+					}
+				}
+			}
+		}
+
 		// compose contents of generated file
 		std::string output;
 
@@ -326,6 +523,10 @@ int main(int argc, char *argv[]) {
 		if(needs_hash_include) {
 			output += "#include \"unordered_dense.h\"\n";
 		}
+		if(std::find_if(parsed_file.relationship_objects.begin(), parsed_file.relationship_objects.end(),
+			[](relationship_object_def const& ob) { return ob.consistent_reads; }) != parsed_file.relationship_objects.end()) {
+			output += "#include <thread>\n";
+		}
 
 		//open new namespace
 		output += "\n";
@@ -408,7 +609,10 @@ int main(int argc, char *argv[]) {
 		output += "\t}\n\n"; // close namespace detail
 
 		//predeclare data_container
-		output += "\tclass data_container;\n\n";
+		output += "\tclass data_container;\n";
+		if(any_versioned)
+			output += "\tclass snapshot;\n";
+		output += "\n";
 
 		//write internal classes
 
@@ -457,6 +661,10 @@ int main(int argc, char *argv[]) {
 			if(ob.store_type == storage_type::erasable) {
 				output += make_member_container(o, "_index", ob.name + "_id",
 					std::to_string(ob.size), struct_padding::none, ob.is_expandable).to_string(3);
+				// one bit per slot, set while the slot holds a live instance
+				output += make_member_container(o, "_live", "dcon::bitfield_type",
+					std::string("((uint32_t(") + std::to_string(ob.size) + " + 7)) / uint32_t(8) + uint32_t(63)) & ~uint32_t(63)",
+					struct_padding::fixed, ob.is_expandable).to_string(3);
 			}
 
 			for(auto& p : ob.properties) {
@@ -520,7 +728,7 @@ int main(int argc, char *argv[]) {
 							std::string("std::vector<") + ob.name + "_id>",
 							std::to_string(i.related_to->size),
 							struct_padding::none, i.related_to->is_expandable).to_string(3);
-					} else if(i.ltype == list_type::array) {
+					} else if(i.ltype == list_type::array || i.ltype == list_type::sorted_array) {
 						//array of relation ids in object
 						if(!i.related_to->is_expandable) {
 							output += make_member_container(o, std::string("array_") + i.property_name,
@@ -539,6 +747,9 @@ int main(int argc, char *argv[]) {
 							return -1;
 						}
 
+					} else if(i.ltype == list_type::csr) {
+						//relation ids packed by target, with an overlay for changes since the last freeze
+						output += "\t\t\tdcon::csr_index<" + ob.name + "_id> " + i.property_name + "_csr;\n";
 					}
 				} else if(i.index == index_type::at_most_one) {
 					if(ob.primary_key == i) {
@@ -551,8 +762,65 @@ int main(int argc, char *argv[]) {
 				}
 			} // end relationship members
 
+			for(auto& i : ob.indexed_objects) {
+				if(i.is_lazy_index) {
+					// reverse index built on demand, grouped by target as in a csr index
+					output += "\t\t\tmutable dcon::rebuild_flag " + i.property_name + "_lazy_dirty;\n";
+					output += "\t\t\tmutable std::vector<uint32_t> " + i.property_name + "_lazy_offsets;\n";
+					output += "\t\t\tmutable std::vector<" + ob.name + "_id> " + i.property_name + "_lazy_values;\n";
+				}
+			}
+
+			if(ob.hierarchy_link.length() > 0) {
+				// pre-order layout of the hierarchy, rebuilt on first use after it changes
+				std::string node_id = ob.primary_key.points_to->name + "_id";
+				output += "\t\t\tmutable dcon::rebuild_flag hierarchy_dirty;\n";
+				output += "\t\t\tmutable std::vector<uint32_t> hierarchy_position;\n";
+				output += "\t\t\tmutable std::vector<uint32_t> hierarchy_subtree_end;\n";
+				output += "\t\t\tmutable std::vector<uint32_t> hierarchy_depth;\n";
+				output += "\t\t\tmutable std::vector<uint32_t> hierarchy_depth_start;\n";
+				output += "\t\t\tmutable std::vector<" + node_id + "> hierarchy_preorder;\n";
+				output += "\t\t\tmutable std::vector<" + node_id + "> hierarchy_by_depth;\n";
+			}
+
 			if(ob.store_type == storage_type::erasable) {
 				output += "\t\t\t" + ob.name + "_id first_free = " + ob.name + "_id();\n";
+				output += "\t\t\tuint32_t live_count = 0;\n";
+			}
+
+			if(ob.store_type == storage_type::erasable || ob.store_type == storage_type::compactable) {
+				// instances queued by queue_delete, one bit each, removed by commit_deletes
+				if(ob.is_expandable)
+					output += "\t\t\tstd::vector<dcon::bitfield_type> pending_delete;\n";
+				else
+					output += "\t\t\tstd::vector<dcon::bitfield_type> pending_delete = std::vector<dcon::bitfield_type>(" + std::to_string((ob.size + 7) / 8) + ");\n";
+			}
+
+			if(ob.consistent_reads) {
+				// writes begun and finished, per stripe of 64 instances
+				output += "\t\t\tdcon::write_stripes write_sequence = dcon::write_stripes(" + std::to_string(consistent_read_stripes(ob)) + ");\n";
+			}
+
+			if(ob.concurrent_create) {
+				// instances reserved by begin_concurrent_create and the slabs of them claimed by each thread
+				if(ob.store_type == storage_type::erasable)
+					output += "\t\t\tstd::vector<" + ob.name + "_id> concurrent_pool;\n";
+				else
+					output += "\t\t\tuint32_t concurrent_first = 0;\n";
+				output += "\t\t\tuint32_t concurrent_count = 0;\n";
+				output += "\t\t\tuint32_t concurrent_slab_size = 1;\n";
+				output += "\t\t\tstd::atomic<uint32_t> concurrent_cursor = 0;\n";
+				output += "\t\t\tstd::vector<dcon::creation_slab> concurrent_slabs;\n";
+			}
+
+			if(ob.versioned) {
+				// chunks of the live values saved for pinned snapshots
+				for(auto& p : ob.properties) {
+					if(is_versioned_property(ob, p)) {
+						auto column_type = std::string("dcon::versioned_column<") + (p.type == property_type::bitfield ? std::string("dcon::bitfield_type") : normalize_type(p.data_type)) + ">";
+						output += "\t\t\t" + column_type + " m_" + p.name + "_versions = " + column_type + "(" + std::to_string(ob.size) + ");\n";
+					}
+				}
 			}
 
 			if (!ob.primary_key.points_to) {
@@ -577,6 +845,8 @@ int main(int argc, char *argv[]) {
 
 			//object class end
 			output += "\t\t\tfriend data_container;\n";
+			if(ob.versioned)
+				output += "\t\t\tfriend snapshot;\n";
 			output += "\t\t};\n\n";
 		}
 
@@ -614,6 +884,14 @@ int main(int argc, char *argv[]) {
 		for(auto& ob : parsed_file.relationship_objects) {
 			output += "\t\tinternal::" + ob.name + "_class " + ob.name + ";\n";
 		}
+		if(any_versioned)
+			output += "\t\tmutable dcon::epoch_registry snapshot_epochs;\n";
+		for(auto& ob : parsed_file.relationship_objects) {
+			if(tracks_relocations(ob))
+				output += "\t\tdcon::relocation_tracker* " + ob.name + "_relocations = nullptr;\n";
+			if(suppresses_delete_hook(ob))
+				output += "\t\tbool " + ob.name + "_deleting_batch = false;\n";
+		}
 		output += "\n";
 
 		for(auto& ob : parsed_file.relationship_objects) {
@@ -627,9 +905,18 @@ int main(int argc, char *argv[]) {
 			if(ob.hook_delete) {
 				output += "\t\tvoid on_delete_" + ob.name + "(" + ob.name + "_id id);\n";
 			}
+			if(ob.hook_delete_batch && has_batch_delete(ob)) {
+				output += "\t\tvoid on_delete_" + ob.name + "_batch(" + ob.name + "_id const* ids, uint32_t count);\n";
+			}
 			if(ob.hook_move) {
 				output += "\t\tvoid on_move_" + ob.name + "(" + ob.name + "_id new_id," + ob.name + "_id old_id);\n";
 			}
+			if(ob.hook_create_batch && !ob.is_relationship) {
+				if(ob.store_type == storage_type::erasable)
+					output += "\t\tvoid on_create_" + ob.name + "_batch(" + ob.name + "_id const* ids, uint32_t count);\n";
+				else
+					output += "\t\tvoid on_create_" + ob.name + "_batch(" + ob.name + "_id first, uint32_t count);\n";
+			}
 
 			if (!ob.primary_key.points_to) {
 				output += "\t\tuint32_t " + ob.name + "_size() const noexcept { return " + ob.name + ".size_used; }\n\n";
@@ -682,15 +969,35 @@ int main(int argc, char *argv[]) {
 					output += make_pop_back(o, cob).to_string(2);
 					output += make_object_resize(o, cob).to_string(2);
 					output += make_non_erasable_create(o, cob).to_string(2);
+					output += make_batch_create(o, cob).to_string(2);
+					if(cob.concurrent_create)
+						output += make_concurrent_create(o, cob).to_string(2);
+
+					output += "\t\tprivate:\n";
+					output += make_internal_move_object(o, cob).to_string(2);
+					output += "\t\tpublic:\n";
+					output += make_object_reorder(o, cob, parsed_file).to_string(2);
 
 					if(cob.store_type == storage_type::compactable) {
 						output += make_compactable_delete(o, cob).to_string(2);
+						output += make_batch_delete(o, cob).to_string(2);
+						output += make_deferred_delete(o, cob).to_string(2);
 					}
 
 				} else if(cob.store_type == storage_type::erasable) {
 					output += make_erasable_delete(o, cob).to_string(2);
+					output += make_batch_delete(o, cob).to_string(2);
+					output += make_deferred_delete(o, cob).to_string(2);
 					output += make_erasable_create(o, cob).to_string(2);
+					output += make_batch_create(o, cob).to_string(2);
+					if(cob.concurrent_create)
+						output += make_concurrent_create(o, cob).to_string(2);
 					output += make_object_resize(o, cob).to_string(2);
+
+					output += "\t\tprivate:\n";
+					output += make_internal_move_object(o, cob).to_string(2);
+					output += "\t\tpublic:\n";
+					output += make_erasable_compact(o, cob).to_string(2);
 				}
 			} else if(cob.primary_key.points_to) { // primary key relationship
 				output += make_object_resize(o, cob).to_string(2);
@@ -704,6 +1011,9 @@ int main(int argc, char *argv[]) {
 
 				output += make_relation_try_create(o, cob).to_string(2);
 				output += make_relation_force_create(o, cob).to_string(2);
+				output += make_relation_bulk_create(o, cob).to_string(2);
+				output += make_relation_freeze(o, cob).to_string(2);
+				output += make_hierarchy_index(o, cob).to_string(2);
 
 			} else { // non pk relationship
 				if(cob.store_type == storage_type::contiguous || cob.store_type == storage_type::compactable) {
@@ -711,27 +1021,115 @@ int main(int argc, char *argv[]) {
 					output += make_object_resize(o, cob).to_string(2);
 					if(cob.store_type == storage_type::compactable) {
 						output += make_compactable_delete(o, cob).to_string(2);
+						output += make_batch_delete(o, cob).to_string(2);
+						output += make_deferred_delete(o, cob).to_string(2);
 					}
 
 					output += make_relation_try_create(o, cob).to_string(2);
 					output += make_relation_force_create(o, cob).to_string(2);
+					output += make_relation_bulk_create(o, cob).to_string(2);
+					output += make_relation_freeze(o, cob).to_string(2);
 
 				} else if(cob.store_type == storage_type::erasable) {
 					output += make_erasable_delete(o, cob).to_string(2);
+					output += make_batch_delete(o, cob).to_string(2);
+					output += make_deferred_delete(o, cob).to_string(2);
 					output += make_object_resize(o, cob).to_string(2);
 
+					output += "\t\tprivate:\n";
+					output += make_internal_move_relationship(o, cob).to_string(2);
+					output += "\t\tpublic:\n";
+					output += make_erasable_compact(o, cob).to_string(2);
+
 					output += make_relation_try_create(o, cob).to_string(2);
 					output += make_relation_force_create(o, cob).to_string(2);
+					output += make_relation_bulk_create(o, cob).to_string(2);
+					output += make_relation_freeze(o, cob).to_string(2);
 
 				}
 			} // end case relationship no primary key
 		} // end creation / deletion reoutines creation loop
 
+		// relationships are committed before objects, since deleting an object may delete or move relationships
+		output += "\t\tvoid commit_deletes() {\n";
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(cob.is_relationship && (cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable))
+				output += "\t\t\tcommit_deletes_" + cob.name + "();\n";
+		}
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(!cob.is_relationship && (cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable))
+				output += "\t\t\tcommit_deletes_" + cob.name + "();\n";
+		}
+		output += "\t\t}\n\n";
+
+		if(std::find_if(parsed_file.relationship_objects.begin(), parsed_file.relationship_objects.end(),
+			[](relationship_object_def const& ob) { return ob.concurrent_create; }) != parsed_file.relationship_objects.end()) {
+			output += "\t\tvoid merge_creations() {\n";
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(cob.concurrent_create)
+					output += "\t\t\tmerge_" + cob.name + "_creations();\n";
+			}
+			output += "\t\t}\n\n";
+		}
+
 		//iterate over all routines
 		for(auto& cob : parsed_file.relationship_objects) {
 			output += make_iterate_over_objects(o, cob).to_string(2);
 		}
 
+		//sequence counters for consistent_reads
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(cob.consistent_reads)
+				output += make_consistent_reads(o, cob).to_string(2);
+		}
+
+		//saved chunks for snapshots of versioned objects
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(cob.versioned)
+				output += make_versioned_columns(o, cob).to_string(2);
+		}
+		if(any_versioned) {
+			output += "\t\tsnapshot pin_snapshot() const;\n";
+			output += "\t\tvoid reclaim_snapshot_versions() {\n";
+			for(auto& cob : parsed_file.relationship_objects) {
+				for(auto& p : cob.properties) {
+					if(is_versioned_property(cob, p))
+						output += "\t\t\t" + cob.name + ".m_" + p.name + "_versions.reclaim(snapshot_epochs);\n";
+				}
+			}
+			output += "\t\t}\n";
+			output += "\t\tsize_t snapshot_version_bytes() const noexcept {\n";
+			output += "\t\t\tsize_t total = 0;\n";
+			for(auto& cob : parsed_file.relationship_objects) {
+				for(auto& p : cob.properties) {
+					if(is_versioned_property(cob, p))
+						output += "\t\t\ttotal += " + cob.name + ".m_" + p.name + "_versions.saved_bytes();\n";
+				}
+			}
+			output += "\t\t\treturn total;\n";
+			output += "\t\t}\n\n";
+		}
+
+		//lazy reverse indexes
+		for(auto& cob : parsed_file.relationship_objects) {
+			output += make_lazy_index(o, cob).to_string(2);
+		}
+
+		//degree statistics for many links
+		for(auto& cob : parsed_file.relationship_objects) {
+			output += make_link_stats(o, cob).to_string(2);
+		}
+
+		//graph traversals
+		for(auto& tv : parsed_file.traversals) {
+			output += make_traversal(o, tv).to_string(2);
+		}
+
+		//systems
+		if(parsed_file.systems.size() != 0) {
+			output += make_systems(o, parsed_file).to_string(2);
+		}
+
 		output += "\n";
 		for(auto& pq : parsed_file.prepared_queries) {
 			std::string param_list;
@@ -750,6 +1148,17 @@ int main(int argc, char *argv[]) {
 				+ ") { return internal::query_" + pq.name + "_instance(*this" + arg_list + "); }\n";
 			output += "\t\tinternal::query_" + pq.name + "_const_instance query_" + pq.name + "(" + param_list 
 				+ ") const { return internal::query_" + pq.name + "_const_instance(*this" + arg_list + "); }\n";
+			if(!pq.table_slots[0].is_parameter_type) {
+				auto const parallel_params = param_list.length() > 0 ? param_list + ", " : param_list;
+				output += "\t\t#ifndef DCON_NO_VE\n";
+				output += "\t\t#ifndef VE_NO_TBB\n";
+				output += "\t\ttemplate<typename F>\n";
+				output += "\t\tvoid query_" + pq.name + "_parallel(" + parallel_params + "F&& func, uint32_t grain = 16);\n";
+				output += "\t\ttemplate<typename F>\n";
+				output += "\t\tvoid query_" + pq.name + "_parallel(" + parallel_params + "F&& func, uint32_t grain = 16) const;\n";
+				output += "\t\t#endif\n";
+				output += "\t\t#endif\n";
+			}
 		}
 
 		//write save and load object stubs
@@ -842,6 +1251,52 @@ int main(int argc, char *argv[]) {
 				output += "\t\t}\n";
 				output += "#endif\n";
 			}
+			output += "\t\ttemplate<typename F>\n";
+			output += "\t\tDCON_RELEASE_INLINE void execute_serial_over_" + ob.name + "_range(" + ob.name + "_id first, uint32_t count, F&& functor) {\n";
+			output += "\t\t\tconst uint32_t start = uint32_t(first.index());\n";
+			output += "\t\t\tconst uint32_t end = start + count;\n";
+			output += "\t\t\tconst uint32_t aligned_start = std::min(end, (start + uint32_t(ve::vector_size - 1)) & ~uint32_t(ve::vector_size - 1));\n";
+			output += "\t\t\tconst uint32_t aligned_end = aligned_start + ((end - aligned_start) & ~uint32_t(ve::vector_size - 1));\n";
+			output += "\t\t\tif(aligned_start != start)\n";
+			output += "\t\t\t\tfunctor(ve::partial_contiguous_tags<" + ob.name + "_id>(start, aligned_start - start));\n";
+			output += "\t\t\tfor(uint32_t i = aligned_start; i < aligned_end; i += ve::vector_size)\n";
+			output += "\t\t\t\tfunctor(ve::contiguous_tags<" + ob.name + "_id>(i));\n";
+			output += "\t\t\tif(aligned_end != end)\n";
+			output += "\t\t\t\tfunctor(ve::partial_contiguous_tags<" + ob.name + "_id>(aligned_end, end - aligned_end));\n";
+			output += "\t\t}\n";
+			if(ob.store_type == storage_type::erasable) {
+				// visit only the vectors containing at least one live slot
+				std::string position = ob.is_expandable ? "ve::unaligned_contiguous_tags<" : "ve::contiguous_tags<";
+				auto visit_group = [&](std::string const& t) {
+					return t + "i &= ~uint32_t(ve::vector_size - 1);\n"
+						+ t + "if(i + ve::vector_size <= count)\n"
+						+ t + "\tfunctor(" + position + ob.name + "_id>(i));\n"
+						+ t + "else\n"
+						+ t + "\tfunctor(ve::partial_contiguous_tags<" + ob.name + "_id>(i, count - i));\n"
+						+ t + "i += ve::vector_size;\n";
+				};
+				output += "\t\ttemplate<typename F>\n";
+				output += "\t\tDCON_RELEASE_INLINE void execute_serial_over_" + ob.name + "_live(F&& functor) {\n";
+				output += "\t\t\tconst uint32_t count = " + ob.name + ".size_used;\n";
+				output += "\t\t\tfor(uint32_t i = dcon::bit_vector_next_set(" + ob.name + ".m__live.vptr(), 0, count); i < count; "
+					"i = dcon::bit_vector_next_set(" + ob.name + ".m__live.vptr(), i, count)) {\n";
+				output += visit_group("\t\t\t\t");
+				output += "\t\t\t}\n";
+				output += "\t\t}\n";
+				output += "#ifndef VE_NO_TBB\n";
+				output += "\t\ttemplate<typename F>\n";
+				output += "\t\tDCON_RELEASE_INLINE void execute_parallel_over_" + ob.name + "_live(F&& functor) {\n";
+				output += "\t\t\tconst uint32_t count = " + ob.name + ".size_used;\n";
+				output += "\t\t\tconcurrency::parallel_for(uint32_t(0), (count + 63) / 64, [&](uint32_t b) {\n";
+				output += "\t\t\t\tconst uint32_t block_end = std::min(count, b * 64 + 64);\n";
+				output += "\t\t\t\tfor(uint32_t i = dcon::bit_vector_next_set(" + ob.name + ".m__live.vptr(), b * 64, block_end); i < block_end; "
+					"i = dcon::bit_vector_next_set(" + ob.name + ".m__live.vptr(), i, block_end)) {\n";
+				output += visit_group("\t\t\t\t\t");
+				output += "\t\t\t\t}\n";
+				output += "\t\t\t});\n";
+				output += "\t\t}\n";
+				output += "#endif\n";
+			}
 		}
 		output += "\t\t#endif\n";
 
@@ -897,8 +1352,13 @@ int main(int argc, char *argv[]) {
 
 			output += make_query_iterator_body(o, pq, std::string("internal::query_") + pq.name + "_const_iterator::", true).to_string(1);
 			output += make_query_iterator_body(o, pq, std::string("internal::query_") + pq.name + "_iterator::", false).to_string(1);
+			output += make_query_parallel_definitions(o, pq).to_string(1);
 		}
 
+		output += make_command_buffer(o, parsed_file).to_string(1);
+		if(any_versioned)
+			output += make_snapshot(o, parsed_file).to_string(1);
+
 		//close new namespace
 		output += "}\n";
 
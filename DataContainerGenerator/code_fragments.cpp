@@ -200,7 +200,7 @@ basic_builder& make_array_member_container(basic_builder& o,
 					};
 				};
 				o + "DCON_RELEASE_INLINE void copy_value(int32_t dest, int32_t source)" + block{
-					o + "for(int32_t i = 1; i < int32_t(size + 1); ++i)" + block{
+					o + "for(int32_t i = 0; i < int32_t(size); ++i)" + block{
 						o + "dcon::bit_vector_set(vptr(i), dest, dcon::bit_vector_test(vptr(i), source));";
 					};
 				};
@@ -210,7 +210,7 @@ basic_builder& make_array_member_container(basic_builder& o,
 					};
 				};
 				o + "DCON_RELEASE_INLINE void zero_at(int32_t dest)" + block{
-					o + "for(int32_t i = 0; i < int32_t(size + 1); ++i)" + block{
+					o + "for(int32_t i = 0; i < int32_t(size); ++i)" + block{
 						o + "dcon::bit_vector_set(vptr(i), dest, false);";
 					};
 				};
@@ -354,17 +354,51 @@ basic_builder& pop_value(basic_builder& o, std::string const& object_name, std::
 	return o;
 }
 
+void mark_lazy_indexes_dirty(basic_builder& o, relationship_object_def const& cob) {
+	for(auto& io : cob.indexed_objects) {
+		if(io.is_lazy_index) {
+			o + substitute{ "lazy_prop", io.property_name };
+			o + "@obj@.@lazy_prop@_lazy_dirty.mark();";
+		}
+	}
+}
+
+// inside delete_..._batch the batch hook has already been called for every instance being deleted
+void delete_hook(basic_builder& o, relationship_object_def const& cob) {
+	if(suppresses_delete_hook(cob))
+		o + "if(!@obj@_deleting_batch) on_delete_@obj@(id_removed);";
+	else if(cob.hook_delete)
+		o + "on_delete_@obj@(id_removed);";
+}
+
+void rebuild_live_set(basic_builder& o, relationship_object_def const& cob, std::string const& count) {
+	o + substitute{ "l_obj", cob.name } + substitute{ "l_count", count } + substitute{ "l_sz", std::to_string(cob.size) };
+	if(cob.is_expandable) {
+		o + "@l_obj@.m__live.values.resize(1 + (@l_count@ + 7) / 8);";
+		o + "std::fill(@l_obj@.m__live.values.begin(), @l_obj@.m__live.values.end(), dcon::bitfield_type{});";
+	} else {
+		o + "std::fill(@l_obj@.m__live.vptr(), @l_obj@.m__live.vptr() + (@l_sz@ + 7) / 8, dcon::bitfield_type{});";
+	}
+	o + "@l_obj@.live_count = 0;";
+	o + "for(uint32_t j = 0; j < @l_count@; ++j)" + block{
+		o + "if(@l_obj@.m__index.vptr()[j] == @l_obj@_id(@l_obj@_id::value_base_t(j)))" + block{
+			o + "dcon::bit_vector_set(@l_obj@.m__live.vptr(), int32_t(j), true);";
+			o + "++@l_obj@.live_count;";
+		};
+	};
+}
+
 basic_builder& make_pop_back(basic_builder& o, relationship_object_def const& cob) {
 	o + substitute{ "obj", cob.name } + substitute{ "pk_obj", cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name };
 
 	o + heading{ "container pop_back for @obj@" };
 
 	o + "void pop_back_@obj@()" + block{
+		mark_lazy_indexes_dirty(o, cob);
 		o + "if(@pk_obj@.size_used == 0) return;";
 		o + "@obj@_id id_removed(@obj@_id::value_base_t(@pk_obj@.size_used - 1));";
 
-		if(cob.hook_delete)
-			o + "on_delete_@obj@(id_removed);";
+		delete_hook(o, cob);
 
 		for(auto& ck : cob.composite_indexes) {
 			std::string params;
@@ -425,7 +459,7 @@ basic_builder& make_pop_back(basic_builder& o, relationship_object_def const& co
 					if(cr.linked_as->ltype == list_type::list) {
 						pop_value(o, cr.relation_name, std::string("head_back_") + cr.linked_as->property_name,
 							property_type::other, "id_removed", cr.rel_ptr->primary_key.points_to ? cr.rel_ptr->primary_key.points_to->name : cr.relation_name);
-					} else if(cr.linked_as->ltype == list_type::array) {
+					} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
 						pop_value(o, cr.relation_name, cr.linked_as->property_name,
 							property_type::special_vector, "id_removed", cr.rel_ptr->primary_key.points_to ? cr.rel_ptr->primary_key.points_to->name : cr.relation_name, true);
 					} else if(cr.linked_as->ltype == list_type::std_vector) {
@@ -566,6 +600,10 @@ basic_builder& make_object_resize(basic_builder& o, relationship_object_def cons
 	o + heading{ "container resize for @obj@" };
 
 	o + "void @obj@_resize(uint32_t new_size)" + block{
+		mark_lazy_indexes_dirty(o, cob);
+		if(cob.hierarchy_link.length() > 0) {
+			o + "@obj@.hierarchy_dirty.mark();";
+		}
 		if(!cob.is_expandable) {
 			o + "#ifndef DCON_USE_EXCEPTIONS";
 			o + "if(new_size > @obj_sz@) std::abort();";
@@ -637,12 +675,15 @@ basic_builder& make_object_resize(basic_builder& o, relationship_object_def cons
 							}
 							clear_value_range(o, cob.name, std::string("head_back_") + io.property_name, cob.name + "_id",
 								property_type::other, "0", io_pk_name + ".size_used");
-						} else if(io.ltype == list_type::array) {
+						} else if(io.ltype == list_type::array || io.ltype == list_type::sorted_array) {
 							clear_value_range(o, cob.name, io.property_name, "",
 								property_type::special_vector, "0", io_pk_name + ".size_used", true);
 						} else if(io.ltype == list_type::std_vector) {
 							clear_value_range(o, cob.name, std::string("array_") + io.property_name, std::string("std::vector<") + cob.name + "_id>",
 								property_type::other, "0", io_pk_name + ".size_used");
+						} else if(io.ltype == list_type::csr) {
+							o + substitute{ "csr_prop", io.property_name };
+							o + "@obj@.@csr_prop@_csr.clear();";
 						}
 					}
 				}
@@ -710,7 +751,7 @@ basic_builder& make_object_resize(basic_builder& o, relationship_object_def cons
 						if(cr.linked_as->ltype == list_type::list) {
 							grow_value_range(o, cr.relation_name, std::string("head_back_") + cr.linked_as->property_name,
 								property_type::other, "new_size");
-						} else if(cr.linked_as->ltype == list_type::array) {
+						} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
 							grow_value_range(o, cr.relation_name, cr.linked_as->property_name,
 								property_type::special_vector, "new_size", true);
 						} else if(cr.linked_as->ltype == list_type::std_vector) {
@@ -725,6 +766,16 @@ basic_builder& make_object_resize(basic_builder& o, relationship_object_def cons
 
 		if(!cob.primary_key.points_to)
 			o + "@obj@.size_used = new_size;";
+		if(cob.store_type == storage_type::erasable)
+			rebuild_live_set(o, cob, "new_size");
+		if(cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable) {
+			// queued deletes of instances that no longer exist are dropped
+			o + "for(uint32_t i = new_size; i < old_size; ++i)" + block{
+				o + "dcon::bit_vector_set(@obj@.pending_delete.data(), int32_t(i), false);";
+			};
+			if(cob.is_expandable)
+				o + "@obj@.pending_delete.resize((new_size + 7) / 8);";
+		}
 	};
 	o + line_break{};
 	return o;
@@ -866,12 +917,25 @@ void make_composite_key_internal_delete(basic_builder& o, relationship_object_de
 	}
 }
 
+// a queue_delete mark belongs to the instance, so it is cleared when the instance is deleted and follows it when it is moved
+void clear_pending_delete(basic_builder& o, relationship_object_def const& cob, char const* id) {
+	if(cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable)
+		o + (std::string("dcon::bit_vector_set(@obj@.pending_delete.data(), ") + id + ".index(), false);");
+}
+void move_pending_delete(basic_builder& o, relationship_object_def const& cob) {
+	if(cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable) {
+		o + "dcon::bit_vector_set(@obj@.pending_delete.data(), id_removed.index(), dcon::bit_vector_test(@obj@.pending_delete.data(), last_id.index()));";
+		o + "dcon::bit_vector_set(@obj@.pending_delete.data(), last_id.index(), false);";
+	}
+}
+
 basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def const& cob) {
 	o + substitute{ "obj", cob.name } + substitute{ "obj_pk", cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name };
 	o + heading{ "container compactable delete for @obj@" };
 
 	o + "void delete_@obj@(@obj@_id id)" + block{
 		o + "@obj@_id id_removed = id;";
+		mark_lazy_indexes_dirty(o, cob);
 
 		o + "#ifndef NDEBUG";
 		o + "assert(id.index() >= 0);";
@@ -879,11 +943,16 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 		o + "assert(@obj_pk@.size_used != 0);";
 		o + "#endif";
 
+		clear_pending_delete(o, cob, "id_removed");
+		if(tracks_relocations(cob))
+			o + "if(@obj@_relocations) @obj@_relocations->erased(id_removed.index());";
 		o + "@obj@_id last_id(@obj@_id::value_base_t(@obj_pk@.size_used - 1));";
 		o + "if(id_removed == last_id) { pop_back_@obj@(); return; }";
+		move_pending_delete(o, cob);
+		if(tracks_relocations(cob))
+			o + "if(@obj@_relocations) @obj@_relocations->moved(last_id.index(), id_removed.index());";
 
-		if(cob.hook_delete)
-			o + "on_delete_@obj@(id_removed);";
+		delete_hook(o, cob);
 
 		for(auto& ck : cob.composite_indexes) {
 			std::string params;
@@ -966,10 +1035,12 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 							};
 						}
 					}
-				} else if(iob.ltype == list_type::array) {
+				} else if(iob.ltype == list_type::array || iob.ltype == list_type::sorted_array) {
+					o + substitute{ "pool_replace_unique", iob.ltype == list_type::sorted_array ? "sorted_replace_unique_item" : "replace_unique_item" }
+						+substitute{ "pool_replace_all", iob.ltype == list_type::sorted_array ? "sorted_replace_all_items" : "replace_all_items" };
 					if(iob.multiplicity == 1) {
 						o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()]; bool(tmp))" + block{
-							o + "dcon::replace_unique_item(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+							o + "dcon::@pool_replace_unique@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 								" last_id, id_removed);";
 						};
 					} else {
@@ -977,15 +1048,32 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 							o + substitute{ "i", std::to_string(i) };
 							o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()][@i@]; bool(tmp))" + block{
 								if(iob.is_distinct) {
-									o + "dcon::replace_unique_item(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+									o + "dcon::@pool_replace_unique@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 										" last_id, id_removed);";
 								} else {
-									o + "dcon::replace_all_items(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+									o + "dcon::@pool_replace_all@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 										" last_id, id_removed);";
 								}
 							};
 						}
 					}
+				} else if(iob.ltype == list_type::csr) {
+					if(iob.multiplicity == 1) {
+						o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()]; bool(tmp))" + block{
+							o + "@obj@.@i_prop@_csr.replace_unique(tmp.index(), last_id, id_removed);";
+						};
+					} else {
+						for(int32_t i = 0; i < iob.multiplicity; ++i) {
+							o + substitute{ "i", std::to_string(i) };
+							o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()][@i@]; bool(tmp))" + block{
+								if(iob.is_distinct) {
+									o + "@obj@.@i_prop@_csr.replace_unique(tmp.index(), last_id, id_removed);";
+								} else {
+									o + "@obj@.@i_prop@_csr.replace_all(tmp.index(), last_id, id_removed);";
+								}
+							};
+						}
+					}
 				}
 			}
 
@@ -1025,6 +1113,9 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 					"last_id", "id_removed", cr.relation_name + "_id()", cob.is_expandable, 1);
 			} else if(cr.linked_as->index == index_type::many) {
 				o + "@obj@_remove_all_@rel@_as_@r_prop@(id_removed);";
+				if(cr.rel_ptr->hierarchy_link == cr.linked_as->property_name) {
+					o + "@rel@.hierarchy_dirty.mark();";
+				}
 				o + "@obj@_for_each_@rel@_as_@r_prop@(last_id, "
 					"[this, id_removed, last_id](@rel@_id i)" + block{
 						if(cr.linked_as->is_covered_by_composite_key)
@@ -1047,13 +1138,15 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 				if(cr.linked_as->ltype == list_type::list) {
 					move_value_from_back(o, cr.relation_name, std::string("head_back_") + cr.linked_as->property_name,
 						"last_id", "id_removed", cr.relation_name + "_id()", cob.is_expandable, 1);
-				} else if(cr.linked_as->ltype == list_type::array) {
+				} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
 					o + "@rel@.@r_prop@_storage.release(@rel@.m_array_@r_prop@.vptr()[id_removed.index()]);";
 					move_value_from_back(o, cr.relation_name, std::string("array_") + cr.linked_as->property_name,
 						"last_id", "id_removed", "std::numeric_limits<dcon::stable_mk_2_tag>::max()", cob.is_expandable, 1);
 				} else if(cr.linked_as->ltype == list_type::std_vector) {
 					move_value_from_back(o, cr.relation_name, std::string("array_") + cr.linked_as->property_name,
 						"last_id", "id_removed", std::string("std::vector<") + cr.relation_name + "_id>{}", cob.is_expandable, 1);
+				} else if(cr.linked_as->ltype == list_type::csr) {
+					o + "@rel@.@r_prop@_csr.move_list(last_id.index(), id_removed.index());";
 				}
 			}
 		}
@@ -1132,6 +1225,119 @@ basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def
 	return o;
 }
 
+basic_builder& make_batch_delete(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name } +substitute{ "obj_pk", cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name };
+	o + heading{ "container batch delete for @obj@" };
+
+	o + "void delete_@obj@_batch(@obj@_id const* ids, uint32_t count)" + block{
+		// duplicates and invalid handles are skipped
+		o + "std::vector<dcon::bitfield_type> marked((@obj_pk@.size_used + 7) / 8);";
+		o + "std::vector<@obj@_id> victims;";
+		o + "victims.reserve(count);";
+		o + "for(uint32_t k = 0; k < count; ++k)" + block{
+			o + "auto id = ids[k];";
+			o + "if(!@obj@_is_valid(id) || dcon::bit_vector_test(marked.data(), id.index())) continue;";
+			o + "dcon::bit_vector_set(marked.data(), id.index(), true);";
+			o + "victims.push_back(id);";
+		};
+		if(cob.hook_delete_batch)
+			o + "if(!victims.empty()) on_delete_@obj@_batch(victims.data(), uint32_t(victims.size()));";
+
+		// relationships that would be deleted along with the victims are collected for the whole batch and
+		// deleted by their own batch delete, leaving the per-instance deletes below nothing to cascade into
+		std::set<std::string> cascaded;
+		for(auto& cr : cob.relationships_involved_in) {
+			if(cascaded.count(cr.relation_name) != 0 || !has_batch_delete(*cr.rel_ptr))
+				continue;
+			bool any_dependent = false;
+			for(auto& link : cob.relationships_involved_in) {
+				if(link.relation_name == cr.relation_name && !link.linked_as->is_primary_key && !link.linked_as->is_optional
+					&& (link.linked_as->index == index_type::at_most_one || link.linked_as->index == index_type::many)) {
+					any_dependent = true;
+				}
+			}
+			if(!any_dependent)
+				continue;
+			cascaded.insert(cr.relation_name);
+
+			o + substitute{ "rel", cr.relation_name };
+			o + "std::vector<@rel@_id> @rel@_dependents;";
+			o + "for(auto id : victims)" + block{
+				for(auto& link : cob.relationships_involved_in) {
+					if(link.relation_name != cr.relation_name || link.linked_as->is_primary_key || link.linked_as->is_optional)
+						continue;
+					o + substitute{ "r_prop", link.linked_as->property_name };
+					if(link.linked_as->index == index_type::at_most_one) {
+						o + "if(auto r = @rel@.m_link_back_@r_prop@.vptr()[id.index()]; bool(r)) @rel@_dependents.push_back(r);";
+					} else if(link.linked_as->index == index_type::many) {
+						o + "@obj@_for_each_@rel@_as_@r_prop@(id, [&](@rel@_id r) { @rel@_dependents.push_back(r); });";
+					}
+				}
+			};
+			o + "delete_@rel@_batch(@rel@_dependents.data(), uint32_t(@rel@_dependents.size()));";
+		}
+
+		if(suppresses_delete_hook(cob))
+			o + "@obj@_deleting_batch = true;";
+		if(cob.store_type == storage_type::compactable) {
+			// each deletion either removes the current last element or fills the lowest remaining hole with
+			// a surviving element from the back, so every survivor is moved at most once
+			o + "std::sort(victims.begin(), victims.end(), [](@obj@_id a, @obj@_id b){ return a.value < b.value; });";
+			o + "size_t low = 0;";
+			o + "size_t high = victims.size();";
+			o + "while(low < high)" + block{
+				o + "@obj@_id last_id(@obj@_id::value_base_t(@obj_pk@.size_used - 1));";
+				o + "if(victims[high - 1] == last_id)" + block{
+					o + "delete_@obj@(last_id);";
+					o + "--high;";
+				} +append{ "else" } +block{
+					o + "delete_@obj@(victims[low]);";
+					o + "++low;";
+				};
+			};
+		} else {
+			o + "for(auto id : victims)" + block{
+				o + "delete_@obj@(id);";
+			};
+		}
+		if(suppresses_delete_hook(cob))
+			o + "@obj@_deleting_batch = false;";
+	};
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_deferred_delete(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name };
+	o + heading{ "container deferred delete for @obj@" };
+
+	// may be called from any number of threads at once, as long as nothing is created or deleted at the same time
+	o + "void queue_delete_@obj@(@obj@_id id) noexcept" + block{
+		o + "if(!bool(id)) return;";
+		o + "#ifndef NDEBUG";
+		o + "assert(uint32_t(id.index()) < @obj@.pending_delete.size() * 8);";
+		o + "#endif";
+		o + "dcon::bit_vector_atomic_set(@obj@.pending_delete.data(), id.index());";
+	};
+	o + "bool @obj@_is_pending_delete(@obj@_id id) const noexcept" + block{
+		o + "return bool(id) && dcon::bit_vector_atomic_test(@obj@.pending_delete.data(), id.index());";
+	};
+	o + "void commit_deletes_@obj@()" + block{
+		o + "const uint32_t count = @obj@_size();";
+		o + "std::vector<@obj@_id> victims;";
+		o + "for(uint32_t i = dcon::bit_vector_next_set(@obj@.pending_delete.data(), 0, count); i < count; "
+			"i = dcon::bit_vector_next_set(@obj@.pending_delete.data(), i + 1, count))" + block{
+			o + "victims.push_back(@obj@_id(@obj@_id::value_base_t(i)));";
+		};
+		o + "if(victims.empty()) return;";
+		o + "std::fill(@obj@.pending_delete.begin(), @obj@.pending_delete.end(), dcon::bitfield_type{0});";
+		o + "delete_@obj@_batch(victims.data(), uint32_t(victims.size()));";
+	};
+
+	o + line_break{};
+	return o;
+}
+
 basic_builder& expandable_push_back(basic_builder& o, relationship_object_def const& cob) {
 	o + substitute{ "obj", cob.name } + substitute{ "pk_obj", cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name };
 
@@ -1165,7 +1371,7 @@ basic_builder& expandable_push_back(basic_builder& o, relationship_object_def co
 		} else if(cr.linked_as->index == index_type::many) {
 			if(cr.linked_as->ltype == list_type::list) {
 				o + "@rel@.m_head_back_@in_rel_as@.values.emplace_back();";
-			} else if(cr.linked_as->ltype == list_type::array) {
+			} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
 				o + "@rel@.m_array_@in_rel_as@.values.push_back(std::numeric_limits<dcon::stable_mk_2_tag>::max());";
 			} else if(cr.linked_as->ltype == list_type::std_vector) {
 				o + "@rel@.m_array_@in_rel_as@.values.emplace_back();";
@@ -1200,12 +1406,58 @@ basic_builder& expandable_push_back(basic_builder& o, relationship_object_def co
 			o + "@obj@.m_@prop@.values.emplace_back();";
 		}
 	}
+	if(cob.store_type == storage_type::erasable)
+		o + "@obj@.m__live.values.resize(1 + (@pk_obj@.size_used + 8) / 8);";
+	if(cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable)
+		o + "@obj@.pending_delete.resize((@pk_obj@.size_used + 8) / 8);";
 	if(!cob.primary_key.points_to)
 		o + "++@obj@.size_used;";
 
 	return o;
 }
 
+// the inverse of expandable_push_back: drops the last slot, which must already be empty, from every container
+basic_builder& expandable_pop_back(basic_builder& o, relationship_object_def const& cob, std::string const& at) {
+	o + substitute{ "obj", cob.name } + substitute{ "pk_obj", cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name };
+
+	for(auto& cr : cob.relationships_involved_in) {
+		o + substitute{ "rel", cr.relation_name } +substitute{ "in_rel_as", cr.linked_as->property_name };
+		if(cr.linked_as->is_primary_key) {
+			for(auto& rp : cr.rel_ptr->properties) {
+				if(!rp.is_derived)
+					pop_value(o, cr.relation_name, rp.name, rp.type, at, cob.name);
+			}
+			for(auto& ri : cr.rel_ptr->indexed_objects) {
+				o + substitute{ "r_prop", ri.property_name };
+				if(cr.rel_ptr->primary_key != ri) {
+					o + "@rel@.m_@r_prop@.values.pop_back();";
+				}
+				if(ri.ltype == list_type::list && ri.index == index_type::many) {
+					o + "@rel@.m_link_@r_prop@.values.pop_back();";
+				}
+			}
+		} else if(cr.linked_as->index == index_type::at_most_one) {
+			o + "@rel@.m_link_back_@in_rel_as@.values.pop_back();";
+		} else if(cr.linked_as->index == index_type::many) {
+			if(cr.linked_as->ltype == list_type::list) {
+				o + "@rel@.m_head_back_@in_rel_as@.values.pop_back();";
+			} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
+				pop_value(o, cr.relation_name, cr.linked_as->property_name, property_type::special_vector, at, cob.name, true);
+			} else if(cr.linked_as->ltype == list_type::std_vector) {
+				o + "@rel@.m_array_@in_rel_as@.values.pop_back();";
+			}
+		}
+	}
+	for(auto& cp : cob.properties) {
+		if(!cp.is_derived)
+			pop_value(o, cob.name, cp.name, cp.type, at, cob.primary_key.points_to ? cob.primary_key.points_to->name : cob.name);
+	}
+	if(!cob.primary_key.points_to)
+		o + "--@obj@.size_used;";
+
+	return o;
+}
+
 basic_builder& increase_size(basic_builder& o, relationship_object_def const& cob) {
 	o + substitute{ "obj", cob.name };
 
@@ -1253,12 +1505,12 @@ basic_builder& make_clearing_delete(basic_builder& o, relationship_object_def co
 	o + heading{ "container delete for @obj@" };
 
 	o + "void delete_@obj@(@obj@_id id_removed)" + block{
+		mark_lazy_indexes_dirty(o, cob);
 		o + "#ifndef NDEBUG";
 		o + "assert(id_removed.index() >= 0);";
 		o + "#endif";
 
-		if(cob.hook_delete)
-			o + "on_delete_@obj@(id_removed);";
+		delete_hook(o, cob);
 
 		for(auto& ck : cob.composite_indexes) {
 			std::string params;
@@ -1313,17 +1565,22 @@ basic_builder& make_erasable_delete(basic_builder& o, relationship_object_def co
 	o + heading{ "container delete for @obj@" };
 
 	o + "void delete_@obj@(@obj@_id id_removed)" + block{
+		mark_lazy_indexes_dirty(o, cob);
 		o + "#ifndef NDEBUG";
 		o + "assert(id_removed.index() >= 0);";
 		o + "assert(@obj@.m__index.vptr()[id_removed.index()] == id_removed);";
 		o + "#endif";
 
-		if(cob.hook_delete)
-			o + "on_delete_@obj@(id_removed);";
+		delete_hook(o, cob);
 
+		clear_pending_delete(o, cob, "id_removed");
+		if(tracks_relocations(cob))
+			o + "if(@obj@_relocations) @obj@_relocations->erased(id_removed.index());";
 		if (!cob.primary_key.points_to) {
 			o + "@obj@.m__index.vptr()[id_removed.index()] = @obj@.first_free;";
 			o + "@obj@.first_free = id_removed;";
+			o + "dcon::bit_vector_set(@obj@.m__live.vptr(), id_removed.index(), false);";
+			o + "--@obj@.live_count;";
 			o + "if(int32_t(@obj@.size_used) - 1 == id_removed.index())" + block{
 				o + "for( ; @obj@.size_used > 0 && "
 					"@obj@.m__index.vptr()[@obj@.size_used - 1] != @obj@_id(@obj@_id::value_base_t(@obj@.size_used - 1));  "
@@ -1406,6 +1663,10 @@ basic_builder& erasable_set_new_id(basic_builder& o, relationship_object_def con
 			o + "@t_obj@.size_used = std::max(@t_obj@.size_used, uint32_t(new_id.index() + 1));";
 		};
 	}
+	if(!cob.primary_key.points_to) {
+		o + "dcon::bit_vector_set(@t_obj@.m__live.vptr(), new_id.index(), true);";
+		o + "++@t_obj@.live_count;";
+	}
 	
 	/*
 	for(auto& cr : cob.relationships_involved_in) {
@@ -1438,11 +1699,205 @@ basic_builder& make_erasable_create(basic_builder& o, relationship_object_def co
 	return o;
 }
 
+basic_builder& make_batch_create(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name };
+	o + heading{ "container batch create for @obj@" };
+
+	if(cob.store_type != storage_type::erasable) {
+		// the new instances are appended as one contiguous range, with every column grown or cleared in bulk by resize
+		o + "@obj@_id create_@obj@_batch(uint32_t count)" + block{
+			o + "if(count == 0) return @obj@_id();";
+			o + "const uint32_t first = @obj@.size_used;";
+			o + "@obj@_resize(first + count);";
+			if(cob.hook_create_batch) {
+				o + "on_create_@obj@_batch(@obj@_id(@obj@_id::value_base_t(first)), count);";
+			} else if(cob.hook_create) {
+				o + "for(uint32_t k = 0; k < count; ++k) on_create_@obj@(@obj@_id(@obj@_id::value_base_t(first + k)));";
+			}
+			o + "return @obj@_id(@obj@_id::value_base_t(first));";
+		};
+	} else {
+		// free slots are reused first, in the order of the free list, and any remainder is appended
+		o + "void create_@obj@_batch(@obj@_id* ids_out, uint32_t count)" + block{
+			o + "for(uint32_t k = 0; k < count; ++k)" + block{
+				erasable_set_new_id(o, cob);
+				o + "ids_out[k] = new_id;";
+			};
+			if(cob.hook_create_batch) {
+				o + "on_create_@obj@_batch(ids_out, count);";
+			} else if(cob.hook_create) {
+				o + "for(uint32_t k = 0; k < count; ++k) on_create_@obj@(ids_out[k]);";
+			}
+		};
+	}
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_concurrent_create(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name };
+	o + heading{ "concurrent create for @obj@" };
+
+	// reserves max_count instances up front; threads then claim them a slab at a time
+	o + "void begin_concurrent_create_@obj@(uint32_t max_count, uint32_t thread_count)" + block{
+		o + "@obj@.concurrent_count = max_count;";
+		o + "@obj@.concurrent_cursor.store(0, std::memory_order_relaxed);";
+		o + "@obj@.concurrent_slabs.assign(std::max(thread_count, uint32_t(1)), dcon::creation_slab{});";
+		// small enough that every thread gets a few slabs, which bounds the number of unused reservations
+		o + "@obj@.concurrent_slab_size = std::clamp(max_count / (uint32_t(@obj@.concurrent_slabs.size()) * 4), uint32_t(1), dcon::creation_slab::max_size);";
+		if(cob.store_type == storage_type::erasable) {
+			o + "@obj@.concurrent_pool.resize(max_count);";
+			o + "for(uint32_t k = 0; k < max_count; ++k)" + block{
+				erasable_set_new_id(o, cob);
+				o + "@obj@.concurrent_pool[k] = new_id;";
+			};
+		} else {
+			o + "@obj@.concurrent_first = @obj@.size_used;";
+			o + "@obj@_resize(@obj@.size_used + max_count);";
+		}
+	};
+
+	// may be called from any number of threads at once, as long as each uses its own thread_index
+	o + "@obj@_id create_@obj@_concurrent(uint32_t thread_index)" + block{
+		o + "auto& slab = @obj@.concurrent_slabs[thread_index];";
+		o + "if(slab.next == slab.end)" + block{
+			o + "uint32_t const start = @obj@.concurrent_cursor.fetch_add(@obj@.concurrent_slab_size, std::memory_order_relaxed);";
+			o + "#ifndef DCON_USE_EXCEPTIONS";
+			o + "if(start >= @obj@.concurrent_count) std::abort();";
+			o + "#else";
+			o + "if(start >= @obj@.concurrent_count) throw dcon::out_of_space{};";
+			o + "#endif";
+			o + "slab.next = start;";
+			o + "slab.end = std::min(start + @obj@.concurrent_slab_size, @obj@.concurrent_count);";
+		};
+		if(cob.store_type == storage_type::erasable)
+			o + "return @obj@.concurrent_pool[slab.next++];";
+		else
+			o + "return @obj@_id(@obj@_id::value_base_t(@obj@.concurrent_first + slab.next++));";
+	};
+
+	// the unclaimed reservations are the unused ends of each thread's last slab and everything past the last slab handed out;
+	// the result has one entry per reservation: the handle of the instance created there, or an invalid handle
+	o + "std::vector<@obj@_id> merge_@obj@_creations()" + block{
+		o + "if(@obj@.concurrent_slabs.empty()) return std::vector<@obj@_id>();";
+		o + "uint32_t const count = @obj@.concurrent_count;";
+		o + "uint32_t const handed_out = std::min(@obj@.concurrent_cursor.load(std::memory_order_acquire), count);";
+		o + "std::vector<dcon::bitfield_type> claimed((count + 7) / 8);";
+		o + "for(uint32_t k = 0; k < handed_out; ++k)";
+		o + "\tdcon::bit_vector_set(claimed.data(), int32_t(k), true);";
+		o + "for(auto& slab : @obj@.concurrent_slabs)" + block{
+			o + "for(uint32_t k = slab.next; k < slab.end; ++k)";
+			o + "\tdcon::bit_vector_set(claimed.data(), int32_t(k), false);";
+		};
+		o + "std::vector<@obj@_id> remap(count);";
+		o + "uint32_t created = 0;";
+
+		if(cob.store_type == storage_type::erasable) {
+			// unclaimed slots go back on the free list, in reverse so that they come off it in their original order
+			o + "for(uint32_t k = count; k-- > 0; )" + block{
+				o + "auto id = @obj@.concurrent_pool[k];";
+				o + "if(dcon::bit_vector_test(claimed.data(), int32_t(k)))" + block{
+					o + "remap[k] = id;";
+					o + "++created;";
+				} + append{ "else" } + block{
+					o + "@obj@.m__index.vptr()[id.index()] = @obj@.first_free;";
+					o + "@obj@.first_free = id;";
+					o + "dcon::bit_vector_set(@obj@.m__live.vptr(), id.index(), false);";
+					o + "--@obj@.live_count;";
+				};
+			};
+			o + "@obj@.concurrent_pool.clear();";
+			o + "for( ; @obj@.size_used > 0 && "
+				"@obj@.m__index.vptr()[@obj@.size_used - 1] != @obj@_id(@obj@_id::value_base_t(@obj@.size_used - 1)); "
+				"--@obj@.size_used) ;";
+		} else {
+			// as in compaction, each gap is filled, lowest first, by the claimed instance with the highest position
+			o + "uint32_t const first = @obj@.concurrent_first;";
+			o + "for(uint32_t k = 0; k < handed_out; ++k)" + block{
+				o + "if(dcon::bit_vector_test(claimed.data(), int32_t(k)))" + block{
+					o + "remap[k] = @obj@_id(@obj@_id::value_base_t(first + k));";
+					o + "++created;";
+				};
+			};
+			o + "uint32_t low = 0;";
+			o + "uint32_t high = handed_out;";
+			o + "while(true)" + block{
+				o + "while(low < high && dcon::bit_vector_test(claimed.data(), int32_t(low))) ++low;";
+				o + "while(high > low && !dcon::bit_vector_test(claimed.data(), int32_t(high - 1))) --high;";
+				o + "if(low >= high) break;";
+				o + "auto last_id = @obj@_id(@obj@_id::value_base_t(first + high - 1));";
+				o + "auto id_removed = @obj@_id(@obj@_id::value_base_t(first + low));";
+				o + "internal_move_@obj@(last_id, id_removed);";
+				o + "remap[high - 1] = id_removed;";
+				if(cob.hook_move)
+					o + "on_move_@obj@(id_removed, last_id);";
+				o + "dcon::bit_vector_set(claimed.data(), int32_t(low), true);";
+				o + "dcon::bit_vector_set(claimed.data(), int32_t(high - 1), false);";
+				o + "++low;";
+				o + "--high;";
+			};
+			o + "@obj@_resize(first + created);";
+		}
+		o + "@obj@.concurrent_slabs.clear();";
+		o + "@obj@.concurrent_count = 0;";
+
+		if(cob.store_type == storage_type::erasable) {
+			if(cob.hook_create_batch) {
+				o + "std::vector<@obj@_id> new_ids;";
+				o + "new_ids.reserve(created);";
+				o + "for(auto id : remap) if(bool(id)) new_ids.push_back(id);";
+				o + "on_create_@obj@_batch(new_ids.data(), uint32_t(new_ids.size()));";
+			} else if(cob.hook_create) {
+				o + "for(auto id : remap) if(bool(id)) on_create_@obj@(id);";
+			}
+		} else {
+			if(cob.hook_create_batch) {
+				o + "if(created != 0) on_create_@obj@_batch(@obj@_id(@obj@_id::value_base_t(first)), created);";
+			} else if(cob.hook_create) {
+				o + "for(uint32_t k = 0; k < created; ++k) on_create_@obj@(@obj@_id(@obj@_id::value_base_t(first + k)));";
+			}
+		}
+		o + "return remap;";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+// moves every stored property value from last_id into the empty slot id_removed
+void move_all_properties(basic_builder& o, relationship_object_def const& cob) {
+	for(auto& cp : cob.properties) {
+		o + substitute{ "prop", cp.name };
+		if(cp.is_derived) {
+		} else if(cp.type == property_type::special_vector) {
+			o + "@obj@.@prop@_storage.release(@obj@.m_@prop@.vptr()[id_removed.index()]);";
+			move_value(o, cob.name, cp.name,
+				"last_id", "id_removed", "std::numeric_limits<dcon::stable_mk_2_tag>::max()", 1);
+		} else if(cp.type == property_type::bitfield) {
+			o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), id_removed.index(), "
+				"dcon::bit_vector_test(@obj@.m_@prop@.vptr(), last_id.index()));";
+			o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), last_id.index(), false);";
+		} else if(cp.type == property_type::array_bitfield || cp.type == property_type::array_other || cp.type == property_type::array_vectorizable) {
+			move_array_value(o, cob.name, cp.name,
+				"last_id", "id_removed");
+		} else {
+			move_value(o, cob.name, cp.name,
+				"last_id", "id_removed", cp.data_type + "{}", 1);
+		}
+	}
+}
+
 basic_builder& make_internal_move_relationship(basic_builder& o, relationship_object_def const& cob) {
 	o + substitute{ "obj", cob.name } +substitute{ "size", std::to_string(cob.size) };
 	o + heading{ "container move relationship for @obj@" };
 
 	o + "void internal_move_relationship_@obj@(@obj@_id last_id, @obj@_id id_removed)" + block{
+		mark_lazy_indexes_dirty(o, cob);
+		move_pending_delete(o, cob);
+		if(cob.hierarchy_link.length() > 0) {
+			o + "@obj@.hierarchy_dirty.mark();";
+		}
 		{
 			std::string params;
 			for(auto& ck : cob.composite_indexes) {
@@ -1527,10 +1982,12 @@ basic_builder& make_internal_move_relationship(basic_builder& o, relationship_ob
 								};
 							}
 						}
-					} else if(io.ltype == list_type::array) {
+					} else if(io.ltype == list_type::array || io.ltype == list_type::sorted_array) {
+						o + substitute{ "pool_replace_unique", io.ltype == list_type::sorted_array ? "sorted_replace_unique_item" : "replace_unique_item" }
+							+substitute{ "pool_replace_all", io.ltype == list_type::sorted_array ? "sorted_replace_all_items" : "replace_all_items" };
 						if(io.multiplicity == 1) {
 							o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()]; bool(tmp))" + block{
-								o + "dcon::replace_unique_item(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+								o + "dcon::@pool_replace_unique@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 									" last_id, id_removed);";
 							};
 						} else {
@@ -1538,15 +1995,32 @@ basic_builder& make_internal_move_relationship(basic_builder& o, relationship_ob
 								o + substitute{ "i", std::to_string(i) };
 								o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()][@i@]; bool(tmp))" + block{
 									if(io.is_distinct) {
-										o + "dcon::replace_unique_item(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+										o + "dcon::@pool_replace_unique@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 											" last_id, id_removed);";
 									} else {
-										o + "dcon::replace_all_items(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
+										o + "dcon::@pool_replace_all@(@obj@.@i_prop@_storage, @obj@.m_array_@i_prop@.vptr()[tmp.index()],"
 											" last_id, id_removed);";
 									}
 								};
 							}
 						}
+					} else if(io.ltype == list_type::csr) {
+						if(io.multiplicity == 1) {
+							o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()]; bool(tmp))" + block{
+								o + "@obj@.@i_prop@_csr.replace_unique(tmp.index(), last_id, id_removed);";
+							};
+						} else {
+							for(int32_t i = 0; i < io.multiplicity; ++i) {
+								o + substitute{ "i", std::to_string(i) };
+								o + "if(auto tmp = @obj@.m_@i_prop@.vptr()[last_id.index()][@i@]; bool(tmp))" + block{
+									if(io.is_distinct) {
+										o + "@obj@.@i_prop@_csr.replace_unique(tmp.index(), last_id, id_removed);";
+									} else {
+										o + "@obj@.@i_prop@_csr.replace_all(tmp.index(), last_id, id_removed);";
+									}
+								};
+							}
+						}
 					}
 				}
 
@@ -1554,25 +2028,7 @@ basic_builder& make_internal_move_relationship(basic_builder& o, relationship_ob
 					"last_id", "id_removed", io.type_name + "_id()", io.multiplicity);
 			}
 		}
-		for(auto& cp : cob.properties) {
-			o + substitute{ "prop", cp.name };
-			if(cp.is_derived) {
-			} else if(cp.type == property_type::special_vector) {
-				o + "@obj@.@prop@_storage.release(@obj@.m_@prop@.vptr()[id_removed.index()]);";
-				move_value(o, cob.name, cp.name,
-					"last_id", "id_removed", "std::numeric_limits<dcon::stable_mk_2_tag>::max()", 1);
-			} else if(cp.type == property_type::bitfield) {
-				o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), id_removed.index(), "
-					"dcon::bit_vector_test(@obj@.m_@prop@.vptr(), last_id.index()));";
-				o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), last_id.index(), false);";
-			} else if(cp.type == property_type::array_bitfield || cp.type == property_type::array_other || cp.type == property_type::array_vectorizable) {
-				move_array_value(o, cob.name, cp.name,
-					"last_id", "id_removed");
-			} else {
-				move_value(o, cob.name, cp.name,
-					"last_id", "id_removed", cp.data_type + "{}", 1);
-			}
-		}
+		move_all_properties(o, cob);
 
 		for(auto& ck : cob.composite_indexes) {
 			if(ck.involves_primary_key) {
@@ -1623,40 +2079,318 @@ basic_builder& make_internal_move_relationship(basic_builder& o, relationship_ob
 	return o;
 }
 
-basic_builder& make_relation_try_create(basic_builder& o, relationship_object_def const& cob) {
-	o + substitute{ "obj", cob.name } +substitute{ "size", std::to_string(cob.size) }
-	+substitute{ "params", make_relationship_parameters(cob) };
-	o + heading{ "container try create relationship for @obj@" };
-
-	o + "@obj@_id try_create_@obj@(@params@)" + block{
-		for(auto& iob : cob.indexed_objects) {
-			o + substitute{ "prop", iob.property_name };
-			if(iob.multiplicity == 1) {
-				if(!iob.is_optional) {
-					o + "if(!bool(@prop@_p)) return @obj@_id();";
-				}
-				if(cob.primary_key != iob) {
-					if(iob.index == index_type::at_most_one) {
-						o + "if(bool(@prop@_p) && bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p.index()])) return @obj@_id();";
+basic_builder& make_internal_move_object(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name };
+	o + heading{ "container move object for @obj@" };
+
+	// moves the instance at last_id into the empty slot id_removed and points every link to it at its new position
+	bool const moves_anything = !cob.relationships_involved_in.empty()
+		|| cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable
+		|| std::any_of(cob.properties.begin(), cob.properties.end(), [](property_def const& cp) { return !cp.is_derived; });
+	o + substitute{ "move_params", moves_anything
+		? cob.name + "_id last_id, " + cob.name + "_id id_removed"
+		: cob.name + "_id, " + cob.name + "_id" };
+	o + "void internal_move_@obj@(@move_params@)" + block{
+		move_pending_delete(o, cob);
+		for(auto& cr : cob.relationships_involved_in) {
+			o + substitute{ "rel", cr.relation_name } +substitute{ "r_prop", cr.linked_as->property_name };
+			if(cr.linked_as->is_primary_key) {
+				o + "internal_move_relationship_@rel@(@rel@_id(@rel@_id::value_base_t(last_id.index())), @rel@_id(@rel@_id::value_base_t(id_removed.index())));";
+			} else if(cr.linked_as->index == index_type::at_most_one) {
+				o + "if(auto bk = @rel@.m_link_back_@r_prop@.vptr()[last_id.index()]; bool(bk))" + block{
+					if(cr.linked_as->is_covered_by_composite_key)
+						make_composite_key_internal_delete(o, *cr.rel_ptr, *cr.linked_as, "bk");
+					if(cr.linked_as->multiplicity > 1) {
+						for(int32_t j = 0; j < cr.linked_as->multiplicity; ++j) {
+							o + substitute{ "i", std::to_string(j) };
+							o + "if(@rel@.m_@r_prop@.vptr()[bk.index()][@i@] == last_id) @rel@.m_@r_prop@.vptr()[bk.index()][@i@] = id_removed;";
+						}
+						if(cr.linked_as->is_covered_by_composite_key) {
+							o + "std::sort(@rel@.m_@r_prop@.vptr()[bk.index()].begin(), @rel@.m_@r_prop@.vptr()[bk.index()].end(), [](@obj@_id l, @obj@_id r){ return l.value < r.value; });";
+						}
+					} else {
+						o + "@rel@.m_@r_prop@.vptr()[bk.index()] = id_removed;";
 					}
-				} else {
-					o + "if(@obj@_is_valid(@obj@_id(@obj@_id::value_base_t(@prop@_p.index())))) return @obj@_id();";
+					if(cr.linked_as->is_covered_by_composite_key)
+						make_composite_key_internal_assign(o, *cr.rel_ptr, *cr.linked_as, "bk");
+				};
+				move_value(o, cr.relation_name, std::string("link_back_") + cr.linked_as->property_name,
+					"last_id", "id_removed", cr.relation_name + "_id()", 1);
+			} else if(cr.linked_as->index == index_type::many) {
+				if(cr.rel_ptr->hierarchy_link == cr.linked_as->property_name) {
+					o + "@rel@.hierarchy_dirty.mark();";
 				}
-			} else {
-				for(int32_t i = 0; i < iob.multiplicity; ++i) {
-					o + substitute{ "i", std::to_string(i) };
-					if(!iob.is_optional) {
-						o + "if(!bool(@prop@_p@i@)) return @obj@_id();";
-					}
-					if(iob.index == index_type::at_most_one) {
-						o + "if(bool(@prop@_p@i@) && bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p@i@.index()])) return @obj@_id();";
-					}
-					if(iob.is_distinct) {
-						for(int32_t j = i + 1; j < iob.multiplicity; ++j) {
-							o + substitute{ "j", std::to_string(j) };
-							o + "if(bool(@prop@_p@i@) && @prop@_p@i@ == @prop@_p@j@) return @obj@_id();";
+				o + "@obj@_for_each_@rel@_as_@r_prop@(last_id, "
+					"[this, id_removed, last_id](@rel@_id i)" + block{
+						if(cr.linked_as->is_covered_by_composite_key)
+							make_composite_key_internal_delete(o, *cr.rel_ptr, *cr.linked_as, "i");
+						if(cr.linked_as->multiplicity > 1) {
+							for(int32_t j = 0; j < cr.linked_as->multiplicity; ++j) {
+								o + substitute{ "i", std::to_string(j) };
+								o + "if(@rel@.m_@r_prop@.vptr()[i.index()][@i@] == last_id) @rel@.m_@r_prop@.vptr()[i.index()][@i@] = id_removed;";
+							}
+							if(cr.linked_as->is_covered_by_composite_key) {
+								o + "std::sort(@rel@.m_@r_prop@.vptr()[i.index()].begin(), @rel@.m_@r_prop@.vptr()[i.index()].end(), [](@obj@_id l, @obj@_id r){ return l.value < r.value; });";
+							}
+						} else {
+							o + "@rel@.m_@r_prop@.vptr()[i.index()] = id_removed;";
 						}
-					}
+						if(cr.linked_as->is_covered_by_composite_key)
+							make_composite_key_internal_assign(o, *cr.rel_ptr, *cr.linked_as, "i");
+				} +append{ ");" };
+
+				if(cr.linked_as->ltype == list_type::list) {
+					move_value(o, cr.relation_name, std::string("head_back_") + cr.linked_as->property_name,
+						"last_id", "id_removed", cr.relation_name + "_id()", 1);
+				} else if(cr.linked_as->ltype == list_type::array || cr.linked_as->ltype == list_type::sorted_array) {
+					o + "@rel@.@r_prop@_storage.release(@rel@.m_array_@r_prop@.vptr()[id_removed.index()]);";
+					move_value(o, cr.relation_name, std::string("array_") + cr.linked_as->property_name,
+						"last_id", "id_removed", "std::numeric_limits<dcon::stable_mk_2_tag>::max()", 1);
+				} else if(cr.linked_as->ltype == list_type::std_vector) {
+					move_value(o, cr.relation_name, std::string("array_") + cr.linked_as->property_name,
+						"last_id", "id_removed", std::string("std::vector<") + cr.relation_name + "_id>{}", 1);
+				} else if(cr.linked_as->ltype == list_type::csr) {
+					o + "@rel@.@r_prop@_csr.move_list(last_id.index(), id_removed.index());";
+				}
+			}
+		}
+		move_all_properties(o, cob);
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_erasable_compact(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name } + substitute{ "size", std::to_string(cob.size) }
+		+ substitute{ "move_fn", cob.is_relationship ? std::string("internal_move_relationship_") : std::string("internal_move_") };
+	o + heading{ "container compaction for @obj@" };
+
+	// fills each hole, lowest first, with the live instance at the highest index, so that every instance moves at most once
+	o + "std::vector<@obj@_id> compact_@obj@()" + block{
+		o + "std::vector<@obj@_id> remap(@obj@.size_used);";
+		o + "for(uint32_t i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), 0, @obj@.size_used); i < @obj@.size_used; "
+			"i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), i + 1, @obj@.size_used))" + block{
+			o + "remap[i] = @obj@_id(@obj@_id::value_base_t(i));";
+		};
+		o + "uint32_t low = 0;";
+		o + "uint32_t high = @obj@.size_used;";
+		o + "while(true)" + block{
+			o + "while(low < high && dcon::bit_vector_test(@obj@.m__live.vptr(), int32_t(low))) ++low;";
+			o + "while(high > low && !dcon::bit_vector_test(@obj@.m__live.vptr(), int32_t(high - 1))) --high;";
+			o + "if(low >= high) break;";
+			o + "auto last_id = @obj@_id(@obj@_id::value_base_t(high - 1));";
+			o + "auto id_removed = @obj@_id(@obj@_id::value_base_t(low));";
+			o + "@move_fn@@obj@(last_id, id_removed);";
+			o + "@obj@.m__index.vptr()[low] = id_removed;";
+			o + "dcon::bit_vector_set(@obj@.m__live.vptr(), int32_t(low), true);";
+			o + "dcon::bit_vector_set(@obj@.m__live.vptr(), int32_t(high - 1), false);";
+			o + "remap[high - 1] = id_removed;";
+			if(cob.hook_move)
+				o + "on_move_@obj@(id_removed, last_id);";
+			o + "++low;";
+			o + "--high;";
+		};
+		o + "@obj@.size_used = @obj@.live_count;";
+
+		// all remaining slots form the free list, in ascending order
+		if(cob.is_expandable)
+			o + "const uint32_t capacity = uint32_t(@obj@.m__index.values.size() - 1);";
+		else
+			o + "const uint32_t capacity = @size@;";
+		o + "@obj@.first_free = @obj@_id();";
+		o + "for(uint32_t i = capacity; i-- > @obj@.size_used; )" + block{
+			o + "@obj@.m__index.vptr()[i] = @obj@.first_free;";
+			o + "@obj@.first_free = @obj@_id(@obj@_id::value_base_t(i));";
+		};
+		o + "return remap;";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_object_reorder(basic_builder& o, relationship_object_def const& cob, file_def const& parsed_file) {
+	o + substitute{ "obj", cob.name } + substitute{ "size", std::to_string(cob.size) };
+	o + heading{ "container reorder for @obj@" };
+
+	// new_order[i] is the instance that ends up at index i; each cycle of the permutation is rotated through
+	// a scratch slot one past the end, so that every instance is moved exactly once
+	o + "void reorder_@obj@(@obj@_id const* new_order, uint32_t new_order_count)" + block{
+		o + "const uint32_t count = @obj@.size_used;";
+		o + "#ifndef NDEBUG";
+		o + "assert(new_order_count == count);";
+		o + "#endif";
+		o + "std::vector<@obj@_id> new_position(count);";
+		o + "bool is_identity = true;";
+		o + "for(uint32_t i = 0; i < count; ++i)" + block{
+			o + "#ifndef NDEBUG";
+			o + "assert(!bool(new_position[new_order[i].index()]));";
+			o + "#endif";
+			o + "new_position[new_order[i].index()] = @obj@_id(@obj@_id::value_base_t(i));";
+			o + "is_identity = is_identity && new_order[i] == @obj@_id(@obj@_id::value_base_t(i));";
+		};
+		o + "if(is_identity) return;";
+
+		o + "auto scratch = @obj@_id(@obj@_id::value_base_t(count));";
+		if(cob.is_expandable) {
+			expandable_push_back(o, cob);
+		} else {
+			o + "#ifndef DCON_USE_EXCEPTIONS";
+			o + "if(@obj@.size_used >= @size@) std::abort();";
+			o + "#else";
+			o + "if(@obj@.size_used >= @size@) throw dcon::out_of_space{};";
+			o + "#endif";
+			increase_size(o, cob);
+		}
+
+		o + "std::vector<dcon::bitfield_type> placed((count + 7) / 8);";
+		o + "for(uint32_t i = 0; i < count; ++i)" + block{
+			o + "auto start = @obj@_id(@obj@_id::value_base_t(i));";
+			o + "if(new_order[i] == start || dcon::bit_vector_test(placed.data(), int32_t(i))) continue;";
+			o + "internal_move_@obj@(start, scratch);";
+			o + "auto dest = start;";
+			o + "while(true)" + block{
+				o + "dcon::bit_vector_set(placed.data(), dest.index(), true);";
+				o + "auto src = new_order[dest.index()];";
+				o + "if(src == start)" + block{
+					o + "internal_move_@obj@(scratch, dest);";
+					o + "break;";
+				};
+				o + "internal_move_@obj@(src, dest);";
+				o + "dest = src;";
+			};
+		};
+
+		if(cob.is_expandable) {
+			expandable_pop_back(o, cob, "scratch");
+		} else {
+			o + "--@obj@.size_used;";
+		}
+
+		// unindexed links are not reached by internal_move, so they are rewritten in a single pass at the end
+		for(auto& rel : parsed_file.relationship_objects) {
+			for(auto& io : rel.indexed_objects) {
+				if(io.related_to != &cob || io.index != index_type::none)
+					continue;
+
+				o + substitute{ "rel", rel.name } + substitute{ "r_prop", io.property_name }
+					+ substitute{ "rel_pk", rel.primary_key.points_to ? rel.primary_key.points_to->name : rel.name };
+				if(io.is_covered_by_composite_key) {
+					o + "for(uint32_t j = 0; j < @rel_pk@.size_used; ++j)" + block{
+						o + "auto r = @rel@_id(@rel@_id::value_base_t(j));";
+						o + "if(!@rel@_is_valid(r)) continue;";
+						make_composite_key_internal_delete(o, rel, io, "r");
+					};
+				}
+				o + "for(uint32_t j = 0; j < @rel_pk@.size_used; ++j)" + block{
+					o + "auto r = @rel@_id(@rel@_id::value_base_t(j));";
+					o + "if(!@rel@_is_valid(r)) continue;";
+					if(io.multiplicity == 1) {
+						o + "if(auto& v = @rel@.m_@r_prop@.vptr()[j]; bool(v)) v = new_position[v.index()];";
+					} else {
+						o + "for(auto& v : @rel@.m_@r_prop@.vptr()[j])" + block{
+							o + "if(bool(v)) v = new_position[v.index()];";
+						};
+						if(io.is_covered_by_composite_key) {
+							o + "std::sort(@rel@.m_@r_prop@.vptr()[j].begin(), @rel@.m_@r_prop@.vptr()[j].end(), [](@obj@_id l, @obj@_id r){ return l.value < r.value; });";
+						}
+					}
+					make_composite_key_internal_assign(o, rel, io, "r");
+				};
+				if(io.is_lazy_index)
+					o + "@rel@.@r_prop@_lazy_dirty.mark();";
+			}
+		}
+
+		if(cob.hook_move) {
+			o + "for(uint32_t i = 0; i < count; ++i)" + block{
+				o + "if(new_order[i] != @obj@_id(@obj@_id::value_base_t(i)))" + block{
+					o + "on_move_@obj@(@obj@_id(@obj@_id::value_base_t(i)), new_order[i]);";
+				};
+			};
+		}
+	};
+
+	o + "template<typename F>";
+	o + "std::vector<@obj@_id> @obj@_order_by(F&& key) const" + block{
+		o + "using key_type = std::decay_t<decltype(key(@obj@_id()))>;";
+		o + "std::vector<key_type> keys;";
+		o + "std::vector<@obj@_id> result;";
+		o + "keys.reserve(@obj@.size_used);";
+		o + "result.reserve(@obj@.size_used);";
+		o + "for(uint32_t i = 0; i < @obj@.size_used; ++i)" + block{
+			o + "auto id = @obj@_id(@obj@_id::value_base_t(i));";
+			o + "keys.push_back(key(id));";
+			o + "result.push_back(id);";
+		};
+		o + "std::stable_sort(result.begin(), result.end(), [&](@obj@_id a, @obj@_id b) { return keys[a.index()] < keys[b.index()]; });";
+		o + "return result;";
+	};
+
+	o + "template<typename FX, typename FY>";
+	o + "std::vector<@obj@_id> @obj@_order_by_curve(FX&& x, FY&& y, dcon::space_filling_curve curve = dcon::space_filling_curve::hilbert) const" + block{
+		o + "const uint32_t count = @obj@.size_used;";
+		o + "std::vector<float> xs(count);";
+		o + "std::vector<float> ys(count);";
+		o + "float min_x = std::numeric_limits<float>::max();";
+		o + "float max_x = std::numeric_limits<float>::lowest();";
+		o + "float min_y = std::numeric_limits<float>::max();";
+		o + "float max_y = std::numeric_limits<float>::lowest();";
+		o + "for(uint32_t i = 0; i < count; ++i)" + block{
+			o + "auto id = @obj@_id(@obj@_id::value_base_t(i));";
+			o + "xs[i] = float(x(id));";
+			o + "ys[i] = float(y(id));";
+			o + "min_x = std::min(min_x, xs[i]);";
+			o + "max_x = std::max(max_x, xs[i]);";
+			o + "min_y = std::min(min_y, ys[i]);";
+			o + "max_y = std::max(max_y, ys[i]);";
+		};
+		o + "return @obj@_order_by([&](@obj@_id id)" + block{
+			o + "auto qx = dcon::quantize_coordinate(xs[id.index()], min_x, max_x);";
+			o + "auto qy = dcon::quantize_coordinate(ys[id.index()], min_y, max_y);";
+			o + "return curve == dcon::space_filling_curve::hilbert ? dcon::hilbert_index(qx, qy) : dcon::morton_index(qx, qy);";
+		} + append{ ");" };
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_relation_try_create(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name } +substitute{ "size", std::to_string(cob.size) }
+	+substitute{ "params", make_relationship_parameters(cob) };
+	o + heading{ "container try create relationship for @obj@" };
+
+	o + "@obj@_id try_create_@obj@(@params@)" + block{
+		for(auto& iob : cob.indexed_objects) {
+			o + substitute{ "prop", iob.property_name };
+			if(iob.multiplicity == 1) {
+				if(!iob.is_optional) {
+					o + "if(!bool(@prop@_p)) return @obj@_id();";
+				}
+				if(cob.primary_key != iob) {
+					if(iob.index == index_type::at_most_one) {
+						o + "if(bool(@prop@_p) && bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p.index()])) return @obj@_id();";
+					}
+				} else {
+					o + "if(@obj@_is_valid(@obj@_id(@obj@_id::value_base_t(@prop@_p.index())))) return @obj@_id();";
+				}
+			} else {
+				for(int32_t i = 0; i < iob.multiplicity; ++i) {
+					o + substitute{ "i", std::to_string(i) };
+					if(!iob.is_optional) {
+						o + "if(!bool(@prop@_p@i@)) return @obj@_id();";
+					}
+					if(iob.index == index_type::at_most_one) {
+						o + "if(bool(@prop@_p@i@) && bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p@i@.index()])) return @obj@_id();";
+					}
+					if(iob.is_distinct) {
+						for(int32_t j = i + 1; j < iob.multiplicity; ++j) {
+							o + substitute{ "j", std::to_string(j) };
+							o + "if(bool(@prop@_p@i@) && @prop@_p@i@ == @prop@_p@j@) return @obj@_id();";
+						}
+					}
 				}
 
 				o + substitute{ "mult", std::to_string(iob.multiplicity) };
@@ -1854,13 +2588,593 @@ basic_builder& make_relation_force_create(basic_builder& o, relationship_object_
 			}
 		}
 
-		if(cob.hook_create)
-			o + "on_create_@obj@(new_id);";
+		if(cob.hook_create)
+			o + "on_create_@obj@(new_id);";
+
+		o + "return new_id;";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_relation_bulk_create(basic_builder& o, relationship_object_def const& cob) {
+	o + substitute{ "obj", cob.name } +substitute{ "size", std::to_string(cob.size) };
+	o + heading{ "container bulk create relationship for @obj@" };
+
+	o + "struct @obj@_link_tuple" + class_block{
+		for(auto& iob : cob.indexed_objects) {
+			o + substitute{ "prop", iob.property_name } +substitute{ "id_type", iob.type_name + "_id" };
+			if(iob.multiplicity == 1) {
+				o + "@id_type@ @prop@;";
+			} else {
+				o + substitute{ "mult", std::to_string(iob.multiplicity) };
+				o + "std::array<@id_type@, @mult@> @prop@;";
+			}
+		}
+	};
+
+	o + "uint32_t bulk_create_@obj@(@obj@_link_tuple const* links, uint32_t link_count, @obj@_id* ids_out = nullptr)" + block{
+		// pass 1: validate against the container and against the earlier members of the batch
+
+		o + "std::vector<uint32_t> accepted;";
+		o + "accepted.reserve(link_count);";
+		for(auto& iob : cob.indexed_objects) {
+			if(iob.index == index_type::at_most_one) {
+				o + substitute{ "prop", iob.property_name } +substitute{ "i_type", iob.type_name };
+				o + "std::vector<dcon::bitfield_type> claimed_@prop@((@i_type@_size() + 7) / 8);";
+			}
+		}
+		for(auto& ck : cob.composite_indexes) {
+			o + substitute{ "ckname", ck.name };
+			o + "std::vector<decltype(@obj@.hashm_@ckname@)::key_type> keys_@ckname@;";
+			o + "keys_@ckname@.reserve(link_count);";
+			o + "@obj@.hashm_@ckname@.reserve(@obj@.hashm_@ckname@.size() + link_count);";
+		}
+
+		o + "for(uint32_t i = 0; i < link_count; ++i)" + block{
+			o + "if(ids_out) ids_out[i] = @obj@_id();";
+			for(auto& iob : cob.indexed_objects) {
+				bool in_key = false;
+				for(auto& ck : cob.composite_indexes) {
+					for(auto& idx : ck.component_indexes)
+						in_key = in_key || idx.property_name == iob.property_name;
+				}
+				// links that nothing below checks are only read when they are written in pass 3
+				if(iob.is_optional && cob.primary_key != iob && iob.index != index_type::at_most_one && !in_key && !iob.is_distinct)
+					continue;
+				o + substitute{ "prop", iob.property_name } +substitute{ "id_type", iob.type_name + "_id" };
+				o + "auto @prop@_p = links[i].@prop@;";
+				if(iob.multiplicity == 1) {
+					if(!iob.is_optional) {
+						o + "if(!bool(@prop@_p)) continue;";
+					}
+					if(cob.primary_key != iob) {
+						if(iob.index == index_type::at_most_one) {
+							o + "if(bool(@prop@_p) && (bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p.index()]) || "
+								"(uint32_t(@prop@_p.index()) < claimed_@prop@.size() * 8 && dcon::bit_vector_test(claimed_@prop@.data(), @prop@_p.index())))) continue;";
+						}
+					} else {
+						o + "if(@obj@_is_valid(@obj@_id(@obj@_id::value_base_t(@prop@_p.index()))) || "
+							"(uint32_t(@prop@_p.index()) < claimed_@prop@.size() * 8 && dcon::bit_vector_test(claimed_@prop@.data(), @prop@_p.index()))) continue;";
+					}
+				} else {
+					for(int32_t i = 0; i < iob.multiplicity; ++i) {
+						o + substitute{ "i", std::to_string(i) };
+						if(!iob.is_optional) {
+							o + "if(!bool(@prop@_p[@i@])) continue;";
+						}
+						if(iob.index == index_type::at_most_one) {
+							o + "if(bool(@prop@_p[@i@]) && (bool(@obj@.m_link_back_@prop@.vptr()[@prop@_p[@i@].index()]) || "
+								"(uint32_t(@prop@_p[@i@].index()) < claimed_@prop@.size() * 8 && dcon::bit_vector_test(claimed_@prop@.data(), @prop@_p[@i@].index())))) continue;";
+						}
+						if(iob.is_distinct) {
+							for(int32_t j = i + 1; j < iob.multiplicity; ++j) {
+								o + substitute{ "j", std::to_string(j) };
+								o + "if(bool(@prop@_p[@i@]) && @prop@_p[@i@] == @prop@_p[@j@]) continue;";
+							}
+						}
+					}
+					if(iob.is_covered_by_composite_key) {
+						o + "std::sort(@prop@_p.begin(), @prop@_p.end(), [](@id_type@ a, @id_type@ b){ return a.value < b.value; });";
+					}
+				}
+			}
+
+			for(auto& ck : cob.composite_indexes) {
+				std::string params;
+				for(auto& idx : ck.component_indexes) {
+					if(params.length() > 0)
+						params += ", ";
+					params += idx.property_name + "_p";
+				}
+				o + substitute{ "params", params } +substitute{ "ckname", ck.name };
+				o + "auto key_@ckname@ = @obj@.to_@ckname@_keydata(@params@);";
+				if(!ck.involves_primary_key) {
+					o + "if(@obj@.hashm_@ckname@.contains(key_@ckname@)) continue;";
+				}
+			}
+
+			// accepted: claim the unique targets and reserve the keys so that later duplicates in the batch are rejected
+			for(auto& iob : cob.indexed_objects) {
+				if(iob.index == index_type::at_most_one) {
+					o + substitute{ "prop", iob.property_name };
+					if(iob.multiplicity == 1) {
+						o + "if(bool(@prop@_p))" + block{
+							o + "if(uint32_t(@prop@_p.index()) >= claimed_@prop@.size() * 8) claimed_@prop@.resize(@prop@_p.index() / 8 + 1);";
+							o + "dcon::bit_vector_set(claimed_@prop@.data(), @prop@_p.index(), true);";
+						};
+					} else {
+						o + "for(auto v : @prop@_p)" + block{
+							o + "if(bool(v))" + block{
+								o + "if(uint32_t(v.index()) >= claimed_@prop@.size() * 8) claimed_@prop@.resize(v.index() / 8 + 1);";
+								o + "dcon::bit_vector_set(claimed_@prop@.data(), v.index(), true);";
+							};
+						};
+					}
+				}
+			}
+			for(auto& ck : cob.composite_indexes) {
+				o + substitute{ "ckname", ck.name };
+				if(!ck.involves_primary_key) {
+					o + "@obj@.hashm_@ckname@.insert_or_assign(key_@ckname@, @obj@_id());";
+				}
+				o + "keys_@ckname@.push_back(key_@ckname@);";
+			}
+			o + "accepted.push_back(i);";
+		};
+
+		o + "const uint32_t count = uint32_t(accepted.size());";
+		o + "if(count == 0) return 0;";
+
+		// pass 2: claim ids for every accepted instance
+
+		o + "std::vector<@obj@_id> new_ids(count);";
+		if(cob.primary_key.points_to != nullptr) {
+			for(auto& iob : cob.indexed_objects) {
+				if(cob.primary_key == iob) {
+					o + substitute{ "pkey", iob.property_name };
+				}
+			}
+			o + substitute{ "pk_obj", cob.primary_key.points_to->name };
+			o + "for(uint32_t k = 0; k < count; ++k)" + block{
+				o + "auto @pkey@_p = links[accepted[k]].@pkey@;";
+				o + "new_ids[k] = @obj@_id(@obj@_id::value_base_t(@pkey@_p.index()));";
+				o + "if(@pk_obj@.size_used < uint32_t(@pkey@_p.value)) @pk_obj@_resize(uint32_t(@pkey@_p.value));";
+			};
+		} else {
+			if(!cob.is_expandable) {
+				if(cob.store_type != storage_type::erasable) {
+					o + "const uint32_t available = @size@ - @obj@.size_used;";
+				} else {
+					o + "uint32_t available = 0;";
+					o + "for(auto f = @obj@.first_free; bool(f) && available < count; f = @obj@.m__index.vptr()[f.index()]) ++available;";
+				}
+				o + "if(available < count)" + block{
+					o + "#ifndef DCON_USE_EXCEPTIONS";
+					o + "std::abort();";
+					o + "#else";
+					for(auto& ck : cob.composite_indexes) {
+						o + substitute{ "ckname", ck.name };
+						if(!ck.involves_primary_key) {
+							o + "for(auto& k : keys_@ckname@) @obj@.hashm_@ckname@.erase(k);";
+						}
+					}
+					o + "throw dcon::out_of_space{};";
+					o + "#endif";
+				};
+			}
+			if(cob.store_type != storage_type::erasable) {
+				o + "const uint32_t first_new = @obj@.size_used;";
+				o + "@obj@_resize(first_new + count);";
+				o + "for(uint32_t k = 0; k < count; ++k)" + block{
+					o + "new_ids[k] = @obj@_id(@obj@_id::value_base_t(first_new + k));";
+				};
+			} else {
+				o + "for(uint32_t k = 0; k < count; ++k)" + block{
+					erasable_set_new_id(o, cob);
+					o + "new_ids[k] = new_id;";
+				};
+			}
+		}
+
+		// pass 3: write the link values and the unique back references
+
+		mark_lazy_indexes_dirty(o, cob);
+		if(cob.hierarchy_link.length() > 0) {
+			o + "@obj@.hierarchy_dirty.mark();";
+		}
+		bool const writes_links = std::any_of(cob.indexed_objects.begin(), cob.indexed_objects.end(),
+			[&](related_object const& iob) { return !(cob.primary_key == iob); });
+		if(writes_links) {
+			o + "for(uint32_t k = 0; k < count; ++k)" + block{
+				o + "auto const& e = links[accepted[k]];";
+				o + "auto new_id = new_ids[k];";
+				for(auto& iob : cob.indexed_objects) {
+					if(cob.primary_key == iob)
+						continue;
+					o + substitute{ "prop", iob.property_name } +substitute{ "id_type", iob.type_name + "_id" };
+					if(iob.index == index_type::many && iob.ltype == list_type::list) {
+						o + "internal_@obj@_set_@prop@(new_id, e.@prop@);";
+						continue;
+					}
+					o + "@obj@.m_@prop@.vptr()[new_id.index()] = e.@prop@;";
+					if(iob.multiplicity > 1 && iob.is_covered_by_composite_key) {
+						o + "std::sort(@obj@.m_@prop@.vptr()[new_id.index()].begin(), @obj@.m_@prop@.vptr()[new_id.index()].end(), "
+							"[](@id_type@ a, @id_type@ b){ return a.value < b.value; });";
+					}
+					if(iob.index == index_type::at_most_one) {
+						if(iob.multiplicity == 1) {
+							o + "if(bool(e.@prop@)) @obj@.m_link_back_@prop@.vptr()[e.@prop@.index()] = new_id;";
+						} else {
+							o + "for(auto v : e.@prop@)" + block{
+								o + "if(bool(v)) @obj@.m_link_back_@prop@.vptr()[v.index()] = new_id;";
+							};
+						}
+					}
+				}
+			};
+		}
+
+		// pass 4: build the many indexes, grouped by target so that each list grows at most once
+
+		for(auto& iob : cob.indexed_objects) {
+			if(iob.index != index_type::many || iob.ltype == list_type::list)
+				continue;
+			o + substitute{ "prop", iob.property_name } +substitute{ "id_type", iob.type_name + "_id" };
+			o + inline_block{
+				o + "std::vector<std::pair<@id_type@, @obj@_id>> pending;";
+				o + substitute{ "mult", std::to_string(iob.multiplicity) };
+				o + "pending.reserve(size_t(count) * @mult@);";
+				o + "for(uint32_t k = 0; k < count; ++k)" + block{
+					if(iob.multiplicity == 1) {
+						o + "if(auto v = @obj@.m_@prop@.vptr()[new_ids[k].index()]; bool(v)) pending.emplace_back(v, new_ids[k]);";
+					} else {
+						o + "for(auto v : @obj@.m_@prop@.vptr()[new_ids[k].index()])" + block{
+							o + "if(bool(v)) pending.emplace_back(v, new_ids[k]);";
+						};
+					}
+				};
+				o + "std::stable_sort(pending.begin(), pending.end(), [](auto const& a, auto const& b){ return a.first.index() < b.first.index(); });";
+				o + "for(size_t j = 0; j < pending.size(); )" + block{
+					o + "auto target = pending[j].first;";
+					o + "size_t run_end = j + 1;";
+					o + "while(run_end < pending.size() && pending[run_end].first == target) ++run_end;";
+					if(iob.ltype == list_type::array || iob.ltype == list_type::sorted_array) {
+						o + "auto& tag = @obj@.m_array_@prop@.vptr()[target.index()];";
+						o + "@obj@.@prop@_storage.increase_capacity(tag, dcon::get_size(@obj@.@prop@_storage, tag) + uint32_t(run_end - j));";
+						o + "for(; j < run_end; ++j) dcon::push_back(@obj@.@prop@_storage, tag, pending[j].second);";
+						if(iob.ltype == list_type::sorted_array) {
+							o + "auto vrange = dcon::get_range(@obj@.@prop@_storage, tag);";
+							o + "std::sort(vrange.first, vrange.second, [](@obj@_id a, @obj@_id b){ return a.value < b.value; });";
+						}
+					} else if(iob.ltype == list_type::std_vector) {
+						o + "auto& vref = @obj@.m_array_@prop@.vptr()[target.index()];";
+						o + "vref.reserve(vref.size() + (run_end - j));";
+						o + "for(; j < run_end; ++j) vref.push_back(pending[j].second);";
+					} else if(iob.ltype == list_type::csr) {
+						o + "for(; j < run_end; ++j) @obj@.@prop@_csr.push_back(target.index(), pending[j].second);";
+					}
+				};
+			};
+		}
+
+		for(auto& ck : cob.composite_indexes) {
+			o + substitute{ "ckname", ck.name };
+			o + "for(uint32_t k = 0; k < count; ++k) @obj@.hashm_@ckname@.insert_or_assign(keys_@ckname@[k], new_ids[k]);";
+		}
+
+		if(cob.hook_create) {
+			o + "for(uint32_t k = 0; k < count; ++k) on_create_@obj@(new_ids[k]);";
+		}
+		o + "if(ids_out)" + block{
+			o + "for(uint32_t k = 0; k < count; ++k) ids_out[accepted[k]] = new_ids[k];";
+		};
+		o + "return count;";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_relation_freeze(basic_builder& o, relationship_object_def const& cob) {
+	bool has_csr = false;
+	for(auto& iob : cob.indexed_objects) {
+		if(iob.index == index_type::many && iob.ltype == list_type::csr)
+			has_csr = true;
+	}
+	if(!has_csr)
+		return o;
+
+	o + substitute{ "obj", cob.name };
+	o + heading{ "container freeze csr indexes for @obj@" };
+
+	o + "void freeze_@obj@()" + block{
+		for(auto& iob : cob.indexed_objects) {
+			if(iob.index == index_type::many && iob.ltype == list_type::csr) {
+				o + substitute{ "prop", iob.property_name };
+				o + "@obj@.@prop@_csr.freeze();";
+			}
+		}
+	};
+	o + "uint32_t @obj@_pending_index_changes() const" + block{
+		o + "uint32_t total = 0;";
+		for(auto& iob : cob.indexed_objects) {
+			if(iob.index == index_type::many && iob.ltype == list_type::csr) {
+				o + substitute{ "prop", iob.property_name };
+				o + "total += @obj@.@prop@_csr.pending_changes();";
+			}
+		}
+		o + "return total;";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_hierarchy_index(basic_builder& o, relationship_object_def const& cob) {
+	if(cob.hierarchy_link.length() == 0)
+		return o;
+
+	o + substitute{ "obj", cob.name } +substitute{ "node", cob.primary_key.points_to->name } +substitute{ "parent", cob.hierarchy_link };
+	o + heading{ "container hierarchy index for @obj@" };
+
+	// queries are const and may rebuild the layout, which is kept in mutable members; only one thread rebuilds it
+	o + "void @obj@_update_hierarchy() const" + block{
+		o + "@obj@.hierarchy_dirty.ensure([&]()" + block{
+			o + "const uint32_t n = @node@.size_used;";
+			o + "auto& position = @obj@.hierarchy_position;";
+			o + "auto& subtree_end = @obj@.hierarchy_subtree_end;";
+			o + "auto& depth = @obj@.hierarchy_depth;";
+			o + "auto& preorder = @obj@.hierarchy_preorder;";
+			o + "position.assign(n, std::numeric_limits<uint32_t>::max());";
+			o + "subtree_end.assign(n, 0);";
+			o + "depth.assign(n, 0);";
+			o + "preorder.clear();";
+			o + "preorder.reserve(n);";
+
+			// children packed contiguously by parent, so the walk below does not chase the link lists
+			o + "std::vector<uint32_t> child_start(n + 1, 0);";
+			o + "for(uint32_t i = 0; i < n; ++i)" + block{
+				o + "if(auto p = @obj@.m_@parent@.vptr()[i]; bool(p)) ++child_start[p.index() + 1];";
+			};
+			o + "for(uint32_t i = 0; i < n; ++i) child_start[i + 1] += child_start[i];";
+			o + "std::vector<@node@_id> children(child_start[n]);";
+			o + "std::vector<uint32_t> fill(child_start.begin(), child_start.end() - 1);";
+			o + "for(uint32_t i = 0; i < n; ++i)" + block{
+				o + "if(auto p = @obj@.m_@parent@.vptr()[i]; bool(p)) children[fill[p.index()]++] = @node@_id(@node@_id::value_base_t(i));";
+			};
+
+			// depth first from each root; a node is numbered when first reached and closed when it is reached again
+			o + "std::vector<uint32_t> stack;";
+			o + "for(uint32_t r = 0; r < n; ++r)" + block{
+				o + "if(!@node@_is_valid(@node@_id(@node@_id::value_base_t(r))) || bool(@obj@.m_@parent@.vptr()[r])) continue;";
+				o + "stack.push_back(r);";
+				o + "while(!stack.empty())" + block{
+					o + "const uint32_t x = stack.back();";
+					o + "if(position[x] == std::numeric_limits<uint32_t>::max())" + block{
+						o + "position[x] = uint32_t(preorder.size());";
+						o + "preorder.push_back(@node@_id(@node@_id::value_base_t(x)));";
+						o + "for(uint32_t k = child_start[x + 1]; k-- > child_start[x]; )" + block{
+							o + "depth[children[k].index()] = depth[x] + 1;";
+							o + "stack.push_back(uint32_t(children[k].index()));";
+						};
+					} +append{ "else" } +block{
+						o + "subtree_end[x] = uint32_t(preorder.size());";
+						o + "stack.pop_back();";
+					};
+				};
+			};
+
+			// counting sort of the pre-order by depth
+			o + "uint32_t levels = 0;";
+			o + "for(auto v : preorder) levels = std::max(levels, depth[v.index()] + 1);";
+			o + "auto& depth_start = @obj@.hierarchy_depth_start;";
+			o + "depth_start.assign(levels + 1, 0);";
+			o + "for(auto v : preorder) ++depth_start[depth[v.index()] + 1];";
+			o + "for(uint32_t d = 0; d < levels; ++d) depth_start[d + 1] += depth_start[d];";
+			o + "@obj@.hierarchy_by_depth.resize(preorder.size());";
+			o + "std::vector<uint32_t> level_fill(depth_start.begin(), depth_start.end() - 1);";
+			o + "for(auto v : preorder) @obj@.hierarchy_by_depth[level_fill[depth[v.index()]]++] = v;";
+		} + append{ ");" };
+	};
+
+	o + "bool @obj@_is_ancestor(@node@_id ancestor, @node@_id descendant) const" + block{
+		o + "if(!bool(ancestor) || !bool(descendant)) return false;";
+		o + "@obj@_update_hierarchy();";
+		o + "if(uint32_t(ancestor.index()) >= @obj@.hierarchy_position.size() || uint32_t(descendant.index()) >= @obj@.hierarchy_position.size()) return false;";
+		o + "auto pa = @obj@.hierarchy_position[ancestor.index()];";
+		o + "auto pd = @obj@.hierarchy_position[descendant.index()];";
+		o + "return pa < pd && pd < @obj@.hierarchy_subtree_end[ancestor.index()];";
+	};
+	o + "std::pair<@node@_id const*, @node@_id const*> @obj@_subtree_of(@node@_id root) const" + block{
+		o + "if(!bool(root)) return std::pair<@node@_id const*, @node@_id const*>(nullptr, nullptr);";
+		o + "@obj@_update_hierarchy();";
+		o + "if(uint32_t(root.index()) >= @obj@.hierarchy_position.size()) return std::pair<@node@_id const*, @node@_id const*>(nullptr, nullptr);";
+		o + "auto p = @obj@.hierarchy_position[root.index()];";
+		o + "if(p == std::numeric_limits<uint32_t>::max()) return std::pair<@node@_id const*, @node@_id const*>(nullptr, nullptr);";
+		o + "return std::pair<@node@_id const*, @node@_id const*>(@obj@.hierarchy_preorder.data() + p, @obj@.hierarchy_preorder.data() + @obj@.hierarchy_subtree_end[root.index()]);";
+	};
+	o + "uint32_t @obj@_depth_of(@node@_id id) const" + block{
+		o + "if(!bool(id)) return 0;";
+		o + "@obj@_update_hierarchy();";
+		o + "if(uint32_t(id.index()) >= @obj@.hierarchy_depth.size()) return 0;";
+		o + "return @obj@.hierarchy_depth[id.index()];";
+	};
+	o + "uint32_t @obj@_level_count() const" + block{
+		o + "@obj@_update_hierarchy();";
+		o + "return uint32_t(@obj@.hierarchy_depth_start.size() - 1);";
+	};
+	o + "std::pair<@node@_id const*, @node@_id const*> @obj@_by_depth() const" + block{
+		o + "@obj@_update_hierarchy();";
+		o + "return std::pair<@node@_id const*, @node@_id const*>(@obj@.hierarchy_by_depth.data(), @obj@.hierarchy_by_depth.data() + @obj@.hierarchy_by_depth.size());";
+	};
+	o + "std::pair<@node@_id const*, @node@_id const*> @obj@_at_depth(uint32_t d) const" + block{
+		o + "@obj@_update_hierarchy();";
+		o + "if(d + 1 >= @obj@.hierarchy_depth_start.size()) return std::pair<@node@_id const*, @node@_id const*>(nullptr, nullptr);";
+		o + "return std::pair<@node@_id const*, @node@_id const*>(@obj@.hierarchy_by_depth.data() + @obj@.hierarchy_depth_start[d], "
+			"@obj@.hierarchy_by_depth.data() + @obj@.hierarchy_depth_start[d + 1]);";
+	};
+
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_lazy_index(basic_builder& o, relationship_object_def const& cob) {
+	for(auto& io : cob.indexed_objects) {
+		if(!io.is_lazy_index)
+			continue;
+
+		o + substitute{ "rel", cob.name } +substitute{ "prop", io.property_name } +substitute{ "target", io.type_name };
+		o + heading{ "container lazy index for @rel@ @prop@" };
+
+		// visits each stored link of row i
+		auto for_each_value = [&](std::string body) {
+			// substitutions are not applied recursively, so the relationship name is filled in here
+			for(auto p = body.find("@rel@"); p != std::string::npos; p = body.find("@rel@", p))
+				body.replace(p, 5, cob.name);
+			o + substitute{ "body", body };
+			if(io.multiplicity == 1) {
+				o + "if(auto v = @rel@.m_@prop@.vptr()[i]; bool(v)) @body@";
+			} else {
+				o + "for(auto v : @rel@.m_@prop@.vptr()[i])" + block{
+					o + "if(bool(v)) @body@";
+				};
+			}
+		};
+
+		// the rebuild is guarded by the rebuild_flag, so that concurrent lookups through a const reference wait for
+		// a single thread to build the index instead of racing on it
+		o + "void @rel@_update_@prop@_index() const" + block{
+			o + "@rel@.@prop@_lazy_dirty.ensure([&]()" + block{
+				o + "const uint32_t n = @rel@_size();";
+				// creating a target does not mark the index dirty, so it must also cover links to targets that do not exist yet
+				o + "uint32_t targets = @target@_size();";
+				o + "for(uint32_t i = 0; i < n; ++i)" + block{
+					o + "if(!@rel@_is_valid(@rel@_id(@rel@_id::value_base_t(i)))) continue;";
+					for_each_value("targets = std::max(targets, uint32_t(v.index()) + 1);");
+				};
+				o + "auto& offsets = @rel@.@prop@_lazy_offsets;";
+				o + "auto& values = @rel@.@prop@_lazy_values;";
+				o + "offsets.assign(targets + 1, 0);";
+
+				o + "#ifndef DCON_NO_VE";
+				o + "#ifndef VE_NO_TBB";
+				o + "if(n >= 4096)" + block{
+					o + "std::unique_ptr<std::atomic<uint32_t>[]> cursor(new std::atomic<uint32_t>[targets + 1]());";
+					o + "concurrency::parallel_for(uint32_t(0), n, [&](uint32_t i)" + block{
+						o + "if(!@rel@_is_valid(@rel@_id(@rel@_id::value_base_t(i)))) return;";
+						for_each_value("cursor[v.index()].fetch_add(1, std::memory_order_relaxed);");
+					} +append{ ");" };
+					o + "for(uint32_t t = 0; t < targets; ++t)" + block{
+						o + "offsets[t + 1] = offsets[t] + cursor[t].load(std::memory_order_relaxed);";
+						o + "cursor[t].store(offsets[t], std::memory_order_relaxed);";
+					};
+					o + "values.resize(offsets[targets]);";
+					o + "concurrency::parallel_for(uint32_t(0), n, [&](uint32_t i)" + block{
+						o + "if(!@rel@_is_valid(@rel@_id(@rel@_id::value_base_t(i)))) return;";
+						for_each_value("values[cursor[v.index()].fetch_add(1, std::memory_order_relaxed)] = @rel@_id(@rel@_id::value_base_t(i));");
+					} +append{ ");" };
+					// the parallel fill leaves each group in an arbitrary order; restore the order a serial build produces
+					o + "concurrency::parallel_for(uint32_t(0), targets, [&](uint32_t t)" + block{
+						o + "std::sort(values.data() + offsets[t], values.data() + offsets[t + 1], [](@rel@_id a, @rel@_id b) { return a.value < b.value; });";
+					} +append{ ");" };
+					o + "return;";
+				};
+				o + "#endif";
+				o + "#endif";
+
+				o + "for(uint32_t i = 0; i < n; ++i)" + block{
+					o + "if(!@rel@_is_valid(@rel@_id(@rel@_id::value_base_t(i)))) continue;";
+					for_each_value("++offsets[v.index() + 1];");
+				};
+				o + "for(uint32_t t = 0; t < targets; ++t) offsets[t + 1] += offsets[t];";
+				o + "values.resize(offsets[targets]);";
+				o + "std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);";
+				o + "for(uint32_t i = 0; i < n; ++i)" + block{
+					o + "if(!@rel@_is_valid(@rel@_id(@rel@_id::value_base_t(i)))) continue;";
+					for_each_value("values[cursor[v.index()]++] = @rel@_id(@rel@_id::value_base_t(i));");
+				};
+			} +append{ ");" };
+		};
+
+		bool is_only_of_type = true;
+		for(auto& ir : cob.indexed_objects) {
+			if(ir.type_name == io.type_name && ir.property_name != io.property_name)
+				is_only_of_type = false;
+		}
+		std::vector<std::string> suffixes{ std::string("_as_") + io.property_name };
+		if(is_only_of_type)
+			suffixes.push_back(std::string());
+
+		for(auto& as_suffix : suffixes) {
+			o + substitute{ "as_suffix", as_suffix };
+			o + "std::pair<@rel@_id const*, @rel@_id const*> @target@_range_of_@rel@@as_suffix@(@target@_id id) const" + block{
+				o + "@rel@_update_@prop@_index();";
+				o + "auto const& offsets = @rel@.@prop@_lazy_offsets;";
+				o + "if(!bool(id) || uint32_t(id.index()) + 1 >= offsets.size())" + block{
+					o + "return std::pair<@rel@_id const*, @rel@_id const*>(nullptr, nullptr);";
+				};
+				o + "auto base = @rel@.@prop@_lazy_values.data();";
+				o + "return std::pair<@rel@_id const*, @rel@_id const*>(base + offsets[id.index()], base + offsets[id.index() + 1]);";
+			};
+			o + "template<typename T>";
+			o + "void @target@_for_each_@rel@@as_suffix@(@target@_id id, T&& func) const" + block{
+				o + "auto vrange = @target@_range_of_@rel@_as_@prop@(id);";
+				o + "std::for_each(vrange.first, vrange.second, func);";
+			};
+		}
+
+		o + line_break{};
+	}
+	return o;
+}
 
-		o + "return new_id;";
-	};
+basic_builder& make_link_stats(basic_builder& o, relationship_object_def const& cob) {
+	for(auto& io : cob.indexed_objects) {
+		if(io.index != index_type::many)
+			continue;
 
-	o + line_break{};
+		o + substitute{ "rel", cob.name } +substitute{ "prop", io.property_name } +substitute{ "target", io.type_name };
+		o + heading{ "container link statistics for @rel@ @prop@" };
+
+		o + "dcon::link_statistics<@target@_id> @rel@_link_stats_@prop@() const" + block{
+			o + "return @rel@_link_stats_@prop@(std::numeric_limits<uint32_t>::max(), [](@target@_id, uint32_t) {});";
+		};
+		o + "template<typename F>";
+		o + "dcon::link_statistics<@target@_id> @rel@_link_stats_@prop@(uint32_t threshold, F&& on_exceeded) const" + block{
+			o + "dcon::link_statistics<@target@_id> result;";
+			o + "const uint32_t n = @target@_size();";
+			o + "for(uint32_t i = 0; i < n; ++i)" + block{
+				o + "auto owner = @target@_id(@target@_id::value_base_t(i));";
+				o + "if(!@target@_is_valid(owner)) continue;";
+				if(io.ltype == list_type::list) {
+					// the only storage without a stored length; counting costs one step per relationship instance
+					o + "uint32_t degree = 0;";
+					o + "for(auto p = @rel@.m_head_back_@prop@.vptr()[i]; bool(p); p = @rel@.m_link_@prop@.vptr()[p.index()].right) ++degree;";
+				} else if(io.ltype == list_type::array || io.ltype == list_type::sorted_array) {
+					o + "auto tag = @rel@.m_array_@prop@.vptr()[i];";
+					o + "uint32_t degree = dcon::get_size(@rel@.@prop@_storage, tag);";
+					o + "if(auto cap = dcon::get_capacity(@rel@.@prop@_storage, tag); cap != 0)" + block{
+						o + "result.storage_bytes += sizeof(dcon::detail::mk_2_header) + uint64_t(cap) * sizeof(@rel@_id);";
+					};
+				} else if(io.ltype == list_type::std_vector) {
+					o + "auto& vref = @rel@.m_array_@prop@.vptr()[i];";
+					o + "uint32_t degree = uint32_t(vref.size());";
+					o + "result.storage_bytes += uint64_t(vref.capacity()) * sizeof(@rel@_id);";
+				} else if(io.ltype == list_type::csr) {
+					o + "auto vrange = @rel@.@prop@_csr.range(i);";
+					o + "uint32_t degree = uint32_t(vrange.second - vrange.first);";
+					o + "result.storage_bytes += uint64_t(degree) * sizeof(@rel@_id);";
+				}
+				o + "result.record(owner, degree);";
+				o + "if(degree > threshold) on_exceeded(owner, degree);";
+			};
+			o + "return result;";
+		};
+
+		o + line_break{};
+	}
 	return o;
 }
 
@@ -2084,20 +3398,24 @@ basic_builder& relation_iterator_foreach_as_implementation(basic_builder& o, rel
 	o + "DCON_RELEASE_INLINE @it_name@::@it_name@(data_container& c,  @obj@_id fr) noexcept : container(c)" + block{
 		if(l.ltype == list_type::list) {
 			o + "list_pos = container.@rel@.m_head_back_@rel_prop@.vptr()[fr.index()];";
-		} else if(l.ltype == list_type::array) {
+		} else if(l.ltype == list_type::array || l.ltype == list_type::sorted_array) {
 			o + "ptr = dcon::get_range(container.@rel@.@rel_prop@_storage, container.@rel@.m_array_@rel_prop@.vptr()[fr.index()]).first;";
 		} else if(l.ltype == list_type::std_vector) {
 			o + "ptr = container.@rel@.m_array_@rel_prop@.vptr()[fr.index()].data();";
+		} else if(l.ltype == list_type::csr) {
+			o + "ptr = container.@rel@.@rel_prop@_csr.range(fr.index()).first;";
 		}
 	};
 
 	if(l.ltype != list_type::list) {
 		o + "DCON_RELEASE_INLINE @it_name@::@it_name@(data_container& c, @obj@_id fr, int) noexcept : container(c)" + block{
-			if(l.ltype == list_type::array) {
+			if(l.ltype == list_type::array || l.ltype == list_type::sorted_array) {
 				o + "ptr = dcon::get_range(container.@rel@.@rel_prop@_storage, container.@rel@.m_array_@rel_prop@.vptr()[fr.index()]).second;";
 			} else if(l.ltype == list_type::std_vector) {
 				o + "auto& vref = container.@rel@.m_array_@rel_prop@.vptr()[fr.index()];";
 				o + "ptr = vref.data() + vref.size();";
+			} else if(l.ltype == list_type::csr) {
+				o + "ptr = container.@rel@.@rel_prop@_csr.range(fr.index()).second;";
 			}
 		};
 	}
@@ -2123,19 +3441,23 @@ basic_builder& relation_iterator_foreach_as_implementation(basic_builder& o, rel
 	o + "DCON_RELEASE_INLINE @it_name@::@it_name@(data_container const& c,  @obj@_id fr) noexcept : container(c)" + block{
 		if(l.ltype == list_type::list) {
 			o + "list_pos = container.@rel@.m_head_back_@rel_prop@.vptr()[fr.index()];";
-		} else if(l.ltype == list_type::array) {
+		} else if(l.ltype == list_type::array || l.ltype == list_type::sorted_array) {
 			o + "ptr = dcon::get_range(container.@rel@.@rel_prop@_storage, container.@rel@.m_array_@rel_prop@.vptr()[fr.index()]).first;";
 		} else if(l.ltype == list_type::std_vector) {
 			o + "ptr = container.@rel@.m_array_@rel_prop@.vptr()[fr.index()].data();";
+		} else if(l.ltype == list_type::csr) {
+			o + "ptr = container.@rel@.@rel_prop@_csr.range(fr.index()).first;";
 		}
 	};
 	if(l.ltype != list_type::list) {
 		o + "DCON_RELEASE_INLINE @it_name@::@it_name@(data_container const& c, @obj@_id fr, int) noexcept : container(c)" + block{
-			if(l.ltype == list_type::array) {
+			if(l.ltype == list_type::array || l.ltype == list_type::sorted_array) {
 				o + "ptr = dcon::get_range(container.@rel@.@rel_prop@_storage, container.@rel@.m_array_@rel_prop@.vptr()[fr.index()]).second;";
 			} else if(l.ltype == list_type::std_vector) {
 				o + "auto& vref = container.@rel@.m_array_@rel_prop@.vptr()[fr.index()];";
 				o + "ptr = vref.data() + vref.size();";
+			} else if(l.ltype == list_type::csr) {
+				o + "ptr = container.@rel@.@rel_prop@_csr.range(fr.index()).second;";
 			}
 		};
 	}
@@ -2311,24 +3633,18 @@ basic_builder& object_iterator_implementation(basic_builder& o, relationship_obj
 	};
 	o + "DCON_RELEASE_INLINE object_iterator_@obj@::object_iterator_@obj@(data_container& c, uint32_t i) noexcept : container(c), index(i)" + block{
 		if(obj.store_type == storage_type::erasable) {
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "++index;";
-			};
+			o + "index = dcon::bit_vector_next_set(container.@obj@.m__live.vptr(), index, container.@obj@.size_used);";
 		}
 	};
 	o + "DCON_RELEASE_INLINE const_object_iterator_@obj@::const_object_iterator_@obj@(data_container const& c, uint32_t i) noexcept : container(c), index(i)" + block{
 		if(obj.store_type == storage_type::erasable) {
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "++index;";
-			};
+			o + "index = dcon::bit_vector_next_set(container.@obj@.m__live.vptr(), index, container.@obj@.size_used);";
 		}
 	};
 	o + "DCON_RELEASE_INLINE object_iterator_@obj@& object_iterator_@obj@::operator++() noexcept" + block{
 		if(obj.store_type == storage_type::erasable) {
 			o + "++index;";
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "++index;";
-			};
+			o + "index = dcon::bit_vector_next_set(container.@obj@.m__live.vptr(), index, container.@obj@.size_used);";
 		} else {
 			o + "++index;";
 		}
@@ -2337,9 +3653,7 @@ basic_builder& object_iterator_implementation(basic_builder& o, relationship_obj
 	o + "DCON_RELEASE_INLINE const_object_iterator_@obj@& const_object_iterator_@obj@::operator++() noexcept" + block{
 		if(obj.store_type == storage_type::erasable) {
 			o + "++index;";
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "++index;";
-			};
+			o + "index = dcon::bit_vector_next_set(container.@obj@.m__live.vptr(), index, container.@obj@.size_used);";
 		} else {
 			o + "++index;";
 		}
@@ -2348,8 +3662,8 @@ basic_builder& object_iterator_implementation(basic_builder& o, relationship_obj
 	o + "DCON_RELEASE_INLINE object_iterator_@obj@& object_iterator_@obj@::operator--() noexcept" + block{
 		if(obj.store_type == storage_type::erasable) {
 			o + "--index;";
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "--index;";
+			o + "if(index < container.@obj@.size_used)" + block{
+				o + "index = dcon::bit_vector_prev_set(container.@obj@.m__live.vptr(), index);";
 			};
 		} else {
 			o + "--index;";
@@ -2359,8 +3673,8 @@ basic_builder& object_iterator_implementation(basic_builder& o, relationship_obj
 	o + "DCON_RELEASE_INLINE const_object_iterator_@obj@& const_object_iterator_@obj@::operator--() noexcept" + block{
 		if(obj.store_type == storage_type::erasable) {
 			o + "--index;";
-			o + "while(container.@obj@.m__index.vptr()[index] != @obj@_id(@obj@_id::value_base_t(index)) && index < container.@pk_obj@.size_used)" + block{
-				o + "--index;";
+			o + "if(index < container.@obj@.size_used)" + block{
+				o + "index = dcon::bit_vector_prev_set(container.@obj@.m__live.vptr(), index);";
 			};
 		} else {
 			o + "--index;";
@@ -2377,15 +3691,58 @@ basic_builder& make_iterate_over_objects(basic_builder& o, relationship_object_d
 
 	o + "template <typename T>";
 	o + "DCON_RELEASE_INLINE void for_each_@obj@(T&& func)" + block{
-		o + "for(uint32_t i = 0; i < @pk_obj@.size_used; ++i)" + block{
-			o + "@obj@_id tmp = @obj@_id(@obj@_id::value_base_t(i));";
+		if(obj.store_type == storage_type::erasable) {
+			// jump directly between live slots instead of testing every index
+			o + "for(uint32_t i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), 0, @obj@.size_used); i < @obj@.size_used; "
+				"i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), i + 1, @obj@.size_used))" + block{
+				o + "func(@obj@_id(@obj@_id::value_base_t(i)));";
+			};
+		} else {
+			o + "for(uint32_t i = 0; i < @pk_obj@.size_used; ++i)" + block{
+				o + "@obj@_id tmp = @obj@_id(@obj@_id::value_base_t(i));";
+				o + "func(tmp);";
+			};
+		}
+	};
+
+	// scalar work on individual ids, handed out in chunks; func may take the thread index as a second parameter
+	o + "#ifndef DCON_NO_VE";
+	o + "#ifndef VE_NO_TBB";
+	o + "template <typename T>";
+	o + "void parallel_for_each_@obj@(T&& func, uint32_t grain = 256, ve::partitioning part = ve::partitioning::dynamic)" + block{
+		o + "ve::execute_parallel_chunks(@pk_obj@.size_used, grain, part, [&](uint32_t first, uint32_t last)" + block{
+			o + "[[maybe_unused]] int32_t const thread = ve::thread_index();";
+			o + "auto call = [&](uint32_t i)" + block{
+				o + "if constexpr(std::is_invocable_v<T&, @obj@_id, int32_t>)";
+				o + "\tfunc(@obj@_id(@obj@_id::value_base_t(i)), thread);";
+				o + "else";
+				o + "\tfunc(@obj@_id(@obj@_id::value_base_t(i)));";
+			} + append{ ";" };
 			if(obj.store_type == storage_type::erasable) {
-				o + "if(@obj@.m__index.vptr()[tmp.index()] == tmp) func(tmp);";
+				o + "for(uint32_t i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), first, last); i < last; "
+					"i = dcon::bit_vector_next_set(@obj@.m__live.vptr(), i + 1, last))" + block{
+					o + "call(i);";
+				};
 			} else {
-				o + "func(tmp);";
+				o + "for(uint32_t i = first; i < last; ++i)" + block{
+					o + "call(i);";
+				};
 			}
-		};
+		} + append{ ");" };
+	};
+	// folds func(id) over all instances with combine, in an order that does not depend on the number of threads
+	o + "template <typename T, typename F, typename C>";
+	o + "T reduce_over_@obj@(T identity, F&& func, C&& combine) const" + block{
+		o + "return ve::reduce_custom<@obj@_id>(@pk_obj@.size_used, identity, [&](@obj@_id id) -> T" + block{
+			if(obj.store_type == storage_type::erasable) {
+				o + "return dcon::bit_vector_test(@obj@.m__live.vptr(), id.index()) ? T(func(id)) : identity;";
+			} else {
+				o + "return T(func(id));";
+			}
+		} + append{ ", combine);" };
 	};
+	o + "#endif";
+	o + "#endif";
 
 	auto const appstr = std::string(" in_") + obj.name + " ;";
 
@@ -2410,6 +3767,490 @@ basic_builder& make_iterate_over_objects(basic_builder& o, relationship_object_d
 	return o;
 }
 
+basic_builder& make_consistent_reads(basic_builder& o, relationship_object_def const& obj) {
+	o + substitute{ "obj", obj.name };
+	o + substitute{ "vector_position", obj.is_expandable ? "ve::unaligned_contiguous_tags" : "ve::contiguous_tags" };
+
+	o + heading{ "consistent reads for @obj@" };
+
+	// every setter brackets its store with these; a reader retries if a write to its stripes was in progress or began while it ran
+	o + "DCON_RELEASE_INLINE void @obj@_begin_write(uint32_t first, uint32_t last) noexcept" + block{
+		o + "@obj@.write_sequence.begin(first, last);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_end_write(uint32_t first, uint32_t last) noexcept" + block{
+		o + "@obj@.write_sequence.end(first, last);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_begin_write(@obj@_id id) noexcept" + block{
+		o + "@obj@_begin_write(uint32_t(id.index()), uint32_t(id.index()) + 1);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_end_write(@obj@_id id) noexcept" + block{
+		o + "@obj@_end_write(uint32_t(id.index()), uint32_t(id.index()) + 1);";
+	};
+	o + "#ifndef DCON_NO_VE";
+	o + "DCON_RELEASE_INLINE void @obj@_begin_write(@vector_position@<@obj@_id> id) noexcept" + block{
+		o + "@obj@_begin_write(id.value, id.value + ve::vector_size);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_end_write(@vector_position@<@obj@_id> id) noexcept" + block{
+		o + "@obj@_end_write(id.value, id.value + ve::vector_size);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_begin_write(ve::partial_contiguous_tags<@obj@_id> id) noexcept" + block{
+		o + "@obj@_begin_write(id.value, id.value + id.subcount);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_end_write(ve::partial_contiguous_tags<@obj@_id> id) noexcept" + block{
+		o + "@obj@_end_write(id.value, id.value + id.subcount);";
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_begin_write(ve::tagged_vector<@obj@_id> id) noexcept" + block{
+		o + "for(int32_t i = 0; i < ve::vector_size; ++i)" + block{
+			o + "if(id[i].index() >= 0)";
+			o + "\t@obj@_begin_write(uint32_t(id[i].index()), uint32_t(id[i].index()) + 1);";
+		};
+	};
+	o + "DCON_RELEASE_INLINE void @obj@_end_write(ve::tagged_vector<@obj@_id> id) noexcept" + block{
+		o + "for(int32_t i = 0; i < ve::vector_size; ++i)" + block{
+			o + "if(id[i].index() >= 0)";
+			o + "\t@obj@_end_write(uint32_t(id[i].index()), uint32_t(id[i].index()) + 1);";
+		};
+	};
+	o + "#endif";
+
+	// groups the stores made by func(id), which may call any number of setters, so that readers see all of them or none
+	o + "template<typename T, typename F>";
+	o + "void @obj@_write_consistent(T id, F&& func)" + block{
+		o + "@obj@_begin_write(id);";
+		o + "func(id);";
+		o + "@obj@_end_write(id);";
+	};
+
+	o + "template<typename F>";
+	o + "auto @obj@_read_consistent_chunks(uint32_t first_chunk, uint32_t last_chunk, F&& func) const -> decltype(func())" + block{
+		o + "return @obj@.write_sequence.read(first_chunk, last_chunk, std::forward<F>(func));";
+	};
+
+	o + "template<typename F>";
+	o + "auto @obj@_read_consistent(@obj@_id id, F&& func) const -> decltype(func(id))" + block{
+		o + "return @obj@_read_consistent_chunks(uint32_t(id.index()) >> 6, uint32_t(id.index()) >> 6, [&]() { return func(id); });";
+	};
+	o + "#ifndef DCON_NO_VE";
+	o + "template<typename F>";
+	o + "auto @obj@_read_consistent(@vector_position@<@obj@_id> id, F&& func) const -> decltype(func(id))" + block{
+		o + "return @obj@_read_consistent_chunks(id.value >> 6, (id.value + ve::vector_size - 1) >> 6, [&]() { return func(id); });";
+	};
+	o + "template<typename F>";
+	o + "auto @obj@_read_consistent(ve::partial_contiguous_tags<@obj@_id> id, F&& func) const -> decltype(func(id))" + block{
+		o + "return @obj@_read_consistent_chunks(id.value >> 6, (id.value + id.subcount - 1) >> 6, [&]() { return func(id); });";
+	};
+	o + "#endif";
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_versioned_columns(basic_builder& o, relationship_object_def const& obj) {
+	o + substitute{ "obj", obj.name };
+
+	o + heading{ "snapshot versions for @obj@" };
+
+	// called by the setters with the instances they are about to store to
+	o + "template<typename T>";
+	o + "DCON_RELEASE_INLINE void @obj@_save_versions(dcon::versioned_column<T>& column, T const* live, @obj@_id id)" + block{
+		o + "column.save(live, uint32_t(id.index()), uint32_t(id.index()) + 1, snapshot_epochs);";
+	};
+	o + "#ifndef DCON_NO_VE";
+	o + "template<typename T>";
+	o + "DCON_RELEASE_INLINE void @obj@_save_versions(dcon::versioned_column<T>& column, T const* live, ve::contiguous_tags<@obj@_id> id)" + block{
+		o + "column.save(live, id.value, id.value + ve::vector_size, snapshot_epochs);";
+	};
+	o + "template<typename T>";
+	o + "DCON_RELEASE_INLINE void @obj@_save_versions(dcon::versioned_column<T>& column, T const* live, ve::partial_contiguous_tags<@obj@_id> id)" + block{
+		o + "column.save(live, id.value, id.value + id.subcount, snapshot_epochs);";
+	};
+	o + "template<typename T>";
+	o + "DCON_RELEASE_INLINE void @obj@_save_versions(dcon::versioned_column<T>& column, T const* live, ve::tagged_vector<@obj@_id> id)" + block{
+		o + "for(int32_t i = 0; i < ve::vector_size; ++i)" + block{
+			o + "if(id[i].index() >= 0)";
+			o + "\tcolumn.save(live, uint32_t(id[i].index()), uint32_t(id[i].index()) + 1, snapshot_epochs);";
+		};
+	};
+	o + "#endif";
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_snapshot(basic_builder& o, file_def const& parsed_file) {
+	o + heading{ "snapshot" };
+
+	// a pinned epoch, through which the versioned properties are read as they were when it was pinned
+	o + "class snapshot" + class_block{
+		o + "data_container const* container = nullptr;";
+		o + "uint64_t epoch = 0;";
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(cob.versioned) {
+				o + substitute{ "obj", cob.name };
+				o + "uint32_t @obj@_size_at_pin = 0;";
+			}
+		}
+		o + "friend class data_container;";
+		o + "public:";
+		o + "snapshot() noexcept = default;";
+		o + "snapshot(snapshot const&) = delete;";
+		o + "snapshot& operator=(snapshot const&) = delete;";
+		o + "snapshot(snapshot&& other) noexcept" + block{
+			o + "*this = std::move(other);";
+		};
+		o + "snapshot& operator=(snapshot&& other) noexcept" + block{
+			o + "if(this != &other)" + block{
+				o + "release();";
+				o + "container = other.container;";
+				o + "epoch = other.epoch;";
+				for(auto& cob : parsed_file.relationship_objects) {
+					if(cob.versioned) {
+						o + substitute{ "obj", cob.name };
+						o + "@obj@_size_at_pin = other.@obj@_size_at_pin;";
+					}
+				}
+				o + "other.container = nullptr;";
+			};
+			o + "return *this;";
+		};
+		o + "~snapshot()" + block{
+			o + "release();";
+		};
+		o + "void release() noexcept" + block{
+			o + "if(container)" + block{
+				o + "container->snapshot_epochs.release(epoch);";
+				o + "container = nullptr;";
+			};
+		};
+		o + "bool is_pinned() const noexcept" + block{
+			o + "return container != nullptr;";
+		};
+		o + "uint64_t pinned_epoch() const noexcept" + block{
+			o + "return epoch;";
+		};
+
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(!cob.versioned)
+				continue;
+			o + substitute{ "obj", cob.name };
+			o + "uint32_t @obj@_size() const noexcept" + block{
+				o + "return @obj@_size_at_pin;";
+			};
+			for(auto& cp : cob.properties) {
+				if(!is_versioned_property(cob, cp))
+					continue;
+				o + substitute{ "prop", cp.name };
+				if(cp.type == property_type::bitfield) {
+					o + substitute{ "chunk", "dcon::versioned_column<dcon::bitfield_type>::chunk_size" };
+					o + "bool @obj@_get_@prop@(@obj@_id id) const noexcept" + block{
+						o + "auto const i = uint32_t(id.index());";
+						o + "return container->@obj@.m_@prop@_versions.read(container->@obj@.m_@prop@.vptr(), i / @chunk@, epoch, [&](dcon::bitfield_type const* bits) { return dcon::bit_vector_test(bits, int32_t(i % @chunk@)); });";
+					};
+				} else {
+					o + substitute{ "base_type", normalize_type(cp.data_type) };
+					o + substitute{ "chunk", "dcon::versioned_column<" + normalize_type(cp.data_type) + ">::chunk_size" };
+					o + "@base_type@ @obj@_get_@prop@(@obj@_id id) const noexcept" + block{
+						o + "auto const i = uint32_t(id.index());";
+						o + "return container->@obj@.m_@prop@_versions.read(container->@obj@.m_@prop@.vptr(), i / @chunk@, epoch, [&](@base_type@ const* values) { return values[i % @chunk@]; });";
+					};
+					// a vector never straddles two chunks
+					o + "#ifndef DCON_NO_VE";
+					o + "ve::value_to_vector_type<@base_type@> @obj@_get_@prop@(ve::contiguous_tags<@obj@_id> id) const noexcept" + block{
+						o + "return container->@obj@.m_@prop@_versions.read(container->@obj@.m_@prop@.vptr(), id.value / @chunk@, epoch, [&](@base_type@ const* values) { return ve::load(ve::contiguous_tags<@obj@_id>(id.value % @chunk@), values); });";
+					};
+					o + "ve::value_to_vector_type<@base_type@> @obj@_get_@prop@(ve::partial_contiguous_tags<@obj@_id> id) const noexcept" + block{
+						o + "return container->@obj@.m_@prop@_versions.read(container->@obj@.m_@prop@.vptr(), id.value / @chunk@, epoch, [&](@base_type@ const* values) { return ve::load(ve::partial_contiguous_tags<@obj@_id>(id.value % @chunk@, id.subcount), values); });";
+					};
+					o + "#endif";
+				}
+			}
+		}
+	};
+
+	o + "inline snapshot data_container::pin_snapshot() const" + block{
+		o + "snapshot result;";
+		o + "result.epoch = snapshot_epochs.pin();";
+		o + "result.container = this;";
+		for(auto& cob : parsed_file.relationship_objects) {
+			if(cob.versioned) {
+				o + substitute{ "obj", cob.name };
+				o + "result.@obj@_size_at_pin = @obj@_size();";
+			}
+		}
+		o + "return result;";
+	};
+	o + line_break{};
+	return o;
+}
+
+void make_traversal_step(basic_builder& o, traversal_def const& tv, size_t step, std::string const& source) {
+	auto& s = tv.steps[step];
+	auto const d = std::to_string(step);
+	o + substitute{ "rel", s.relation_name } +substitute{ "from", s.from_link } +substitute{ "to", s.to_link }
+		+substitute{ "from_obj", s.from->type_name } +substitute{ "src", source } +substitute{ "r", "r" + d } +substitute{ "n", "n" + d }
+		+substitute{ "k", "k" + d } +substitute{ "count", std::to_string(s.to->multiplicity) };
+
+	auto body = [&](basic_builder& o) {
+		auto emit_target = [&](basic_builder& o) {
+			if(step + 1 == tv.steps.size()) {
+				o + "func(@n@);";
+			} else {
+				make_traversal_step(o, tv, step + 1, "n" + d);
+			}
+		};
+		if(s.to->multiplicity == 1) {
+			o + "auto @n@ = @rel@_get_@to@(@r@);";
+			if(s.from == s.to)
+				o + "if(bool(@n@) && @n@ != @src@)" + block{ emit_target(o); };
+			else
+				o + "if(bool(@n@))" + block{ emit_target(o); };
+		} else {
+			o + "for(int32_t @k@ = 0; @k@ < @count@; ++@k@)" + block{
+				o + "auto @n@ = @rel@_get_@to@(@r@, @k@);";
+				if(s.from == s.to)
+					o + "if(!bool(@n@) || @n@ == @src@) continue;";
+				else
+					o + "if(!bool(@n@)) continue;";
+				emit_target(o);
+			};
+		}
+	};
+
+	if(s.from->index == index_type::many) {
+		o + "@from_obj@_for_each_@rel@_as_@from@(@src@, [&](@rel@_id @r@)" + block{
+			body(o);
+		} +append{ ");" };
+	} else {
+		o + "if(auto @r@ = @from_obj@_get_@rel@_as_@from@(@src@); bool(@r@))" + block{
+			body(o);
+		};
+	}
+}
+
+basic_builder& make_traversal(basic_builder& o, traversal_def const& tv) {
+	o + substitute{ "name", tv.name } +substitute{ "obj", tv.start_object->name };
+	o + heading{ "traversal @name@" };
+
+	o + "template<typename F>";
+	o + "void for_each_@name@_neighbor(@obj@_id id, F&& func) const" + block{
+		make_traversal_step(o, tv, 0, "id");
+	};
+
+	o + "template<typename F>";
+	o + "void bfs_@name@(@obj@_id start, int32_t max_depth, F&& func) const" + block{
+		o + "if(!bool(start)) return;";
+		o + "auto const count = @obj@_size();";
+		o + "std::vector<dcon::bitfield_type> visited((count + 7) / 8);";
+		o + "std::vector<@obj@_id> frontier;";
+		o + "std::vector<@obj@_id> next_frontier;";
+		o + "frontier.reserve(count);";
+		o + "next_frontier.reserve(count);";
+		o + "dcon::bit_vector_set(visited.data(), start.index(), true);";
+		o + "frontier.push_back(start);";
+		o + "func(start, int32_t(0));";
+		o + "for(int32_t depth = 1; depth <= max_depth && !frontier.empty(); ++depth)" + block{
+			o + "next_frontier.clear();";
+			o + "for(auto n : frontier)" + block{
+				o + "for_each_@name@_neighbor(n, [&](@obj@_id m)" + block{
+					o + "if(!dcon::bit_vector_test(visited.data(), m.index()))" + block{
+						o + "dcon::bit_vector_set(visited.data(), m.index(), true);";
+						o + "next_frontier.push_back(m);";
+						o + "func(m, depth);";
+					};
+				} +append{ ");" };
+			};
+			o + "std::swap(frontier, next_frontier);";
+		};
+	};
+
+	o + "std::vector<@obj@_id> k_hop_@name@(@obj@_id start, int32_t k) const" + block{
+		o + "std::vector<@obj@_id> result;";
+		o + "bfs_@name@(start, k, [&](@obj@_id n, int32_t depth) { if(depth != 0) result.push_back(n); });";
+		o + "return result;";
+	};
+
+	// reverse Cuthill-McKee: breadth first from a lowest degree instance, visiting neighbors in order of increasing degree
+	o + "std::vector<@obj@_id> rcm_order_@name@() const" + block{
+		o + "auto const count = @obj@_size();";
+		o + "std::vector<uint32_t> degree(count);";
+		o + "std::vector<@obj@_id> roots;";
+		o + "roots.reserve(count);";
+		o + "for(uint32_t i = 0; i < count; ++i)" + block{
+			o + "auto id = @obj@_id(@obj@_id::value_base_t(i));";
+			o + "if(!@obj@_is_valid(id)) continue;";
+			o + "for_each_@name@_neighbor(id, [&](@obj@_id) { ++degree[i]; });";
+			o + "roots.push_back(id);";
+		};
+		o + "auto by_degree = [&](@obj@_id a, @obj@_id b) { return degree[a.index()] < degree[b.index()]; };";
+		o + "std::stable_sort(roots.begin(), roots.end(), by_degree);";
+		o + "std::vector<dcon::bitfield_type> visited((count + 7) / 8);";
+		o + "std::vector<@obj@_id> result;";
+		o + "result.reserve(roots.size());";
+		o + "for(auto root : roots)" + block{
+			o + "if(dcon::bit_vector_test(visited.data(), root.index())) continue;";
+			o + "dcon::bit_vector_set(visited.data(), root.index(), true);";
+			o + "result.push_back(root);";
+			o + "for(size_t head = result.size() - 1; head < result.size(); ++head)" + block{
+				o + "auto const first_new = result.size();";
+				o + "for_each_@name@_neighbor(result[head], [&](@obj@_id m)" + block{
+					o + "if(!dcon::bit_vector_test(visited.data(), m.index()))" + block{
+						o + "dcon::bit_vector_set(visited.data(), m.index(), true);";
+						o + "result.push_back(m);";
+					};
+				} +append{ ");" };
+				o + "std::stable_sort(result.begin() + first_new, result.end(), by_degree);";
+			};
+		};
+		o + "std::reverse(result.begin(), result.end());";
+		o + "return result;";
+	};
+
+	o + "#ifndef DCON_NO_VE";
+	o + "#ifndef VE_NO_TBB";
+	o + "template<typename F>";
+	o + "void bfs_@name@_parallel(@obj@_id start, int32_t max_depth, F&& func) const" + block{
+		o + "if(!bool(start)) return;";
+		o + "auto const count = @obj@_size();";
+		o + "std::unique_ptr<std::atomic<uint8_t>[]> visited(new std::atomic<uint8_t>[(count + 7) / 8]());";
+		// every instance enters a frontier at most once, so neither array can overflow
+		o + "std::vector<@obj@_id> frontier(count);";
+		o + "std::vector<@obj@_id> next_frontier(count);";
+		o + "std::atomic<uint32_t> next_size = 0;";
+		o + "uint32_t frontier_size = 1;";
+		o + "visited[start.index() >> 3].fetch_or(uint8_t(1 << (start.index() & 7)), std::memory_order_relaxed);";
+		o + "frontier[0] = start;";
+		o + "func(start, int32_t(0));";
+		o + "for(int32_t depth = 1; depth <= max_depth && frontier_size != 0; ++depth)" + block{
+			o + "next_size.store(0, std::memory_order_relaxed);";
+			o + "concurrency::parallel_for(uint32_t(0), frontier_size, [&](uint32_t i)" + block{
+				o + "for_each_@name@_neighbor(frontier[i], [&](@obj@_id m)" + block{
+					o + "auto const bit = uint8_t(1 << (m.index() & 7));";
+					o + "if((visited[m.index() >> 3].fetch_or(bit, std::memory_order_relaxed) & bit) == 0)" + block{
+						o + "next_frontier[next_size.fetch_add(1, std::memory_order_relaxed)] = m;";
+						o + "func(m, depth);";
+					};
+				} +append{ ");" };
+			} +append{ ");" };
+			o + "frontier_size = next_size.load(std::memory_order_relaxed);";
+			o + "std::swap(frontier, next_frontier);";
+		};
+	};
+	o + "std::vector<@obj@_id> k_hop_@name@_parallel(@obj@_id start, int32_t k) const" + block{
+		o + "std::vector<@obj@_id> result(@obj@_size());";
+		o + "std::atomic<uint32_t> result_size = 0;";
+		o + "bfs_@name@_parallel(start, k, [&](@obj@_id n, int32_t depth) { if(depth != 0) result[result_size.fetch_add(1, std::memory_order_relaxed)] = n; });";
+		o + "result.resize(result_size.load(std::memory_order_relaxed));";
+		o + "return result;";
+	};
+	o + "#endif";
+	o + "#endif";
+	o + line_break{};
+	return o;
+}
+
+basic_builder& make_systems(basic_builder& o, file_def const& parsed_file) {
+	auto const& systems = parsed_file.systems;
+	o + substitute{ "count", std::to_string(systems.size()) };
+	o + heading{ "systems" };
+
+	// the bodies of the systems are supplied by the user, as with the hooks
+	for(auto& sys : systems) {
+		std::string after_list;
+		for(auto j : sys.after)
+			after_list += (after_list.length() == 0 ? "" : ", ") + systems[j].name;
+		o + substitute{ "name", sys.name } + substitute{ "after", after_list.length() == 0 ? std::string("nothing") : after_list };
+		o + "void system_@name@(); // runs after: @after@";
+	}
+
+	std::string names_list;
+	std::string levels_list;
+	for(auto& sys : systems) {
+		names_list += (names_list.length() == 0 ? "\"" : ", \"") + sys.name + "\"";
+		levels_list += (levels_list.length() == 0 ? "" : ", ") + std::to_string(sys.level);
+	}
+	o + substitute{ "names", names_list } + substitute{ "levels", levels_list };
+	o + "static constexpr uint32_t system_count = @count@;";
+	o + "static constexpr std::array<char const*, @count@> system_names = { @names@ };";
+	o + "static constexpr std::array<uint32_t, @count@> system_levels = { @levels@ };";
+
+	o + "void run_system(uint32_t index)" + block{
+		o + "switch(index)" + block{
+			for(uint32_t i = 0; i < systems.size(); ++i) {
+				o + substitute{ "index", std::to_string(i) } + substitute{ "name", systems[i].name };
+				o + "case @index@: system_@name@(); break;";
+			}
+			o + "default: break;";
+		};
+	};
+
+	o + "void run_systems_serial()" + block{
+		for(auto& sys : systems) {
+			o + substitute{ "name", sys.name };
+			o + "system_@name@();";
+		}
+	};
+
+	// each system waits only on the earlier systems it conflicts with: it is started by whichever of them finishes last
+	std::string predecessor_counts;
+	std::string successor_start = "0";
+	std::string successors;
+	std::string roots;
+	uint32_t edge_count = 0;
+	uint32_t root_count = 0;
+	for(uint32_t i = 0; i < systems.size(); ++i) {
+		predecessor_counts += (predecessor_counts.length() == 0 ? "" : ", ") + std::to_string(systems[i].after.size());
+		if(systems[i].after.size() == 0) {
+			roots += (roots.length() == 0 ? "" : ", ") + std::to_string(i);
+			++root_count;
+		}
+		for(uint32_t j = i + 1; j < systems.size(); ++j) {
+			if(std::find(systems[j].after.begin(), systems[j].after.end(), i) != systems[j].after.end()) {
+				successors += (successors.length() == 0 ? "" : ", ") + std::to_string(j);
+				++edge_count;
+			}
+		}
+		successor_start += ", " + std::to_string(edge_count);
+	}
+	o + substitute{ "predecessor_counts", predecessor_counts } + substitute{ "successor_start", successor_start }
+		+ substitute{ "successors", successors } + substitute{ "edge_count", std::to_string(edge_count) }
+		+ substitute{ "roots", roots } + substitute{ "root_count", std::to_string(root_count) };
+	o + "static constexpr std::array<uint32_t, @count@> system_predecessor_counts = { @predecessor_counts@ };";
+	o + "static constexpr std::array<uint32_t, @count@ + 1> system_successor_start = { @successor_start@ };";
+	o + "static constexpr std::array<uint32_t, @edge_count@> system_successors = { @successors@ };";
+	o + "static constexpr std::array<uint32_t, @root_count@> system_roots = { @roots@ };";
+
+	o + "#if !defined(DCON_NO_VE) && !defined(VE_NO_TBB)";
+	o + "void run_systems_from(uint32_t const* ready, uint32_t ready_count, std::atomic<uint32_t>* waiting)" + block{
+		o + "auto run_one = [&](uint32_t s)" + block{
+			o + "run_system(s);";
+			o + "std::array<uint32_t, @count@> next;";
+			o + "uint32_t next_count = 0;";
+			o + "for(uint32_t k = system_successor_start[s]; k < system_successor_start[s + 1]; ++k)" + block{
+				o + "if(waiting[system_successors[k]].fetch_sub(1, std::memory_order_acq_rel) == 1)";
+				o + "\tnext[next_count++] = system_successors[k];";
+			};
+			o + "if(next_count != 0)";
+			o + "\trun_systems_from(next.data(), next_count, waiting);";
+		} + append{ ";" };
+		o + "if(ready_count == 1)";
+		o + "\trun_one(ready[0]);";
+		o + "else";
+		o + "\tconcurrency::parallel_for(uint32_t(0), ready_count, [&](uint32_t i) { run_one(ready[i]); });";
+	};
+	o + "#endif";
+
+	o + "void run_systems()" + block{
+		o + "#if !defined(DCON_NO_VE) && !defined(VE_NO_TBB)";
+		o + "std::array<std::atomic<uint32_t>, @count@> waiting;";
+		o + "for(uint32_t i = 0; i < @count@; ++i)";
+		o + "\twaiting[i].store(system_predecessor_counts[i], std::memory_order_relaxed);";
+		o + "run_systems_from(system_roots.data(), uint32_t(@root_count@), waiting.data());";
+		o + "#else";
+		o + "run_systems_serial();";
+		o + "#endif";
+	};
+	o + line_break{};
+	return o;
+}
+
 std::optional<std::string> to_fat_index_type(file_def const& parsed_file, std::string const& original_name, bool is_const) {
 	for(auto& o : parsed_file.relationship_objects) {
 		if(o.name + "_id" == original_name) {
@@ -2728,3 +4569,326 @@ basic_builder& make_composite_key_getter(basic_builder& o, std::string const& ob
 	};
 	return o;
 }
+
+namespace {
+enum class command_kind { create, erase, set_property, try_create, force_create, set_link };
+struct command_def {
+	command_kind kind;
+	relationship_object_def const* obj = nullptr;
+	property_def const* prop = nullptr;
+	related_object const* link = nullptr;
+};
+
+bool is_deletable(relationship_object_def const& cob) {
+	return !(cob.is_relationship && cob.primary_key.points_to)
+		&& (cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable);
+}
+bool is_plain_object(file_def const& parsed_file, std::string const& type_name) {
+	for(auto& cob : parsed_file.relationship_objects) {
+		if(cob.name == type_name)
+			return !cob.is_relationship;
+	}
+	return false;
+}
+}
+
+basic_builder& make_command_buffer(basic_builder& o, file_def const& parsed_file) {
+	// the opcode of each command is its position in this list
+	std::vector<command_def> commands;
+	for(auto& cob : parsed_file.relationship_objects) {
+		if(!cob.is_relationship)
+			commands.push_back(command_def{ command_kind::create, &cob });
+		if(is_deletable(cob))
+			commands.push_back(command_def{ command_kind::erase, &cob });
+		for(auto& cp : cob.properties) {
+			if(!cp.is_derived && cp.protection == protection_type::none
+				&& (cp.type == property_type::vectorizable || cp.type == property_type::bitfield)) {
+				commands.push_back(command_def{ command_kind::set_property, &cob, &cp });
+			}
+		}
+		if(cob.is_relationship) {
+			commands.push_back(command_def{ command_kind::try_create, &cob });
+			commands.push_back(command_def{ command_kind::force_create, &cob });
+			for(auto& io : cob.indexed_objects) {
+				if(cob.primary_key != io && io.multiplicity == 1 && io.protection == protection_type::none)
+					commands.push_back(command_def{ command_kind::set_link, &cob, nullptr, &io });
+			}
+		}
+	}
+
+	auto id_param = [&](std::string const& type_name) {
+		return is_plain_object(parsed_file, type_name) ? "dcon::deferred_id<" + type_name + "_id>" : type_name + "_id";
+	};
+	auto resolve = [&](std::string const& type_name, std::string const& value) {
+		return is_plain_object(parsed_file, type_name) ? "resolve_" + type_name + "(r, " + value + ")" : value;
+	};
+	auto link_params = [&](relationship_object_def const& cob) {
+		std::vector<std::pair<std::string, std::string>> result;
+		for(auto& io : cob.indexed_objects) {
+			if(io.multiplicity == 1) {
+				result.emplace_back(io.type_name, io.property_name + "_p");
+			} else {
+				for(int32_t i = 0; i < io.multiplicity; ++i)
+					result.emplace_back(io.type_name, io.property_name + "_p" + std::to_string(i));
+			}
+		}
+		return result;
+	};
+
+	o + heading{ "command buffer" };
+
+	// commands recorded by each thread, played back into a data_container later from a single thread
+	o + "class command_buffer" + class_block{
+		o + "public:";
+		o + "class alignas(64) recorder" + class_block{
+			o + "friend class command_buffer;";
+			o + "dcon::command_arena commands;";
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(!cob.is_relationship) {
+					o + substitute{ "obj", cob.name };
+					o + "uint32_t @obj@_created = 0;";
+				}
+			}
+			o + "public:";
+			for(size_t op = 0; op < commands.size(); ++op) {
+				auto& c = commands[op];
+				o + substitute{ "op", std::to_string(op) } + substitute{ "obj", c.obj->name } + substitute{ "obj_param", id_param(c.obj->name) };
+				switch(c.kind) {
+					case command_kind::create:
+						o + "dcon::deferred_id<@obj@_id> create_@obj@()" + block{
+							o + "commands.write(uint16_t(@op@));";
+							o + "return dcon::deferred_id<@obj@_id>::make_placeholder(@obj@_created++);";
+						};
+						break;
+					case command_kind::erase:
+						o + "void delete_@obj@(@obj_param@ id)" + block{
+							o + "commands.write(uint16_t(@op@));";
+							o + "commands.write(id);";
+						};
+						break;
+					case command_kind::set_property:
+						o + substitute{ "prop", c.prop->name }
+							+ substitute{ "type", c.prop->type == property_type::bitfield ? std::string("bool") : normalize_type(c.prop->data_type) };
+						o + "void @obj@_set_@prop@(@obj_param@ id, @type@ value)" + block{
+							o + "commands.write(uint16_t(@op@));";
+							o + "commands.write(id);";
+							o + "commands.write(value);";
+						};
+						break;
+					case command_kind::try_create:
+					case command_kind::force_create:
+					{
+						std::string params;
+						for(auto& p : link_params(*c.obj)) {
+							if(params.length() > 0)
+								params += ", ";
+							params += id_param(p.first) + " " + p.second;
+						}
+						o + substitute{ "params", params } + substitute{ "fn", c.kind == command_kind::try_create ? "try_create_" : "force_create_" };
+						o + "void @fn@@obj@(@params@)" + block{
+							o + "commands.write(uint16_t(@op@));";
+							for(auto& p : link_params(*c.obj)) {
+								o + substitute{ "p", p.second };
+								o + "commands.write(@p@);";
+							}
+						};
+						break;
+					}
+					case command_kind::set_link:
+						o + substitute{ "prop", c.link->property_name } + substitute{ "type", id_param(c.link->type_name) };
+						o + "void @obj@_set_@prop@(@obj_param@ id, @type@ value)" + block{
+							o + "commands.write(uint16_t(@op@));";
+							o + "commands.write(id);";
+							o + "commands.write(value);";
+						};
+						break;
+				}
+			}
+		};
+		o + "private:";
+		o + "std::vector<recorder> recorders;";
+		o + "public:";
+		o + "explicit command_buffer(uint32_t thread_count) : recorders(thread_count) { }";
+		o + "recorder& for_thread(uint32_t thread_index) noexcept" + block{
+			o + "return recorders[thread_index];";
+		};
+		o + "void clear() noexcept" + block{
+			o + "for(auto& rec : recorders)" + block{
+				o + "rec.commands.clear();";
+				for(auto& cob : parsed_file.relationship_objects) {
+					if(!cob.is_relationship) {
+						o + substitute{ "obj", cob.name };
+						o + "rec.@obj@_created = 0;";
+					}
+				}
+			};
+		};
+
+		// every creation is done up front, in batches, in order of thread index; the remaining commands are then
+		// applied in order of thread index and sequence, except for deletions, which are batched at the end so that
+		// the instances they move cannot invalidate the handles used by later commands
+		o + "void playback(data_container& dc)" + block{
+			// objects that some command takes a deferred handle to, and relationships that some command takes a handle to
+			std::set<std::string> deferred_types;
+			std::set<std::string> addressed_relationships;
+			for(auto& c : commands) {
+				if(c.kind == command_kind::erase || c.kind == command_kind::set_property || c.kind == command_kind::set_link) {
+					if(is_plain_object(parsed_file, c.obj->name))
+						deferred_types.insert(c.obj->name);
+					else if(tracks_relocations(*c.obj))
+						addressed_relationships.insert(c.obj->name);
+				}
+				if(c.kind == command_kind::try_create || c.kind == command_kind::force_create) {
+					for(auto& p : link_params(*c.obj)) {
+						if(is_plain_object(parsed_file, p.first))
+							deferred_types.insert(p.first);
+					}
+				}
+				if(c.kind == command_kind::set_link && is_plain_object(parsed_file, c.link->type_name))
+					deferred_types.insert(c.link->type_name);
+			}
+
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(cob.is_relationship)
+					continue;
+				o + substitute{ "obj", cob.name };
+				o + "std::vector<uint32_t> @obj@_offsets(recorders.size());";
+				o + "uint32_t @obj@_total = 0;";
+				o + "for(size_t r = 0; r < recorders.size(); ++r)" + block{
+					o + "@obj@_offsets[r] = @obj@_total;";
+					o + "@obj@_total += recorders[r].@obj@_created;";
+				};
+				bool const resolved = deferred_types.count(cob.name) != 0;
+				if(cob.store_type == storage_type::erasable) {
+					o + "std::vector<@obj@_id> @obj@_ids(@obj@_total);";
+					o + "if(@obj@_total != 0) dc.create_@obj@_batch(@obj@_ids.data(), @obj@_total);";
+					if(resolved) {
+						o + "auto resolve_@obj@ = [&](size_t r, dcon::deferred_id<@obj@_id> d)" + block{
+							o + "return d.placeholder == 0 ? d.id : @obj@_ids[@obj@_offsets[r] + d.placeholder - 1];";
+						} + append{ ";" };
+					}
+				} else if(resolved) {
+					o + "@obj@_id @obj@_first = @obj@_total != 0 ? dc.create_@obj@_batch(@obj@_total) : @obj@_id();";
+					o + "auto resolve_@obj@ = [&](size_t r, dcon::deferred_id<@obj@_id> d)" + block{
+						o + "return d.placeholder == 0 ? d.id : @obj@_id(@obj@_id::value_base_t(@obj@_first.index() + @obj@_offsets[r] + d.placeholder - 1));";
+					} + append{ ";" };
+				} else {
+					o + "if(@obj@_total != 0) dc.create_@obj@_batch(@obj@_total);";
+				}
+			}
+			// creating relationships may delete others, and so change what the handles recorded for them refer to
+			for(auto& name : addressed_relationships) {
+				o + substitute{ "obj", name };
+				o + "dcon::relocation_tracker @obj@_moves(dc.@obj@_relocations, dc.@obj@_size());";
+				o + "auto relocate_@obj@ = [&](@obj@_id id)" + block{
+					o + "auto const index = @obj@_moves.current(id.index());";
+					o + "return index >= 0 ? @obj@_id(@obj@_id::value_base_t(index)) : @obj@_id();";
+				} + append{ ";" };
+			}
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(is_deletable(cob)) {
+					o + substitute{ "obj", cob.name };
+					o + "std::vector<@obj@_id> @obj@_deletes;";
+				}
+			}
+
+			o + "for(size_t r = 0; r < recorders.size(); ++r)" + block{
+				o + "auto const& commands = recorders[r].commands;";
+				o + "size_t pos = 0;";
+				o + "while(pos < commands.size())" + block{
+					o + "switch(commands.read<uint16_t>(pos))" + block{
+						for(size_t op = 0; op < commands.size(); ++op) {
+							auto& c = commands[op];
+							// recorded relationship handles are followed through any deletions and moves made during playback
+							bool const relocated = addressed_relationships.count(c.obj->name) != 0;
+							std::string const read_id = "commands.read<" + id_param(c.obj->name) + ">(pos)";
+							o + substitute{ "op", std::to_string(op) } + substitute{ "obj", c.obj->name } + substitute{ "obj_param", id_param(c.obj->name) }
+								+ substitute{ "id", relocated ? "relocate_" + c.obj->name + "(" + read_id + ")" : resolve(c.obj->name, read_id) };
+							switch(c.kind) {
+								case command_kind::create:
+									o + "case @op@:";
+									o + "\tbreak;";
+									break;
+								case command_kind::erase:
+									// relationship handles are only followed once the batch is about to be deleted
+									if(relocated)
+										o + substitute{ "id", read_id };
+									o + "case @op@:";
+									o + "\t@obj@_deletes.push_back(@id@);";
+									o + "\tbreak;";
+									break;
+								case command_kind::set_property:
+									o + substitute{ "prop", c.prop->name }
+										+ substitute{ "type", c.prop->type == property_type::bitfield ? std::string("bool") : normalize_type(c.prop->data_type) };
+									o + "case @op@:" + block{
+										o + "auto id = @id@;";
+										if(relocated) {
+											o + "auto value = commands.read<@type@>(pos);";
+											o + "if(bool(id)) dc.@obj@_set_@prop@(id, value);";
+										} else {
+											o + "dc.@obj@_set_@prop@(id, commands.read<@type@>(pos));";
+										}
+									} + append{ "break;" };
+									break;
+								case command_kind::try_create:
+								case command_kind::force_create:
+								{
+									std::string args;
+									o + substitute{ "fn", c.kind == command_kind::try_create ? "try_create_" : "force_create_" };
+									o + "case @op@:" + block{
+										for(auto& p : link_params(*c.obj)) {
+											o + substitute{ "p", p.second } + substitute{ "p_value", resolve(p.first, "commands.read<" + id_param(p.first) + ">(pos)") };
+											o + "auto @p@ = @p_value@;";
+											if(args.length() > 0)
+												args += ", ";
+											args += p.second;
+										}
+										o + substitute{ "args", args };
+										o + "dc.@fn@@obj@(@args@);";
+									} + append{ "break;" };
+									break;
+								}
+								case command_kind::set_link:
+									o + substitute{ "prop", c.link->property_name }
+										+ substitute{ "value", resolve(c.link->type_name, "commands.read<" + id_param(c.link->type_name) + ">(pos)") };
+									o + "case @op@:" + block{
+										o + "auto id = @id@;";
+										o + "auto value = @value@;";
+										if(relocated)
+											o + "if(bool(id)) dc.@obj@_set_@prop@(id, value);";
+										else
+											o + "dc.@obj@_set_@prop@(id, value);";
+									} + append{ "break;" };
+									break;
+							}
+						}
+					};
+				};
+			};
+
+			// relationships first, since deleting an object may delete or move relationships
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(cob.is_relationship && is_deletable(cob)) {
+					o + substitute{ "obj", cob.name };
+					if(addressed_relationships.count(cob.name) != 0) {
+						o + "for(auto& id : @obj@_deletes)" + block{
+							o + "id = relocate_@obj@(id);";
+						};
+						o + "@obj@_deletes.erase(std::remove_if(@obj@_deletes.begin(), @obj@_deletes.end(), [](@obj@_id id) { return !bool(id); }), @obj@_deletes.end());";
+					}
+					o + "dc.delete_@obj@_batch(@obj@_deletes.data(), uint32_t(@obj@_deletes.size()));";
+				}
+			}
+			for(auto& cob : parsed_file.relationship_objects) {
+				if(!cob.is_relationship && is_deletable(cob)) {
+					o + substitute{ "obj", cob.name };
+					o + "dc.delete_@obj@_batch(@obj@_deletes.data(), uint32_t(@obj@_deletes.size()));";
+				}
+			}
+			o + "clear();";
+		};
+	};
+
+	o + line_break{};
+	return o;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <set>
 #include <cstring>
 #include "source_builder.hpp"
 #include "parsing.hpp"
@@ -26,13 +27,26 @@ basic_builder& make_other_object_constructor(basic_builder& o, relationship_obje
 basic_builder& make_pop_back(basic_builder& o, relationship_object_def const& obj);
 basic_builder& make_object_resize(basic_builder& o, relationship_object_def const& obj);
 basic_builder& make_compactable_delete(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_batch_delete(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_deferred_delete(basic_builder& o, relationship_object_def const& obj);
 basic_builder& make_non_erasable_create(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_concurrent_create(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_batch_create(basic_builder& o, relationship_object_def const& obj);
+void rebuild_live_set(basic_builder& o, relationship_object_def const& obj, std::string const& count);
 basic_builder& make_erasable_delete(basic_builder& o, relationship_object_def const& obj);
 basic_builder& make_clearing_delete(basic_builder& o, relationship_object_def const& cob);
 basic_builder& make_erasable_create(basic_builder& o, relationship_object_def const& obj);
 basic_builder& make_internal_move_relationship(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_internal_move_object(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_erasable_compact(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_object_reorder(basic_builder& o, relationship_object_def const& obj, file_def const& parsed_file);
 basic_builder& make_relation_try_create(basic_builder& o, relationship_object_def const& cob);
 basic_builder& make_relation_force_create(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_relation_bulk_create(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_relation_freeze(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_hierarchy_index(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_lazy_index(basic_builder& o, relationship_object_def const& cob);
+basic_builder& make_link_stats(basic_builder& o, relationship_object_def const& cob);
 basic_builder& make_serialize_plan_generator(basic_builder& o, file_def const& parsed_file, load_save_def const& rt);
 basic_builder& make_serialize_size(basic_builder& o, file_def const& parsed_file);
 void make_serialize_singe_object(basic_builder & o, const relationship_object_def & ob);
@@ -42,6 +56,35 @@ basic_builder& make_deserialize_helper(basic_builder& o, file_def const& parsed_
 basic_builder& make_deserialize(basic_builder& o, file_def const& parsed_file, bool with_mask);
 basic_builder& make_serialize_all_generator(basic_builder& o, file_def const& parsed_file);
 basic_builder& make_iterate_over_objects(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_consistent_reads(basic_builder& o, relationship_object_def const& obj);
+// the number of sequence counters kept for an object with consistent_reads; expandable objects share a fixed number of them
+inline size_t consistent_read_stripes(relationship_object_def const& obj) {
+	return obj.is_expandable ? size_t(1024) : std::max(size_t(1), (obj.size + 63) / 64);
+}
+basic_builder& make_versioned_columns(basic_builder& o, relationship_object_def const& obj);
+basic_builder& make_snapshot(basic_builder& o, file_def const& parsed_file);
+// properties of a versioned object whose values are copied for pinned snapshots before they are overwritten
+inline bool is_versioned_property(relationship_object_def const& obj, property_def const& prop) {
+	return obj.versioned && !prop.is_derived && !prop.hook_get && !prop.hook_set
+		&& (prop.type == property_type::vectorizable || prop.type == property_type::bitfield);
+}
+basic_builder& make_traversal(basic_builder& o, traversal_def const& tv);
+basic_builder& make_systems(basic_builder& o, file_def const& parsed_file);
+basic_builder& make_command_buffer(basic_builder& o, file_def const& parsed_file);
+// objects and relationships for which delete_..._batch is generated
+inline bool has_batch_delete(relationship_object_def const& cob) {
+	return !cob.primary_key.points_to
+		&& (cob.store_type == storage_type::erasable || cob.store_type == storage_type::compactable);
+}
+// relationships whose deletions and moves can be followed by a dcon::relocation_tracker, which command_buffer playback
+// uses to keep the handles it was given valid while links are changed
+inline bool tracks_relocations(relationship_object_def const& cob) {
+	return cob.is_relationship && has_batch_delete(cob);
+}
+// when both delete hooks are present, the per-instance hook is suppressed while a batch delete is running
+inline bool suppresses_delete_hook(relationship_object_def const& cob) {
+	return cob.hook_delete && cob.hook_delete_batch && has_batch_delete(cob);
+}
 
 basic_builder& make_const_fat_id(basic_builder& o, relationship_object_def const& obj, file_def const& parsed_file);
 basic_builder& make_fat_id(basic_builder& o, relationship_object_def const& obj, file_def const& parsed_file);
@@ -60,6 +103,7 @@ basic_builder& make_query_instance_types(basic_builder& o, prepared_query_defini
 basic_builder& make_query_instance_definitions(basic_builder& o, prepared_query_definition const& pdef);
 basic_builder& make_query_iterator_declarations(basic_builder& o, prepared_query_definition const& pdef);
 basic_builder& make_query_iterator_body(basic_builder& o, prepared_query_definition const& pdef, std::string const& ns, bool is_const);
+basic_builder& make_query_parallel_definitions(basic_builder& o, prepared_query_definition const& pdef);
 
 basic_builder& object_iterator_declaration(basic_builder& o, relationship_object_def const& obj);
 basic_builder& object_iterator_implementation(basic_builder& o, relationship_object_def const& obj);
@@ -1,5 +1,21 @@
 #include "code_fragments.hpp"
 
+// with consistent_reads, stores made through the setters are bracketed by the sequence counters of the instances they touch;
+// for versioned objects, the chunks they touch are first copied for any snapshots pinned since the last write to them
+void tracked_store(basic_builder& o, relationship_object_def const& obj, property_def const& prop, char const* store) {
+	if(obj.consistent_reads)
+		o + "@obj@_begin_write(id);";
+	if(is_versioned_property(obj, prop)) {
+		o + "auto const store_phase = snapshot_epochs.begin_store();";
+		o + "@obj@_save_versions(@obj@.m_@prop@_versions, @obj@.m_@prop@.vptr(), id);";
+	}
+	o + store;
+	if(is_versioned_property(obj, prop))
+		o + "snapshot_epochs.end_store(store_phase);";
+	if(obj.consistent_reads)
+		o + "@obj@_end_write(id);";
+}
+
 void make_property_member_declarations(basic_builder& o, file_def const& parsed_file, relationship_object_def const& obj,
 	property_def const& prop, bool add_prefix, std::string const& namesp, bool const_mode) {
 
@@ -719,7 +735,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "#ifdef DCON_TRAP_INVALID_STORE";
 							o + "assert(id.index() >= 0);";
 							o + "#endif";
-							o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), id.index(), value);";
+							tracked_store(o, obj, prop, "dcon::bit_vector_set(@obj@.m_@prop@.vptr(), id.index(), value);");
 						};
 
 						if(prop.protection == protection_type::read_only || prop.protection == protection_type::hidden) {
@@ -728,13 +744,13 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 
 						o + "#ifndef DCON_NO_VE";
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(@vector_position@<@obj@_id> id, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::partial_contiguous_tags<@obj@_id> id, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::tagged_vector<@obj@_id> id, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "#endif";
 					} else {
@@ -749,7 +765,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "#ifdef DCON_TRAP_INVALID_STORE";
 							o + "assert(id.index() >= 0);";
 							o + "#endif";
-							o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+							tracked_store(o, obj, prop, "@obj@.m_@prop@.vptr()[id.index()] = value;");
 						};
 
 						if(prop.protection == protection_type::read_only || prop.protection == protection_type::hidden) {
@@ -758,13 +774,13 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 
 						o + "#ifndef DCON_NO_VE";
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(@vector_position@<@obj@_id> id, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::partial_contiguous_tags<@obj@_id> id, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::tagged_vector<@obj@_id> id, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(), values);");
 						};
 						o + "#endif";
 					} else {
@@ -779,7 +795,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "#ifdef DCON_TRAP_INVALID_STORE";
 							o + "assert(id.index() >= 0);";
 							o + "#endif";
-							o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+							tracked_store(o, obj, prop, "@obj@.m_@prop@.vptr()[id.index()] = value;");
 						};
 
 						if(prop.protection == protection_type::read_only || prop.protection == protection_type::hidden) {
@@ -797,7 +813,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "#ifdef DCON_TRAP_INVALID_STORE";
 							o + "assert(id.index() >= 0);";
 							o + "#endif";
-							o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+							tracked_store(o, obj, prop, "@obj@.m_@prop@.vptr()[id.index()] = value;");
 						};
 
 						if(prop.protection == protection_type::read_only || prop.protection == protection_type::hidden) {
@@ -816,7 +832,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "assert(id.index() >= 0);";
 							o + "assert(dcon::get_index(n) >= 0);";
 							o + "#endif";
-							o + "dcon::bit_vector_set(@obj@.m_@prop@.vptr(dcon::get_index(n)), id.index(), value);";
+							tracked_store(o, obj, prop, "dcon::bit_vector_set(@obj@.m_@prop@.vptr(dcon::get_index(n)), id.index(), value);");
 						};
 						o + substitute{ "i_pk_obj", obj.primary_key.points_to ? obj.primary_key.points_to->name : obj.name };
 						o + "DCON_RELEASE_INLINE void @obj@_resize_@prop@(uint32_t size) noexcept" + block{
@@ -830,13 +846,13 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 
 						o + "#ifndef DCON_NO_VE";
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(@vector_position@<@obj@_id> id, @index_type@ n, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::partial_contiguous_tags<@obj@_id> id, @index_type@ n, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::tagged_vector<@obj@_id> id, @index_type@ n, ve::vbitfield_type values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "#endif";
 					} else {
@@ -855,7 +871,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "assert(id.index() >= 0);";
 							o + "assert(dcon::get_index(n) >= 0);";
 							o + "#endif";
-							o + "@obj@.m_@prop@.vptr(dcon::get_index(n))[id.index()] = value;";
+							tracked_store(o, obj, prop, "@obj@.m_@prop@.vptr(dcon::get_index(n))[id.index()] = value;");
 						};
 						o + substitute{ "i_pk_obj", obj.primary_key.points_to ? obj.primary_key.points_to->name : obj.name };
 						o + "DCON_RELEASE_INLINE void @obj@_resize_@prop@(uint32_t size) noexcept" + block{
@@ -882,7 +898,7 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 							o + "assert(id.index() >= 0);";
 							o + "assert(dcon::get_index(n) >= 0);";
 							o + "#endif";
-							o + "@obj@.m_@prop@.vptr(dcon::get_index(n))[id.index()] = value;";
+							tracked_store(o, obj, prop, "@obj@.m_@prop@.vptr(dcon::get_index(n))[id.index()] = value;");
 						};
 						o + substitute{ "i_pk_obj", obj.primary_key.points_to ? obj.primary_key.points_to->name : obj.name };
 						o + "DCON_RELEASE_INLINE void @obj@_resize_@prop@(uint32_t size) noexcept" + block{
@@ -896,13 +912,13 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 
 						o + "#ifndef DCON_NO_VE";
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(@vector_position@<@obj@_id> id, @index_type@ n, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::partial_contiguous_tags<@obj@_id> id, @index_type@ n, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "DCON_RELEASE_INLINE void @obj@_set_@prop@(ve::tagged_vector<@obj@_id> id, @index_type@ n, ve::value_to_vector_type<@base_type@> values) noexcept" + block{
-							o + "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);";
+							tracked_store(o, obj, prop, "ve::store(id, @obj@.m_@prop@.vptr(dcon::get_index(n)), values);");
 						};
 						o + "#endif";
 					} else {
@@ -922,6 +938,40 @@ void make_property_member_declarations(basic_builder& o, file_def const& parsed_
 					break;
 			}
 		}
+		if(prop.is_atomic && !prop.hook_set) { // ATOMIC UPDATES
+			if(add_prefix) {
+				// these go through tracked_store too, so that consistent readers never see them half done
+				o + "DCON_RELEASE_INLINE @base_type@ @obj@_fetch_add_@prop@(@obj@_id id, @base_type@ value, std::memory_order order = std::memory_order_relaxed) noexcept" + block{
+					tracked_store(o, obj, prop, "auto const result = dcon::atomic_fetch_add(@obj@.m_@prop@.vptr()[id.index()], value, order);");
+					o + "return result;";
+				};
+				o + "DCON_RELEASE_INLINE bool @obj@_compare_exchange_@prop@(@obj@_id id, @base_type@& expected, @base_type@ desired, std::memory_order order = std::memory_order_relaxed) noexcept" + block{
+					tracked_store(o, obj, prop, "auto const result = dcon::atomic_compare_exchange(@obj@.m_@prop@.vptr()[id.index()], expected, desired, order);");
+					o + "return result;";
+				};
+				o + "DCON_RELEASE_INLINE @base_type@ @obj@_atomic_max_@prop@(@obj@_id id, @base_type@ value, std::memory_order order = std::memory_order_relaxed) noexcept" + block{
+					tracked_store(o, obj, prop, "auto const result = dcon::atomic_max(@obj@.m_@prop@.vptr()[id.index()], value, order);");
+					o + "return result;";
+				};
+
+				if(prop.protection == protection_type::read_only || prop.protection == protection_type::hidden) {
+					o + "friend @base_type@ @obj@_fat_id::fetch_add_@prop@(@base_type@, std::memory_order) const noexcept;";
+					o + "friend bool @obj@_fat_id::compare_exchange_@prop@(@base_type@&, @base_type@, std::memory_order) const noexcept;";
+					o + "friend @base_type@ @obj@_fat_id::atomic_max_@prop@(@base_type@, std::memory_order) const noexcept;";
+				}
+			} else {
+				o + substitute{ "default_order", o.declaration_mode ? " = std::memory_order_relaxed" : "" };
+				o + "DCON_RELEASE_INLINE @base_type@ @namesp@fetch_add_@prop@(@base_type@ v, std::memory_order order@default_order@) const noexcept" + block{
+					o + "return container.@obj@_fetch_add_@prop@(id, v, order);";
+				};
+				o + "DCON_RELEASE_INLINE bool @namesp@compare_exchange_@prop@(@base_type@& expected, @base_type@ desired, std::memory_order order@default_order@) const noexcept" + block{
+					o + "return container.@obj@_compare_exchange_@prop@(id, expected, desired, order);";
+				};
+				o + "DCON_RELEASE_INLINE @base_type@ @namesp@atomic_max_@prop@(@base_type@ v, std::memory_order order@default_order@) const noexcept" + block{
+					o + "return container.@obj@_atomic_max_@prop@(id, v, order);";
+				};
+			}
+		}
 	}
 	if((add_prefix || o.declaration_mode) && (prop.protection == protection_type::read_only || prop.protection == protection_type::hidden)) {
 		o + "public:";
@@ -1505,6 +1555,9 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 
 			if(i.multiplicity == 1) {
 				o + "void internal_@obj@_set_@prop@(@obj@_id id, @type@ value) noexcept" + block{
+					if(obj.hierarchy_link == i.property_name) {
+						o + "@obj@.hierarchy_dirty.mark();";
+					}
 					if(i.ltype == list_type::list) {
 						o + "if(auto old_value = @obj@.m_@prop@.vptr()[id.index()]; bool(old_value))" + block{
 							o + "if(auto old_left = @obj@.m_link_@prop@.vptr()[id.index()].left; bool(old_left))" + block{
@@ -1537,13 +1590,16 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 							o + "@obj@.m_link_@prop@.vptr()[id.index()].left = @obj@_id();";
 						};
 						o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
-					} else if(i.ltype == list_type::array) {
+					} else if(i.ltype == list_type::array || i.ltype == list_type::sorted_array) {
+						o + substitute{ "pool_remove_unique", i.ltype == list_type::sorted_array ? "sorted_remove_unique_item" : "remove_unique_item" }
+							+substitute{ "pool_remove_all", i.ltype == list_type::sorted_array ? "sorted_remove_all_items" : "remove_all_items" }
+							+substitute{ "pool_insert", i.ltype == list_type::sorted_array ? "sorted_add_item" : "push_back" };
 						o + "if(auto old_value = @obj@.m_@prop@.vptr()[id.index()]; bool(old_value))" + block{
 							o + "auto& vref = @obj@.m_array_@prop@.vptr()[old_value.index()];";
-							o + "dcon::remove_unique_item(@obj@.@prop@_storage, vref, id);";
+							o + "dcon::@pool_remove_unique@(@obj@.@prop@_storage, vref, id);";
 						};
 						o + "if(bool(value))" + block{
-							o + "dcon::push_back(@obj@.@prop@_storage, @obj@.m_array_@prop@.vptr()[value.index()], id);";
+							o + "dcon::@pool_insert@(@obj@.@prop@_storage, @obj@.m_array_@prop@.vptr()[value.index()], id);";
 						};
 						o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
 					} else if(i.ltype == list_type::std_vector) {
@@ -1558,20 +1614,31 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 							o + "@obj@.m_array_@prop@.vptr()[value.index()].push_back(id);";
 						};
 						o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+					} else if(i.ltype == list_type::csr) {
+						o + "if(auto old_value = @obj@.m_@prop@.vptr()[id.index()]; bool(old_value))" + block{
+							o + "@obj@.@prop@_csr.remove_unique(old_value.index(), id);";
+						};
+						o + "if(bool(value))" + block{
+							o + "@obj@.@prop@_csr.push_back(value.index(), id);";
+						};
+						o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
 					}
 				};
 			} else {
 				o + "void internal_@obj@_set_@prop@(@obj@_id id, int32_t i, @type@ value) noexcept" + block{
-					if(i.ltype == list_type::array) {
+					if(i.ltype == list_type::array || i.ltype == list_type::sorted_array) {
+						o + substitute{ "pool_remove_unique", i.ltype == list_type::sorted_array ? "sorted_remove_unique_item" : "remove_unique_item" }
+							+substitute{ "pool_remove_all", i.ltype == list_type::sorted_array ? "sorted_remove_all_items" : "remove_all_items" }
+							+substitute{ "pool_insert", i.ltype == list_type::sorted_array ? "sorted_add_item" : "push_back" };
 						o + "if(auto old_value = @obj@.m_@prop@.vptr()[id.index()][i]; bool(old_value))" + block{
 							o + "auto& vref = @obj@.m_array_@prop@.vptr()[old_value.index()];";
 							if(i.is_distinct)
-								o + "dcon::remove_unique_item(@obj@.@prop@_storage, vref, id);";
+								o + "dcon::@pool_remove_unique@(@obj@.@prop@_storage, vref, id);";
 							else
-								o + "dcon::remove_all_items(@obj@.@prop@_storage, vref, id);";
+								o + "dcon::@pool_remove_all@(@obj@.@prop@_storage, vref, id);";
 						};
 						o + "if(bool(value))" + block{
-							o + "dcon::push_back(@obj@.@prop@_storage, @obj@.m_array_@prop@.vptr()[value.index()], id);";
+							o + "dcon::@pool_insert@(@obj@.@prop@_storage, @obj@.m_array_@prop@.vptr()[value.index()], id);";
 						};
 						o + "@obj@.m_@prop@.vptr()[id.index()][i] = value;";
 					} else if(i.ltype == list_type::std_vector) {
@@ -1598,6 +1665,17 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 							o + "@obj@.m_array_@prop@.vptr()[value.index()].push_back(id);";
 						};
 						o + "@obj@.m_@prop@.vptr()[id.index()][i] = value;";
+					} else if(i.ltype == list_type::csr) {
+						o + "if(auto old_value = @obj@.m_@prop@.vptr()[id.index()][i]; bool(old_value))" + block{
+							if(i.is_distinct)
+								o + "@obj@.@prop@_csr.remove_unique(old_value.index(), id);";
+							else
+								o + "@obj@.@prop@_csr.remove_all(old_value.index(), id);";
+						};
+						o + "if(bool(value))" + block{
+							o + "@obj@.@prop@_csr.push_back(value.index(), id);";
+						};
+						o + "@obj@.m_@prop@.vptr()[id.index()][i] = value;";
 					}
 				};
 			}
@@ -1756,10 +1834,14 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 			o + "private:";
 			if(i.multiplicity == 1) {
 				o + "DCON_RELEASE_INLINE void internal_@obj@_set_@prop@(@obj@_id id, @type@ value) noexcept" + block{
+					if(i.is_lazy_index)
+						o + "@obj@.@prop@_lazy_dirty.mark();";
 					o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
 				};
 			} else {
 				o + "DCON_RELEASE_INLINE void internal_@obj@_set_@prop@(@obj@_id id, int32_t i, @type@ value) noexcept" + block{
+					if(i.is_lazy_index)
+						o + "@obj@.@prop@_lazy_dirty.mark();";
 					o + "@obj@.m_@prop@.vptr()[id.index()][i] = value;";
 				};
 			}
@@ -1787,7 +1869,7 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 						};
 					}
 					make_delete_current_composite_keys_text(o, "id", obj, i);
-					o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+					o + "internal_@obj@_set_@prop@(id, value);";
 					make_remove_add_current_composite_keys_text(o, "id", obj, i);
 				};
 				o + "bool @obj@_try_set_@prop@(@obj@_id id, @type@ value) noexcept" + block{
@@ -1795,7 +1877,7 @@ void make_link_member_declarations(basic_builder& o, file_def const& parsed_file
 						o + "if(!bool(value)) return false;";
 					}
 					make_try_current_composite_keys_text(o, "id", obj, i);
-					o + "@obj@.m_@prop@.vptr()[id.index()] = value;";
+					o + "internal_@obj@_set_@prop@(id, value);";
 					make_force_add_current_composite_keys_text(o, "id", obj, i);
 					o + "return true;";
 				};
@@ -2303,17 +2385,20 @@ void many_getter_setter_text(basic_builder & o, list_type ltype, bool remove_all
 					"bool(list_pos); list_pos = @rel@.m_link_@rel_prop@.vptr()[list_pos.index()].right)" + block{
 					o + "func(list_pos);";
 				};
-			} else if(ltype == list_type::array) {
+			} else if(ltype == list_type::array || ltype == list_type::sorted_array) {
 				o + "auto vrange = dcon::get_range(@rel@.@rel_prop@_storage, @rel@.m_array_@rel_prop@.vptr()[id.index()]);";
 				o + "std::for_each(vrange.first, vrange.second, func);";
 			} else if(ltype == list_type::std_vector) {
 				o + "auto& vref = @rel@.m_array_@rel_prop@.vptr()[id.index()];";
 				o + "std::for_each(vref.begin(), vref.end(), func);";
+			} else if(ltype == list_type::csr) {
+				o + "auto vrange = @rel@.@rel_prop@_csr.range(id.index());";
+				o + "std::for_each(vrange.first, vrange.second, func);";
 			}
 		};
 	};
 
-	if(ltype == list_type::array) {
+	if(ltype == list_type::array || ltype == list_type::sorted_array) {
 		o + "DCON_RELEASE_INLINE std::pair<@rel@_id const*, @rel@_id const*> @obj@_range_of_@rel@@as_suffix@"
 			"(@obj@_id id) const" + block{
 			o + "if(bool(id))" + block{
@@ -2323,6 +2408,12 @@ void many_getter_setter_text(basic_builder & o, list_type ltype, bool remove_all
 				o + "return std::pair<@rel@_id const*, @rel@_id const*>(nullptr, nullptr);";
 			};
 		};
+		o + "DCON_RELEASE_INLINE bool @obj@_contains_@rel@@as_suffix@(@obj@_id id, @rel@_id r) const" + block{
+			if(ltype == list_type::sorted_array)
+				o + "return bool(id) && dcon::sorted_contains_item(@rel@.@rel_prop@_storage, @rel@.m_array_@rel_prop@.vptr()[id.index()], r);";
+			else
+				o + "return bool(id) && dcon::contains_item(@rel@.@rel_prop@_storage, @rel@.m_array_@rel_prop@.vptr()[id.index()], r);";
+		};
 	} else if(ltype == list_type::std_vector) {
 		o + "DCON_RELEASE_INLINE std::pair<@rel@_id const*, @rel@_id const*> @obj@_range_of_@rel@@as_suffix@"
 			"(@obj@_id id) const" + block{
@@ -2333,10 +2424,19 @@ void many_getter_setter_text(basic_builder & o, list_type ltype, bool remove_all
 				o + "return std::pair<@rel@_id const*, @rel@_id const*>(nullptr, nullptr);";
 			};
 		};
+	} else if(ltype == list_type::csr) {
+		o + "DCON_RELEASE_INLINE std::pair<@rel@_id const*, @rel@_id const*> @obj@_range_of_@rel@@as_suffix@"
+			"(@obj@_id id) const" + block{
+			o + "if(bool(id))" + block{
+				o + "return @rel@.@rel_prop@_csr.range(id.index());";
+			} +append{"else"} +block{
+				o + "return std::pair<@rel@_id const*, @rel@_id const*>(nullptr, nullptr);";
+			};
+		};
 	}
 
 	o + "void @obj@_remove_all_@rel@@as_suffix@(@obj@_id id) noexcept" + block{
-		if(ltype == list_type::array || ltype == list_type::std_vector) {
+		if(ltype != list_type::list) {
 			o + "auto rng = @obj@_range_of_@rel@_as_@rel_prop@(id);";
 			o + "dcon::local_vector<@rel@_id> temp(rng.first, rng.second);";
 		} else {
@@ -2345,6 +2445,8 @@ void many_getter_setter_text(basic_builder & o, list_type ltype, bool remove_all
 		}
 		if(remove_all_needs_sort)
 			o + "std::sort(temp.begin(), temp.end(), [](@rel@_id l, @rel@_id r){ return l.value > r.value; });";
+		else if(ltype == list_type::sorted_array)
+			o + "std::reverse(temp.begin(), temp.end());"; // unlink from the back of the sorted list, so that no elements need to be shifted
 		if(has_multiplicity)
 			o + "std::for_each(temp.begin(), temp.end(), [t = this, id](@rel@_id i) { t->@rel@_replace_@rel_prop@(i, @obj@_id(), id); });";
 		else
@@ -2352,6 +2454,112 @@ void many_getter_setter_text(basic_builder & o, list_type ltype, bool remove_all
 	};
 }
 
+void many_reduction_text(basic_builder& o, relationship_object_def const& rel, list_type ltype) {
+	struct reduction_kind {
+		char const* name;
+		bool property_def::* requested;
+		char const* initial_prefix;
+		char const* initial_suffix;
+		char const* scalar_step;
+		char const* float_step;
+		char const* int_step;
+	};
+	static reduction_kind const kinds[] = {
+		reduction_kind{ "sum", &property_def::reduce_sum, "", "(0)", "result = result + v;", "acc = acc + v;", "" },
+		reduction_kind{ "min", &property_def::reduce_min, "std::numeric_limits<", ">::max()", "result = std::min(result, v);", "acc = ve::min(acc, v);", "acc = ve::select(v < acc, v, acc);" },
+		reduction_kind{ "max", &property_def::reduce_max, "std::numeric_limits<", ">::lowest()", "result = std::max(result, v);", "acc = ve::max(acc, v);", "acc = ve::select(v > acc, v, acc);" }
+	};
+
+	for(auto& ip : rel.properties) {
+		if(!ip.reduce_sum && !ip.reduce_min && !ip.reduce_max)
+			continue;
+
+		auto const base_type = normalize_type(ip.data_type);
+		bool const is_float = base_type == "float" || base_type == "double";
+		bool const is_signed = base_type == "int8_t" || base_type == "int16_t" || base_type == "int32_t" || base_type == "int64_t";
+		// the values of these types can be gathered into a single ve vector
+		bool const gatherable = ltype != list_type::list && (ip.data_type == "float" || ip.data_type == "int32_t" || ip.data_type == "uint32_t"
+			|| ip.data_type == "int16_t" || ip.data_type == "uint16_t" || ip.data_type == "int8_t" || ip.data_type == "uint8_t");
+
+		o + substitute{ "prop", ip.name } +substitute{ "p_type", ip.data_type };
+
+		for(auto& k : kinds) {
+			if(!(ip.*k.requested))
+				continue;
+			bool const is_sum = std::string(k.name) == "sum";
+			// integer sums are accumulated in 64 bits, so that they do not overflow for long lists of small values
+			std::string const r_type = (!is_sum || is_float) ? ip.data_type : std::string(is_signed ? "int64_t" : "uint64_t");
+			o + substitute{ "r_type", r_type } + substitute{ "reduction", k.name } +substitute{ "initial", k.initial_prefix + r_type + k.initial_suffix };
+			// the int32_t lanes of an int_vector order uint32_t values incorrectly, so those are only summed in vectors
+			bool const gather_values = gatherable && (ip.data_type == "float" || is_sum || ip.data_type != "uint32_t");
+
+			o + "@r_type@ @obj@_@reduction@_@prop@_from_@rel@@as_suffix@(@obj@_id id) const noexcept" + block{
+				o + "@r_type@ result = @initial@;";
+				if(ltype == list_type::list) {
+					o + "@obj@_for_each_@rel@_as_@rel_prop@(id, [&](@rel@_id i)" + block{
+						o + "auto v = @r_type@(@rel@.m_@prop@.vptr()[i.index()]);";
+						o + k.scalar_step;
+					} +append{ ");" };
+				} else {
+					o + "auto rng = @obj@_range_of_@rel@_as_@rel_prop@(id);";
+					o + "int32_t const count = int32_t(rng.second - rng.first);";
+					o + "int32_t i = 0;";
+					if(gather_values) {
+						o + "#ifndef DCON_NO_VE";
+						o + "if(count >= ve::vector_size)" + block{
+							if(ip.data_type == "float") {
+								o + "ve::fp_vector acc(@initial@);";
+							} else if(!is_sum) {
+								o + "ve::int_vector acc(int32_t(@initial@));";
+							}
+							o + "for(; i + ve::vector_size <= count; i += ve::vector_size)" + block{
+								o + "auto v = ve::load(ve::load(ve::unaligned_contiguous_tags<@rel@_id>(uint32_t(i)), rng.first), @rel@.m_@prop@.vptr());";
+								if(ip.data_type == "float") {
+									o + k.float_step;
+								} else if(!is_sum) {
+									o + k.int_step;
+								} else {
+									o + "for(int32_t j = 0; j < ve::vector_size; ++j)";
+									o + "\tresult = result + @r_type@(@p_type@(v[j]));";
+								}
+							};
+							if(ip.data_type == "float" && is_sum) {
+								o + "result = acc.reduce();";
+							} else if(!is_sum) {
+								o + "for(int32_t j = 0; j < ve::vector_size; ++j)" + block{
+									o + "auto v = @p_type@(acc[j]);";
+									o + k.scalar_step;
+								};
+							}
+						};
+						o + "#endif";
+					}
+					o + "for(; i < count; ++i)" + block{
+						o + "auto v = @r_type@(@rel@.m_@prop@.vptr()[rng.first[i].index()]);";
+						o + k.scalar_step;
+					};
+				}
+				o + "return result;";
+			};
+
+			o + "#ifndef DCON_NO_VE";
+			o + "void @obj@_@reduction@_@prop@_from_@rel@@as_suffix@(ve::vectorizable_buffer<@r_type@, @obj@_id>& out) const noexcept" + block{
+				// one streaming pass over the relationship, instead of one gather per object
+				o + "std::fill_n(out.vptr(), @obj@_size(), @initial@);";
+				o + "auto const rel_count = @rel@_size();";
+				o + "for(uint32_t j = 0; j < rel_count; ++j)" + block{
+					o + "auto target = @rel@.m_@rel_prop@.vptr()[j];";
+					o + "if(!bool(target)) continue;";
+					o + "auto& result = out.vptr()[target.index()];";
+					o + "auto v = @r_type@(@rel@.m_@prop@.vptr()[j]);";
+					o + k.scalar_step;
+				};
+			};
+			o + "#endif";
+		}
+	}
+}
+
 void relation_many_join_getters_setters_text(basic_builder& o, list_type indexed_as, bool property_is_pk) {
 
 	o + "template<typename T>";
@@ -2374,7 +2582,7 @@ void relation_many_join_getters_setters_text(basic_builder& o, list_type indexed
 				}
 			};
 			o + "return false;";
-		} else if(indexed_as == list_type::array) {
+		} else if(indexed_as == list_type::array || indexed_as == list_type::sorted_array) {
 			o + "auto vrange = dcon::get_range(@rel@.@as_name@_storage, @rel@.m_array_@as_name@.vptr()[id.index()]);";
 			o + "for(auto pos = vrange.first; pos != vrange.second; ++pos)" + block{
 				if(!property_is_pk) {
@@ -2394,6 +2602,16 @@ void relation_many_join_getters_setters_text(basic_builder& o, list_type indexed
 				}
 			};
 			o + "return false;";
+		} else if(indexed_as == list_type::csr) {
+			o + "auto vrange = @rel@.@as_name@_csr.range(id.index());";
+			o + "for(auto pos = vrange.first; pos != vrange.second; ++pos)" + block{
+				if(!property_is_pk) {
+					o + "if(@rel@.m_@prop@.vptr()[pos->index()] == target) return true;";
+				} else {
+					o + "if(pos->index() == target.index()) return true;";
+				}
+			};
+			o + "return false;";
 		}
 	};
 	
@@ -2558,16 +2776,23 @@ void make_related_member_declarations(basic_builder& o, file_def const& parsed_f
 		if(add_prefix) {
 			o + substitute{ "as_suffix", std::string("_as_") + in_rel.linked_as->property_name };
 			many_getter_setter_text(o, in_rel.linked_as->ltype, !in_rel.linked_as->is_optional && in_rel.rel_ptr->store_type == storage_type::compactable, in_rel.linked_as->multiplicity > 1);
+			if(in_rel.linked_as->multiplicity == 1)
+				many_reduction_text(o, *in_rel.rel_ptr, in_rel.linked_as->ltype);
 		} else {
 			o + "template<typename T>";
 			o + "DCON_RELEASE_INLINE void @namesp@for_each_@rel@_as_@rel_prop@(T&& func) const" + block{
 				o + "container.@obj@_for_each_@rel@_as_@rel_prop@(id, [&, t = this](@rel@_id i){func(fatten(t->container, i));});";
 			};
-			if(in_rel.linked_as->ltype == list_type::array || in_rel.linked_as->ltype == list_type::std_vector) {
+			if(in_rel.linked_as->ltype != list_type::list) {
 				o + "DCON_RELEASE_INLINE std::pair<@rel@_id const*, @rel@_id const*> @namesp@range_of_@rel@_as_@rel_prop@() const" + block{
 					o + "return container.@obj@_range_of_@rel@_as_@rel_prop@(id);";
 				};
 			}
+			if(in_rel.linked_as->ltype == list_type::array || in_rel.linked_as->ltype == list_type::sorted_array) {
+				o + "DCON_RELEASE_INLINE bool @namesp@contains_@rel@_as_@rel_prop@(@rel@_id r) const" + block{
+					o + "return container.@obj@_contains_@rel@_as_@rel_prop@(id, r);";
+				};
+			}
 			if(!const_mode) {
 				o + "DCON_RELEASE_INLINE void @namesp@remove_all_@rel@_as_@rel_prop@() const noexcept" + block{
 					o + "container.@obj@_remove_all_@rel@_as_@rel_prop@(id);";
@@ -2590,16 +2815,23 @@ void make_related_member_declarations(basic_builder& o, file_def const& parsed_f
 			if(add_prefix) {
 				o + substitute{ "as_suffix", "" };
 				many_getter_setter_text(o, in_rel.linked_as->ltype, !in_rel.linked_as->is_optional && in_rel.rel_ptr->store_type == storage_type::compactable, in_rel.linked_as->multiplicity > 1);
+				if(in_rel.linked_as->multiplicity == 1)
+					many_reduction_text(o, *in_rel.rel_ptr, in_rel.linked_as->ltype);
 			} else {
 				o + "template<typename T>";
 				o + "DCON_RELEASE_INLINE void @namesp@for_each_@rel@(T&& func) const" + block{
 					o + "container.@obj@_for_each_@rel@(id, [&, t = this](@rel@_id i){func(fatten(t->container, i));});";
 				};
-				if(in_rel.linked_as->ltype == list_type::array || in_rel.linked_as->ltype == list_type::std_vector) {
+				if(in_rel.linked_as->ltype != list_type::list) {
 					o + "DCON_RELEASE_INLINE std::pair<@rel@_id const*, @rel@_id const*> @namesp@range_of_@rel@() const" + block{
 						o + "return container.@obj@_range_of_@rel@(id);";
 					};
 				}
+				if(in_rel.linked_as->ltype == list_type::array || in_rel.linked_as->ltype == list_type::sorted_array) {
+					o + "DCON_RELEASE_INLINE bool @namesp@contains_@rel@(@rel@_id r) const" + block{
+						o + "return container.@obj@_contains_@rel@(id, r);";
+					};
+				}
 				if(!const_mode) {
 					o + "DCON_RELEASE_INLINE void @namesp@remove_all_@rel@() const noexcept" + block{
 						o + "container.@obj@_remove_all_@rel@(id);";
@@ -2680,6 +2912,24 @@ void make_related_member_declarations(basic_builder& o, file_def const& parsed_f
 
 }
 
+void make_live_set_accessors(basic_builder& o, relationship_object_def const& obj) {
+	o + substitute{ "live_position", obj.is_expandable ? "ve::unaligned_contiguous_tags" : "ve::contiguous_tags" };
+	o + "DCON_RELEASE_INLINE uint32_t @obj@_live_count() const noexcept" + block{
+		o + "return @obj@.live_count;";
+	};
+	o + "#ifndef DCON_NO_VE";
+	o + "DCON_RELEASE_INLINE ve::vbitfield_type @obj@_is_live(@live_position@<@obj@_id> id) const noexcept" + block{
+		o + "return ve::load(id, @obj@.m__live.vptr());";
+	};
+	o + "DCON_RELEASE_INLINE ve::vbitfield_type @obj@_is_live(ve::partial_contiguous_tags<@obj@_id> id) const noexcept" + block{
+		o + "return ve::load(id, @obj@.m__live.vptr());";
+	};
+	o + "DCON_RELEASE_INLINE ve::mask_vector @obj@_is_live(ve::tagged_vector<@obj@_id> id) const noexcept" + block{
+		o + "return ve::load(id, @obj@.m__live.vptr());";
+	};
+	o + "#endif";
+}
+
 basic_builder& make_object_member_declarations(basic_builder& o, file_def const& parsed_file, relationship_object_def const& obj, bool add_prefix, bool declaration_mode, std::string const& namesp, bool const_mode) {
 
 	o + substitute("obj", obj.name);
@@ -2714,6 +2964,7 @@ basic_builder& make_object_member_declarations(basic_builder& o, file_def const&
 				o + "DCON_RELEASE_INLINE bool @obj@_is_valid(@obj@_id id) const noexcept" + block{
 					o + "return bool(id) && uint32_t(id.index()) < @obj@.size_used && @obj@.m__index.vptr()[id.index()] == id;";
 				};
+				make_live_set_accessors(o, obj);
 			}
 		} else if(obj.primary_key.points_to) { // primary key relationship
 			o + substitute{ "k_pk_obj", obj.primary_key.points_to->name };
@@ -2746,6 +2997,7 @@ basic_builder& make_object_member_declarations(basic_builder& o, file_def const&
 				o + "DCON_RELEASE_INLINE bool @obj@_is_valid(@obj@_id id) const noexcept" + block{
 					o + "return bool(id) && uint32_t(id.index()) < @obj@.size_used && @obj@.m__index.vptr()[id.index()] == id;";
 				};
+				make_live_set_accessors(o, obj);
 			}
 		}
 	} else {
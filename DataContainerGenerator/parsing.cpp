@@ -556,10 +556,24 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 					result.ltype = list_type::list;
 				} else if(extracted.values[0].to_string() == "array") {
 					result.ltype = list_type::array;
+				} else if(extracted.values[0].to_string() == "csr") {
+					result.ltype = list_type::csr;
+				} else if(extracted.values[0].to_string() == "sorted_array") {
+					result.ltype = list_type::sorted_array;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 17,
 						std::string("unknown parameter \"") + extracted.values[0].to_string() + "\" passed to index_storage");
 				}
+			} else if(kstr == "index") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 111,
+						std::string("wrong number of parameters for \"index\""));
+				} else if(extracted.values[0].to_string() == "lazy") {
+					result.is_lazy_index = true;
+				} else {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 111,
+						std::string("unknown parameter \"") + extracted.values[0].to_string() + "\" passed to index");
+				}
 			} else if(kstr == "multiple") {
 				if(extracted.values.size() != 1 && extracted.values.size() != 2) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 18,
@@ -684,6 +698,19 @@ property_def parse_property_def(char const* start, char const* end, char const*
 								result.type = property_type::other;
 							result.data_type = inner_extracted.values[0].to_string();
 						}
+					} else if(ikstr == "atomic") {
+						if(inner_extracted.values.size() != 1) {
+							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 117,
+								std::string("wrong number of parameters for \"atomic\""));
+						} else if(auto t = normalize_type(inner_extracted.values[0].to_string());
+							t != "int32_t" && t != "uint32_t" && t != "float" && t != "int64_t") {
+							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 118,
+								std::string("\"atomic\" properties must be of type int32_t, uint32_t, float, or int64_t"));
+						} else {
+							result.is_atomic = true;
+							result.type = property_type::other;
+							result.data_type = t;
+						}
 					} else if(ikstr == "vector_pool") {
 						if(inner_extracted.values.size() != 2) {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 30,
@@ -736,6 +763,24 @@ property_def parse_property_def(char const* start, char const* end, char const*
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 34,
 						std::string("unknown parameter \"") + extracted.values[0].to_string() + "\" passed to hook");
 				}
+			} else if(kstr == "reduce") {
+				if(extracted.values.size() == 0) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 122,
+						std::string("wrong number of parameters for \"reduce\""));
+				}
+				for(auto& v : extracted.values) {
+					auto const r = v.to_string();
+					if(r == "sum") {
+						result.reduce_sum = true;
+					} else if(r == "min") {
+						result.reduce_min = true;
+					} else if(r == "max") {
+						result.reduce_max = true;
+					} else {
+						err_out.add(calculate_line_from_position(global_start, extracted.key.start), 123,
+							std::string("unknown parameter \"") + r + "\" passed to reduce");
+					}
+				}
 			} else if(kstr == "tag") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 35,
@@ -917,10 +962,21 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 					result.hook_delete = true;
 				} else if(extracted.values[0].to_string() == "move") {
 					result.hook_move = true;
+				} else if(extracted.values[0].to_string() == "create_batch") {
+					result.hook_create_batch = true;
+				} else if(extracted.values[0].to_string() == "delete_batch") {
+					result.hook_delete_batch = true;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 53,
 						std::string("unknown parameter \"") + extracted.values[0].to_string() + "\" passed to hook");
 				}
+			} else if(kstr == "hierarchy") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 110,
+						std::string("wrong number of parameters for \"hierarchy\""));
+				} else {
+					result.hierarchy_link = extracted.values[0].to_string();
+				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 54,
 					std::string("unexpected token \"") + kstr + "\" while parsing relationship defintion");
@@ -995,10 +1051,35 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 					result.hook_delete = true;
 				} else if(extracted.values[0].to_string() == "move") {
 					result.hook_move = true;
+				} else if(extracted.values[0].to_string() == "create_batch") {
+					result.hook_create_batch = true;
+				} else if(extracted.values[0].to_string() == "delete_batch") {
+					result.hook_delete_batch = true;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 61,
 						std::string("unknown parameter \"") + extracted.values[0].to_string() + "\" passed to hook");
 				}
+			} else if(kstr == "consistent_reads") {
+				if(extracted.values.size() != 0) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 119,
+						std::string("wrong number of parameters for \"consistent_reads\""));
+				} else {
+					result.consistent_reads = true;
+				}
+			} else if(kstr == "versioned") {
+				if(extracted.values.size() != 0) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 120,
+						std::string("wrong number of parameters for \"versioned\""));
+				} else {
+					result.versioned = true;
+				}
+			} else if(kstr == "concurrent_create") {
+				if(extracted.values.size() != 0) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 121,
+						std::string("wrong number of parameters for \"concurrent_create\""));
+				} else {
+					result.concurrent_create = true;
+				}
 			} else if(kstr == "property") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 62,
@@ -1129,6 +1210,93 @@ conversion_def parse_conversion_def(char const* start, char const* end, char con
 	return result;
 }
 
+traversal_def parse_traversal_def(char const* start, char const* end, char const* global_start, error_record& err_out) {
+	traversal_def result;
+	char const* pos = start;
+	while(pos < end) {
+		auto extracted = extract_item(pos, end, global_start, err_out);
+		pos = extracted.terminal;
+
+		if(extracted.key.start != extracted.key.end) {
+			std::string kstr = extracted.key.to_string();
+			if(kstr == "name") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 105,
+						std::string("wrong number of parameters for \"name\""));
+				} else if(result.name.length() == 0) {
+					result.name = extracted.values[0].to_string();
+				} else {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 106,
+						std::string("multiple defintion of \"name\" while parsing traversal defintion"));
+				}
+			} else if(kstr == "step") {
+				if(extracted.values.size() != 3) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 107,
+						std::string("wrong number of parameters for \"step\""));
+				} else {
+					traversal_step s;
+					s.relation_name = extracted.values[0].to_string();
+					s.from_link = extracted.values[1].to_string();
+					s.to_link = extracted.values[2].to_string();
+					result.steps.push_back(s);
+				}
+			} else {
+				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 108,
+					std::string("unexpected token \"") + kstr + "\" while parsing traversal defintion");
+			}
+		}
+	}
+	return result;
+}
+
+system_access parse_system_access(std::string const& item) {
+	system_access result;
+	if(auto dot = item.find('.'); dot != std::string::npos) {
+		result.object_name = item.substr(0, dot);
+		result.property_name = item.substr(dot + 1);
+	} else {
+		result.object_name = item;
+	}
+	return result;
+}
+
+system_def parse_system_def(char const* start, char const* end, char const* global_start, error_record& err_out) {
+	system_def result;
+	char const* pos = start;
+	while(pos < end) {
+		auto extracted = extract_item(pos, end, global_start, err_out);
+		pos = extracted.terminal;
+
+		if(extracted.key.start != extracted.key.end) {
+			std::string kstr = extracted.key.to_string();
+			if(kstr == "name") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 112,
+						std::string("wrong number of parameters for \"name\""));
+				} else if(result.name.length() == 0) {
+					result.name = extracted.values[0].to_string();
+				} else {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 113,
+						std::string("multiple defintion of \"name\" while parsing system defintion"));
+				}
+			} else if(kstr == "reads" || kstr == "writes") {
+				if(extracted.values.size() == 0) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 114,
+						std::string("wrong number of parameters for \"") + kstr + "\"");
+				} else {
+					auto& target = kstr == "reads" ? result.reads : result.writes;
+					for(auto& v : extracted.values)
+						target.push_back(parse_system_access(v.to_string()));
+				}
+			} else {
+				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 115,
+					std::string("unexpected token \"") + kstr + "\" while parsing system defintion");
+			}
+		}
+	}
+	return result;
+}
+
 std::vector<type_name_pair> parse_query_parameters_list(char const*& start, char const* end, char const* global_start, error_record& err) {
 	std::vector<type_name_pair> result;
 
@@ -1290,6 +1458,22 @@ file_def parse_file(char const* start, char const* end, error_record& err_out) {
 					parsed_file.unprepared_queries.push_back(
 						parse_query_definition(extracted.values[0].start, extracted.values[0].end, start, err_out));
 				}
+			} else if(kstr == "traversal") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(start, extracted.key.start), 109,
+						std::string("wrong number of parameters for \"traversal\""));
+				} else {
+					parsed_file.traversals.push_back(
+						parse_traversal_def(extracted.values[0].start, extracted.values[0].end, start, err_out));
+				}
+			} else if(kstr == "system") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(start, extracted.key.start), 116,
+						std::string("wrong number of parameters for \"system\""));
+				} else {
+					parsed_file.systems.push_back(
+						parse_system_def(extracted.values[0].start, extracted.values[0].end, start, err_out));
+				}
 			} else {
 				err_out.add(calculate_line_from_position(start, extracted.key.start), 90,
 					std::string("unexpetected top level key: ") + kstr);
@@ -83,6 +83,7 @@ struct property_def {
 	property_type type = property_type::other;
 	protection_type protection = protection_type::none;
 	bool is_derived = false;
+	bool is_atomic = false;
 
 	int special_pool_size = 1000;
 	std::string data_type;
@@ -92,11 +93,16 @@ struct property_def {
 	bool hook_get = false;
 	bool hook_set = false;
 
+	// reductions over the many links of a relationship, requested with reduce{...}
+	bool reduce_sum = false;
+	bool reduce_min = false;
+	bool reduce_max = false;
+
 	std::vector<std::string> property_tags;
 };
 
 enum class index_type { many, at_most_one, none };
-enum class list_type { list, array, std_vector };
+enum class list_type { list, array, std_vector, csr, sorted_array };
 
 struct relationship_object_def;
 
@@ -110,6 +116,7 @@ struct related_object {
 	bool is_distinct = false;
 	bool is_covered_by_composite_key = false;
 	bool is_primary_key = false;
+	bool is_lazy_index = false;
 	protection_type protection = protection_type::none;
 	relationship_object_def* related_to = nullptr;
 };
@@ -160,10 +167,16 @@ struct relationship_object_def {
 	size_t size = 1000;
 	bool is_expandable = false;
 	storage_type store_type = storage_type::contiguous;
+	std::string hierarchy_link;
 
 	bool hook_create = false;
 	bool hook_delete = false;
 	bool hook_move = false;
+	bool hook_create_batch = false;
+	bool hook_delete_batch = false;
+	bool consistent_reads = false;
+	bool versioned = false;
+	bool concurrent_create = false;
 
 	std::vector<related_object> indexed_objects;
 	std::vector<property_def> properties;
@@ -198,6 +211,38 @@ struct made_id {
 	std::string base_type;
 };
 
+struct traversal_step {
+	std::string relation_name;
+	std::string from_link;
+	std::string to_link;
+
+	relationship_object_def const* rel_ptr = nullptr;
+	related_object const* from = nullptr;
+	related_object const* to = nullptr;
+};
+
+struct traversal_def {
+	std::string name;
+	std::vector<traversal_step> steps;
+	relationship_object_def const* start_object = nullptr;
+};
+
+struct system_access {
+	std::string object_name;
+	std::string property_name; // empty when the whole object or relationship is accessed
+
+	relationship_object_def const* object = nullptr;
+};
+
+struct system_def {
+	std::string name;
+	std::vector<system_access> reads;
+	std::vector<system_access> writes;
+
+	std::vector<uint32_t> after; // earlier systems that this one conflicts with
+	uint32_t level = 0;
+};
+
 
 related_object parse_link_def(char const* start, char const* end, char const* global_start, error_record& err_out);
 property_def parse_property_def(char const* start, char const* end, char const* global_start, error_record& err_out);
@@ -205,6 +250,8 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 relationship_object_def parse_object(char const* start, char const* end, char const* global_start, error_record& err_out);
 std::vector<std::string> parse_legacy_types(char const* start, char const* end, char const* global_start, error_record& err_out);
 conversion_def parse_conversion_def(char const* start, char const* end, char const* global_start, error_record& err_out);
+traversal_def parse_traversal_def(char const* start, char const* end, char const* global_start, error_record& err_out);
+system_def parse_system_def(char const* start, char const* end, char const* global_start, error_record& err_out);
 load_save_def parse_load_save_def(char const* start, char const* end, char const* global_start, error_record& err_out);
 
 
@@ -359,6 +406,8 @@ struct file_def {
 	std::vector<relationship_object_def> relationship_objects;
 	std::vector<load_save_def> load_save_routines;
 	std::vector<conversion_def> conversion_list;
+	std::vector<traversal_def> traversals;
+	std::vector<system_def> systems;
 
 	std::vector<std::string> object_types;
 
@@ -123,8 +123,25 @@ basic_builder& make_query_iterator_declarations(basic_builder& o, prepared_query
 			}
 		}
 
+		if(!pdef.table_slots[0].is_parameter_type)
+			o + "uint32_t m_end = uint32_t(-1);";
+
 		o + "public:";
 
+		if(!pdef.table_slots[0].is_parameter_type) {
+			// iterates over only the results that start from [first, last) in the first slot, for dividing a query between threads
+			o + substitute{ "obj", pdef.table_slots[0].actual_table->name };
+			o + "query_@name@_iterator(data_container& c, query_@name@_instance& p, uint32_t first, uint32_t last) : m_container(c), m_parameters(p), m_end(last)" + block{
+				if(pdef.table_slots[0].actual_table->store_type == storage_type::erasable) {
+					o + "while(first < last && first < m_container.@obj@_size() && !m_container.@obj@_is_valid(@obj@_id(@obj@_id::value_base_t(first))))" + block{
+						o + "++first;";
+					};
+				}
+				o + "if(first < last && first < m_container.@obj@_size())" + block{
+					o + "internal_init(@obj@_id(@obj@_id::value_base_t(first)));";
+				};
+			};
+		}
 		o + "query_@name@_iterator(data_container& c, query_@name@_instance& p) : m_container(c), m_parameters(p)" + block{
 			o + substitute{ "fname", pdef.table_slots[0].internally_named_as };
 			o + substitute{ "obj", pdef.table_slots[0].actual_table->name };
@@ -180,8 +197,25 @@ basic_builder& make_query_iterator_declarations(basic_builder& o, prepared_query
 			}
 		}
 
+		if(!pdef.table_slots[0].is_parameter_type)
+			o + "uint32_t m_end = uint32_t(-1);";
+
 		o + "public:";
 
+		if(!pdef.table_slots[0].is_parameter_type) {
+			// iterates over only the results that start from [first, last) in the first slot, for dividing a query between threads
+			o + substitute{ "obj", pdef.table_slots[0].actual_table->name };
+			o + "query_@name@_const_iterator(data_container const& c, query_@name@_const_instance& p, uint32_t first, uint32_t last) : m_container(c), m_parameters(p), m_end(last)" + block{
+				if(pdef.table_slots[0].actual_table->store_type == storage_type::erasable) {
+					o + "while(first < last && first < m_container.@obj@_size() && !m_container.@obj@_is_valid(@obj@_id(@obj@_id::value_base_t(first))))" + block{
+						o + "++first;";
+					};
+				}
+				o + "if(first < last && first < m_container.@obj@_size())" + block{
+					o + "internal_init(@obj@_id(@obj@_id::value_base_t(first)));";
+				};
+			};
+		}
 		o + "query_@name@_const_iterator(data_container const& c, query_@name@_const_instance& p) : m_container(c), m_parameters(p)" + block{
 			o + substitute{ "fname", pdef.table_slots[0].internally_named_as };
 			o + substitute{ "obj", pdef.table_slots[0].actual_table->name };
@@ -560,7 +594,7 @@ basic_builder& make_query_iterator_body(basic_builder& o, prepared_query_definit
 					o + "return false;";
 				} else {
 					if(table.actual_table->store_type == storage_type::erasable) {
-						o + "for(uint32_t i = uint32_t(@fname@.index() + 1); i < m_container.@obj@_size(); ++i)" + block{
+						o + "for(uint32_t i = uint32_t(@fname@.index() + 1); i < m_container.@obj@_size() && i < m_end; ++i)" + block{
 							o + "if(m_container.@obj@_is_valid( @obj@_id(@obj@_id::value_base_t(i)) ))" + block{
 								o + "if(internal_set_v0( @obj@_id(@obj@_id::value_base_t(i)) )) return true;";
 							};
@@ -568,7 +602,7 @@ basic_builder& make_query_iterator_body(basic_builder& o, prepared_query_definit
 						o + "@fname@ = @obj@_id( );";
 						o + "return false;";
 					} else {
-						o + "for(uint32_t i = uint32_t(@fname@.index() + 1); i < m_container.@obj@_size(); ++i)" + block{
+						o + "for(uint32_t i = uint32_t(@fname@.index() + 1); i < m_container.@obj@_size() && i < m_end; ++i)" + block{
 							o + "if(internal_set_v0( @obj@_id(@obj@_id::value_base_t(i)) )) return true;";
 						};
 						o + "@fname@ = @obj@_id( );";
@@ -920,3 +954,42 @@ basic_builder& make_query_iterator_body(basic_builder& o, prepared_query_definit
 	o + line_break{};
 	return o;
 }
+
+basic_builder& make_query_parallel_definitions(basic_builder& o, prepared_query_definition const& pdef) {
+	if(pdef.table_slots[0].is_parameter_type)
+		return o;
+
+	std::string param_list;
+	std::string arg_list;
+	for(auto& param : pdef.parameters) {
+		param_list += param.type + " " + param.name + ", ";
+		arg_list += ", " + param.name;
+	}
+	o + substitute{ "name", pdef.name } + substitute{ "obj", pdef.table_slots[0].actual_table->name }
+		+ substitute{ "param_list", param_list } + substitute{ "arg_list", arg_list };
+
+	// each chunk of the first slot runs its own iterator; a group never extends past a change in the first slot,
+	// so every group is aggregated entirely within one chunk
+	o + "#ifndef DCON_NO_VE";
+	o + "#ifndef VE_NO_TBB";
+	for(auto is_const : { false, true }) {
+		o + substitute{ "const", is_const ? " const" : "" } + substitute{ "cpre", is_const ? "const_" : "" };
+		o + "template<typename F>";
+		o + "void data_container::query_@name@_parallel(@param_list@F&& func, uint32_t grain)@const@" + block{
+			o + "internal::query_@name@_@cpre@instance parameters(*this@arg_list@);";
+			o + "ve::execute_parallel_chunks(@obj@_size(), grain, ve::partitioning::dynamic, [&](uint32_t first, uint32_t last)" + block{
+				o + "[[maybe_unused]] int32_t const thread = ve::thread_index();";
+				o + "for(internal::query_@name@_@cpre@iterator it(*this, parameters, first, last); it != dcon::invalid_iterator_type{}; ++it)" + block{
+					o + "if constexpr(std::is_invocable_v<F&, internal::query_@name@_@cpre@iterator const&, int32_t>)";
+					o + "\tfunc(*it, thread);";
+					o + "else";
+					o + "\tfunc(*it);";
+				};
+			} + append{ ");" };
+		};
+	}
+	o + "#endif";
+	o + "#endif";
+	o + line_break{};
+	return o;
+}
@@ -491,6 +491,7 @@ void deserialize_erasable_index_fragment(basic_builder& o, relationship_object_d
 					// o + "@pk_obj@.size_used = std::max(@pk_obj@.size_used, uint32_t(j + 1));";
 				};
 			};
+			rebuild_live_set(o, ob, ob.name + ".size_used");
 		};
 		o + "return;";
 	};